@@ -37,6 +37,7 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 // Written by: Stevan Gavrilovic, Frank McKenna
 
 #include "CSVReaderWriter.h"
+#include "CSVRowReader.h"
 #include "GMPEWidget.h"
 #include "GMWidget.h"
 #include "GmAppConfig.h"
@@ -862,10 +863,11 @@ int GMWidget::processDownloadedRecords(QString& errorMessage)
 
     QString fileName = inputFile.fileName();
 
-    CSVReaderWriter csvTool;
+    // Stream the event grid a row at a time rather than loading the whole file
+    CSVRowReader reader;
 
     QString err;
-    QVector<QStringList> data = csvTool.parseCSVFile(pathToOutputDirectory,err);
+    reader.open(pathToOutputDirectory,err);
 
     if(!err.isEmpty())
     {
@@ -873,9 +875,6 @@ int GMWidget::processDownloadedRecords(QString& errorMessage)
         return -1;
     }
 
-    if(data.empty())
-        return -1;
-
 
     QApplication::processEvents();
 
@@ -912,11 +911,10 @@ int GMWidget::processDownloadedRecords(QString& errorMessage)
     // Set the scale at which the layer will become visible - if scale is too high, then the entire view will be filled with symbols
     // gridLayer->setMinScale(80000);
 
-    auto headers = data.front();
-
-    auto indexFile = headers.indexOf("GP_file");
-    auto indexLon = headers.indexOf("Longitude");
-    auto indexLat = headers.indexOf("Latitude");
+    // Resolve the column indexes once from the header
+    auto indexFile = reader.indexOfColumn("GP_file");
+    auto indexLon = reader.indexOfColumn("Longitude");
+    auto indexLat = reader.indexOfColumn("Latitude");
 
     if(indexLon == -1 || indexLat == -1 || indexFile == -1)
     {
@@ -924,42 +922,35 @@ int GMWidget::processDownloadedRecords(QString& errorMessage)
         return -1;
     }
 
-    // Pop off the row that contains the header information
-    data.pop_front();
-
-    auto numRows = data.size();
-
     // Get the data
-    for(int i = 0; i<numRows; ++i)
+    while(reader.readRow(err))
     {
-        this->getProgressDialog()->setProgressBarValue(i+1);
-
-        auto vecValues = data.at(i);
+        this->getProgressDialog()->setProgressBarValue(reader.getRowNumber());
 
-        if(vecValues.size() < 3)
+        if(reader.columnCount() < 3)
         {
             errorMessage = "Error in importing ground motions";
             return -1;
         }
 
         bool ok;
-        auto lon = vecValues[indexLon].toDouble(&ok);
+        auto lon = reader.at(indexLon).toDouble(&ok);
 
         if(!ok)
         {
-            errorMessage = "Error converting longitude object " + vecValues[1] + " to a double";
+            errorMessage = "Error converting longitude object " + reader.at(indexLon).toString() + " to a double";
             return -1;
         }
 
-        auto lat = vecValues[indexLat].toDouble(&ok);
+        auto lat = reader.at(indexLat).toDouble(&ok);
 
         if(!ok)
         {
-            errorMessage = "Error converting latitude object " + vecValues[2] + " to a double";
+            errorMessage = "Error converting latitude object " + reader.at(indexLat).toString() + " to a double";
             return -1;
         }
 
-        auto stationName = vecValues[indexFile];
+        auto stationName = reader.at(indexFile).toString();
 
         auto stationPath = inputFile.dir().absolutePath() + QDir::separator() + stationName;
 
@@ -1016,6 +1007,12 @@ int GMWidget::processDownloadedRecords(QString& errorMessage)
         gridFeatureCollectionTable->addFeature(feature);
     }
 
+    if(!err.isEmpty())
+    {
+        errorMessage = err;
+        return -1;
+    }
+
     // Create a new layer
     LayerTreeView *layersTreeView = theVisualizationWidget->getLayersTree();
 
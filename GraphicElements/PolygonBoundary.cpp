@@ -112,55 +112,8 @@ void PolygonBoundary::getItemsInPolygonBoundary()
     if(polygonGeom.isEmpty())
         return;
 
-    // Set the envelope of the convex hull as the search parameter
-    QueryParameters queryParams;
-    auto envelope = Polygon(polygonGeom);
-    queryParams.setGeometry(envelope);
-    queryParams.setSpatialRelationship(SpatialRelationship::Contains);
-
-    QMap<QUuid, QString>& taskIDMap = theVisualizationWidget->getTaskIDMap();
-
-    // Iterate through the layers
-    // Function to do a nested search through the layers - this is needed because some layers may have sub-layers
-    std::function<void(const LayerListModel*)> layerIterator = [&](const LayerListModel* layers)
-    {
-        for(int i = 0; i<layers->size(); ++i)
-        {
-            auto layer = layers->at(i);
-
-            // Continue if the layer is turned off
-            if(!layer->isVisible())
-                continue;
-
-            if(auto featureCollectLayer = dynamic_cast<FeatureCollectionLayer*>(layer))
-            {
-                auto tables = featureCollectLayer->featureCollection()->tables();
-
-                for(int j = 0; j<tables->size(); ++j)
-                {
-                    auto table = tables->at(j);
-
-                    // Make this a unique, i.e., one-off connection so that it does not call the slot multiple times
-                    connect(table, &FeatureTable::queryFeaturesCompleted, theVisualizationWidget, &VisualizationWidget::selectFeaturesForAnalysisQueryCompleted, Qt::UniqueConnection);
-
-                    // Query the table for features - note that this is done asynchronously
-                    auto taskWatcher = table->queryFeatures(queryParams);
-
-                    if (!taskWatcher.isValid())
-                        qDebug() <<"Error, task not valid in "<<__FUNCTION__;
-                    else
-                        taskIDMap[taskWatcher.taskId()] = taskWatcher.description();
-                }
-            }
-            else if(auto isGroupLayer = dynamic_cast<GroupLayer*>(layer))
-            {
-                auto subLayers = isGroupLayer->layers();
-                layerIterator(subLayers);
-            }
-        }
-    };
-
-    layerIterator(layersList);
+    // Select the features inside the polygon - note that the features in some layers are queried asynchronously
+    theVisualizationWidget->selectFeaturesInGeometry(Polygon(polygonGeom));
 
     // Clear the graphics
     resetPolygonBoundary();
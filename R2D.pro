@@ -62,6 +62,9 @@ equals(QT_MAJOR_VERSION, 5) {
 
 DEFINES += INCLUDE_USER_PASS
 
+# Support for reading zstd compressed input files, gzip is always supported
+DEFINES += INCLUDE_ZSTD
+
 win32:DEFINES +=  CURL_STATICLIB
 
 #win32::include($$PWD/R2D.user.pri)
@@ -146,14 +149,28 @@ SOURCES +=  Events/UI/EarthquakeRuptureForecast.cpp \
             ModelViewItems/GISLegendView.cpp \
             ModelViewItems/SimCenterTreeView.cpp \
             Tools/AssetInputDelegate.cpp \
+            Tools/AttributeIndex.cpp \
             Tools/ComponentDatabase.cpp \
+            Tools/ComponentLoader.cpp \
+            Tools/ComponentQuery.cpp \
             Tools/CSVReaderWriter.cpp \
+            Tools/CSVRowReader.cpp \
+            Tools/CSVScanner.cpp \
+            Tools/CSVTable.cpp \
+            Tools/DecompressionDevice.cpp \
             Tools/ExampleDownloader.cpp \
+            Tools/FootprintDecoder.cpp \
+            Tools/GeoJsonReader.cpp \
+            Tools/GeometryCache.cpp \
+            Tools/HeatMapGrid.cpp \
             Tools/HurricanePreprocessor.cpp \
+            Tools/IntervalSet.cpp \
             Tools/NGAW2Converter.cpp \
             Tools/NetworkDownloadManager.cpp \
             Tools/PelicunPostProcessor.cpp \
+            Tools/PointPyramid.cpp \
             Tools/REmpiricalProbabilityDistribution.cpp \
+            Tools/RTree.cpp \
             Tools/TablePrinter.cpp \
             Tools/XMLAdaptor.cpp \
             Tools/ShakeMapClient.cpp \
@@ -174,6 +191,8 @@ SOURCES +=  Events/UI/EarthquakeRuptureForecast.cpp \
             UIWidgets/BuildingSimulationWidget.cpp \
             UIWidgets/CSVtoBIMModelingWidget.cpp \
             UIWidgets/ComponentInputWidget.cpp \
+            UIWidgets/ComponentSelectionFilter.cpp \
+            UIWidgets/ComponentTableModel.cpp \
             UIWidgets/DLWidget.cpp \
             UIWidgets/DamageMeasureWidget.cpp \
             UIWidgets/DecisionVariableWidget.cpp \
@@ -202,6 +221,7 @@ SOURCES +=  Events/UI/EarthquakeRuptureForecast.cpp \
             UIWidgets/NoneWidget.cpp \
             UIWidgets/OpenSeesPyBuildingModel.cpp \
             UIWidgets/PelicunDLWidget.cpp \
+            UIWidgets/PopUpTableModel.cpp \
             UIWidgets/PopUpWidget.cpp \
             UIWidgets/EmbeddedMapViewWidget.cpp \
             UIWidgets/ResultsWidget.cpp \
@@ -273,14 +293,28 @@ HEADERS +=  Events/UI/EarthquakeRuptureForecast.h \
             ModelViewItems/GISLegendView.h \
             ModelViewItems/SimCenterTreeView.h \
             Tools/AssetInputDelegate.h \
+            Tools/AttributeIndex.h \
             Tools/ComponentDatabase.h \
+            Tools/ComponentLoader.h \
+            Tools/ComponentQuery.h \
             Tools/CSVReaderWriter.h \
+            Tools/CSVRowReader.h \
+            Tools/CSVScanner.h \
+            Tools/CSVTable.h \
+            Tools/DecompressionDevice.h \
             Tools/ExampleDownloader.h \
+            Tools/FootprintDecoder.h \
+            Tools/GeoJsonReader.h \
+            Tools/GeometryCache.h \
+            Tools/HeatMapGrid.h \
             Tools/HurricanePreprocessor.h \
+            Tools/IntervalSet.h \
             Tools/NGAW2Converter.h \
             Tools/NetworkDownloadManager.h \
             Tools/PelicunPostProcessor.h \
+            Tools/PointPyramid.h \
             Tools/REmpiricalProbabilityDistribution.h \
+            Tools/RTree.h \
             Tools/TableNumberItem.h \
             Tools/TablePrinter.h \
             Tools/XMLAdaptor.h \
@@ -303,6 +337,8 @@ HEADERS +=  Events/UI/EarthquakeRuptureForecast.h \
             UIWidgets/BuildingSimulationWidget.h \
             UIWidgets/CSVtoBIMModelingWidget.h \
             UIWidgets/ComponentInputWidget.h \
+            UIWidgets/ComponentSelectionFilter.h \
+            UIWidgets/ComponentTableModel.h \
             UIWidgets/DLWidget.h \
             UIWidgets/DamageMeasureWidget.h \
             UIWidgets/DecisionVariableWidget.h \
@@ -331,6 +367,7 @@ HEADERS +=  Events/UI/EarthquakeRuptureForecast.h \
             UIWidgets/NoneWidget.h \
             UIWidgets/OpenSeesPyBuildingModel.h \
             UIWidgets/PelicunDLWidget.h \
+            UIWidgets/PopUpTableModel.h \
             UIWidgets/PopUpWidget.h \
             UIWidgets/EmbeddedMapViewWidget.h \
             UIWidgets/ResultsWidget.h \
@@ -379,8 +416,13 @@ DISTFILES += \
     resources/docs/textAboutR2DT.html
 
 # External libraries
-macos:LIBS += -lcurl -llapack -lblas
-linux:LIBS += /usr/lib/x86_64-linux-gnu/libcurl.so
+macos:LIBS += -lcurl -llapack -lblas -lz
+linux:LIBS += /usr/lib/x86_64-linux-gnu/libcurl.so -lz
+
+contains(DEFINES, INCLUDE_ZSTD) {
+    macos:LIBS += -lzstd
+    linux:LIBS += -lzstd
+}
 
 # Path to build directory
 win32 {
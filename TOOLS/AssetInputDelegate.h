@@ -38,9 +38,9 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 
 // Written by: Stevan Gavrilovic
 
-#include <QLineEdit>
+#include "IntervalSet.h"
 
-#include <set>
+#include <QLineEdit>
 
 class AssetInputDelegate : public QLineEdit
 {
@@ -49,10 +49,16 @@ class AssetInputDelegate : public QLineEdit
 public:
     AssetInputDelegate();
 
-    std::set<int> getSelectedComponentIDs() const;
+    const IntervalSet& getSelectedComponentIDs() const;
+
+    // Replaces the selection, e.g., with the result of a query, and emits componentSelectionComplete
+    void setSelectedComponentIDs(const IntervalSet& IDs);
 
     void insertSelectedCompoonent(const int id);
 
+    // Adds the IDs to the selection, setting the text once for all of them
+    void insertSelectedComponents(const IntervalSet& IDs);
+
     void clear();
 
     int size();
@@ -68,7 +74,8 @@ signals:
 
 private:
 
-    std::set<int> selectedComponentIDs;
+    // The selected IDs are kept as ranges, so that selecting a large range of assets does not expand it into the individual IDs
+    IntervalSet selectedComponentIDs;
 };
 
 #endif // ASSETINPUTDELEGATE_H
@@ -0,0 +1,134 @@
+/* *****************************************************************************
+Copyright (c) 2016-2021, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+// Written by: Stevan Gavrilovic
+
+#include "AttributeIndex.h"
+
+#include <algorithm>
+
+AttributeIndex::AttributeIndex()
+{
+
+}
+
+
+void AttributeIndex::addValue(const QString& value, const int item)
+{
+    if(value.isEmpty())
+        return;
+
+    addedValues.emplace_back(value.toCaseFolded(), item);
+}
+
+
+void AttributeIndex::build(void)
+{
+    if(addedValues.empty())
+        return;
+
+    // Put the items that are already in the index back with the new ones
+    for(size_t i = 0; i<values.size(); ++i)
+    {
+        for(int j = itemStarts[i]; j<itemStarts[i+1]; ++j)
+            addedValues.emplace_back(values[i], items[j]);
+    }
+
+    std::sort(addedValues.begin(), addedValues.end());
+
+    values.clear();
+    itemStarts.clear();
+    items.clear();
+
+    items.reserve(addedValues.size());
+
+    for(auto&& it : addedValues)
+    {
+        if(values.empty() || values.back() != it.first)
+        {
+            values.push_back(it.first);
+            itemStarts.push_back(int(items.size()));
+        }
+
+        items.push_back(it.second);
+    }
+
+    itemStarts.push_back(int(items.size()));
+
+    addedValues.clear();
+    addedValues.shrink_to_fit();
+}
+
+
+void AttributeIndex::clear(void)
+{
+    addedValues.clear();
+    values.clear();
+    itemStarts.clear();
+    items.clear();
+}
+
+
+bool AttributeIndex::isEmpty(void) const
+{
+    return values.empty();
+}
+
+
+int AttributeIndex::search(const QString& prefix, const std::function<bool(int item)>& visitor) const
+{
+    const auto foldedPrefix = prefix.toCaseFolded();
+
+    // The values that start with the prefix are together, starting at the first value that is not less than the prefix
+    auto first = std::lower_bound(values.begin(), values.end(), foldedPrefix);
+
+    int numVisited = 0;
+
+    for(auto it = first; it != values.end() && it->startsWith(foldedPrefix); ++it)
+    {
+        auto i = std::distance(values.begin(), it);
+
+        for(int j = itemStarts[i]; j<itemStarts[i+1]; ++j)
+        {
+            ++numVisited;
+
+            if(!visitor(items[j]))
+                return numVisited;
+        }
+    }
+
+    return numVisited;
+}
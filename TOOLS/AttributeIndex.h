@@ -0,0 +1,79 @@
+#ifndef ATTRIBUTEINDEX_H
+#define ATTRIBUTEINDEX_H
+/* *****************************************************************************
+Copyright (c) 2016-2021, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+// Written by: Stevan Gavrilovic
+
+// An index of text values for searching by prefix. The distinct values are kept sorted, ignoring case, and each value has a list of the
+// items that have it, so a search finds the first value with the prefix by a binary search and then reads the values that follow it
+
+#include <QString>
+
+#include <functional>
+#include <vector>
+
+class AttributeIndex
+{
+public:
+    AttributeIndex();
+
+    // Adds the value of an item, build() must be called after the values are added and before searching
+    void addValue(const QString& value, const int item);
+
+    // Sorts the values that were added into the index
+    void build(void);
+
+    void clear(void);
+
+    bool isEmpty(void) const;
+
+    // Visits the items whose values start with the prefix, ignoring case, in order of their values. Return false from the visitor to stop
+    // Returns the number of items visited
+    int search(const QString& prefix, const std::function<bool(int item)>& visitor) const;
+
+private:
+
+    // The values and items that were added since the last build
+    std::vector<std::pair<QString, int>> addedValues;
+
+    // The distinct values and the items of each value, which are in items from itemStarts[i] to itemStarts[i+1]
+    std::vector<QString> values;
+    std::vector<int> itemStarts;
+    std::vector<int> items;
+};
+
+#endif // ATTRIBUTEINDEX_H
@@ -37,11 +37,14 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 // Written by: Stevan Gavrilovic
 
 #include "CSVReaderWriter.h"
+#include "CSVTable.h"
+#include "CSVRowReader.h"
 
 #include <QVector>
-#include <QTextStream>
+#include <QThread>
 #include <QStringList>
 #include <QFile>
+#include <QtConcurrent/QtConcurrentMap>
 
 CSVReaderWriter::CSVReaderWriter()
 {
@@ -77,6 +80,25 @@ int CSVReaderWriter::saveCSVFile(const QVector<QStringList>& data, const QString
         }
     }
 
+    auto cellData = [&data](const int row, const int col)
+    {
+        return data[row+1][col];
+    };
+
+    return this->saveCSVFile(data.first(), data.size()-1, cellData, QVector<bool>(), pathToFile, err);
+}
+
+
+int CSVReaderWriter::saveCSVFile(const QStringList& header, const int numRows, const std::function<QString(const int row, const int col)>& cellData, const QVector<bool>& numericColumns, const QString& pathToFile, QString& err)
+{
+    auto numCol = header.size();
+
+    if(numCol==0)
+    {
+        err = "Empty data vector came into the function save data.";
+        return -1;
+    }
+
     QFile file(pathToFile);
 
     if (!file.open(QIODevice::WriteOnly))
@@ -85,156 +107,202 @@ int CSVReaderWriter::saveCSVFile(const QVector<QStringList>& data, const QString
         return -1;
     }
 
-    QTextStream csvFileOut(&file);
+    // Whether a column can be written without checking its cells for characters that need to be escaped
+    std::vector<char> skipEscape(numCol, 0);
+    for(int i = 0; i<qMin(numCol, numericColumns.size()); ++i)
+        skipEscape[i] = numericColumns[i];
 
-    // Function to handle the case where there are commas within a cell
-    auto strOutput = [](const QString& in)
+    auto formatRow = [&](const int row, QByteArray& out)
     {
-        auto newStr = in;
+        for(int i = 0; i<numCol; ++i)
+        {
+            appendCSVCell(cellData(row,i), !skipEscape[i], out);
 
-        newStr = newStr.replace("\"","\"\"");
+            // Add the terminating character
+            out.append(i != numCol-1 ? ',' : '\n');
+        }
+    };
 
-        if(newStr.contains(','))
-            return "\"" + newStr.toUtf8() + "\"";
-        else
-         return newStr.toUtf8();
+    QByteArray writeBuffer;
+    writeBuffer.reserve(2*writeBufferSize);
+
+    // Writes out the buffer once it is large enough, or when forced at the end of the file
+    auto flushBuffer = [&](const bool force)
+    {
+        if(writeBuffer.isEmpty() || (!force && writeBuffer.size() < writeBufferSize))
+            return true;
+
+        if(file.write(writeBuffer) != writeBuffer.size())
+        {
+            err = "Error writing to the file: " + pathToFile;
+            return false;
+        }
+
+        // Keeps the capacity for the next blocks
+        writeBuffer.resize(0);
+
+        return true;
     };
 
+    for(int i = 0; i<numCol; ++i)
+    {
+        appendCSVCell(header[i], true, writeBuffer);
+        writeBuffer.append(i != numCol-1 ? ',' : '\n');
+    }
 
-    for(auto&& row : data)
+    // The rows are formatted in blocks on the thread pool, a few blocks per thread at a time so that the memory used stays bounded
+    // The blocks are then appended to the write buffer in order
+    const int numBlocksPerBatch = 4*qMax(1, QThread::idealThreadCount());
+
+    QVector<QByteArray> blocks(numBlocksPerBatch);
+
+    for(int batchStart = 0; batchStart < numRows; batchStart += numBlocksPerBatch*rowsPerWriteBlock)
     {
-        for(int i = 0; i<numCol; ++i)
+        QVector<int> blockStarts;
+        for(int i = batchStart; i<qMin(numRows, batchStart + numBlocksPerBatch*rowsPerWriteBlock); i += rowsPerWriteBlock)
+            blockStarts.push_back(i);
+
+        QByteArray* blockData = blocks.data();
+
+        QtConcurrent::blockingMap(blockStarts, [&formatRow, blockData, batchStart, numRows](const int blockStart)
         {
-            csvFileOut<<strOutput(row[i]);
+            auto& out = blockData[(blockStart - batchStart)/rowsPerWriteBlock];
+            out.resize(0);
 
-            // Add the terminating character
-            if(i != numCol-1)
-                csvFileOut<<",";
-            else
-                csvFileOut<<"\n";
+            auto blockEnd = qMin(blockStart + rowsPerWriteBlock, numRows);
+
+            for(int i = blockStart; i<blockEnd; ++i)
+                formatRow(i, out);
+        });
+
+        for(int i = 0; i<blockStarts.size(); ++i)
+        {
+            writeBuffer.append(blocks[i]);
+
+            if(!flushBuffer(false))
+                return -1;
         }
     }
 
+    if(!flushBuffer(true))
+        return -1;
+
+    file.close();
 
     return 0;
 }
 
 
-QVector<QStringList> CSVReaderWriter::parseCSVFile(const QString &pathToFile, QString& err)
+void CSVReaderWriter::appendCSVCell(const QString& cell, const bool escape, QByteArray& out)
 {
-    QVector<QStringList> returnVec;
+    const QChar* chars = cell.constData();
+    const int len = cell.size();
 
-    QFile geomFile(pathToFile);
+    // Non-ASCII characters are encoded by Qt, the bytes of a multi-byte UTF-8 character never match a comma, quote, or newline
+    bool isAscii = true;
+    bool needsQuotes = false;
 
-    if (!geomFile.open(QIODevice::ReadOnly))
+    for(int i = 0; i<len; ++i)
     {
-        err = "Cannot find the file: " + pathToFile + "\nCheck your directory and try again.";
-        return returnVec;
+        auto c = chars[i].unicode();
+
+        if(c >= 0x80)
+            isAscii = false;
+        else if(escape && (c == ',' || c == '"' || c == '\n' || c == '\r'))
+            needsQuotes = true;
     }
 
-    QStringList rowLines;
-    while (!geomFile.atEnd())
+    if(isAscii && !needsQuotes)
     {
-        QString line = geomFile.readLine();
+        auto pos = out.size();
+        out.resize(pos + len);
 
-        rowLines << line;
-    }
+        char* dest = out.data() + pos;
+        for(int i = 0; i<len; ++i)
+            dest[i] = static_cast<char>(chars[i].unicode());
 
-    auto numRows = rowLines.size();
-    if(numRows == 0)
-    {
-        err = "Error in parsing the .csv file " + pathToFile + " in CVSReaderWriter::parseCSVFile";
-        return returnVec;
+        return;
     }
 
-    returnVec.reserve(numRows);
+    auto utf8 = cell.toUtf8();
 
-    for(auto&& it: rowLines)
+    if(!needsQuotes)
     {
-        auto lineStr = this->parseLineCSV(it);
-
-        returnVec.push_back(lineStr);
+        out.append(utf8);
+        return;
     }
 
-    return returnVec;
+    out.append('"');
+    out.append(utf8.replace("\"","\"\""));
+    out.append('"');
 }
 
 
-QStringList CSVReaderWriter::parseLineCSV(const QString &csvString)
+QVector<QStringList> CSVReaderWriter::parseCSVFile(const QString &pathToFile, QString& err, const bool parallel)
 {
-    QStringList fields;
-    QString value;
+    QVector<QStringList> returnVec;
 
-    bool hasQuote = false;
+    CSVTable table;
+
+    if(this->parseCSVFile(pathToFile, table, err, parallel) != 0)
+        return returnVec;
 
-    for (int i = 0; i < csvString.size(); ++i)
+    auto numRows = table.rowCount();
+
+    if(!parallel)
     {
-        const QChar current = csvString.at(i);
+        returnVec.reserve(numRows);
 
-        // Normal state
-        if (hasQuote == false)
-        {
-            // Comma
-            if (current == ',')
-            {
-                // Save field
-                fields.append(value.trimmed());
-                value.clear();
-            }
-
-            // Double-quote
-            else if (current == '"')
-            {
-                hasQuote = true;
-                value += current;
-            }
-
-            // Other character
-            else
-                value += current;
-        }
-        else if (hasQuote)
-        {
-            // Check for another double-quote
-            if (current == '"')
-            {
-                if (i < csvString.size())
-                {
-                    // A double double-quote?
-                    if (i+1 < csvString.size() && csvString.at(i+1) == '"')
-                    {
-                        value += '"';
-
-                        // Skip a second quote character in a row
-                        i++;
-                    }
-                    else
-                    {
-                        hasQuote = false;
-                        value += '"';
-                    }
-                }
-            }
-
-            // Other character
-            else
-                value += current;
-        }
+        for(int i = 0; i<numRows; ++i)
+            returnVec.push_back(table.getRow(i));
+
+        return returnVec;
     }
 
-    if (!value.isEmpty())
-        fields.append(value.trimmed());
+    // Convert the rows to strings in blocks on the thread pool, each block writes to its own rows of the output
+    returnVec.resize(numRows);
 
+    QStringList* rows = returnVec.data();
 
-    // Remove quotes and whitespace around quotes
-    for (int i=0; i<fields.size(); ++i)
-        if (fields[i].length()>=1 && fields[i].left(1)=='"')
-        {
-            fields[i]=fields[i].mid(1);
-            if (fields[i].length()>=1 && fields[i].right(1)=='"')
-                fields[i]=fields[i].left(fields[i].length()-1);
-        }
+    const int blockSize = 4096;
+
+    QVector<int> blockStarts;
+    for(int i = 0; i<numRows; i += blockSize)
+        blockStarts.push_back(i);
 
-    return fields;
+    QtConcurrent::blockingMap(blockStarts, [&table, rows, numRows](const int blockStart)
+    {
+        auto blockEnd = qMin(blockStart + blockSize, numRows);
+
+        for(int i = blockStart; i<blockEnd; ++i)
+            rows[i] = table.getRow(i);
+    });
+
+    return returnVec;
+}
+
+
+int CSVReaderWriter::parseCSVFile(const QString &pathToFile, CSVTable& table, QString& err, const bool parallel, const bool useCache)
+{
+    return table.load(pathToFile, err, parallel, useCache);
 }
 
+
+int CSVReaderWriter::forEachRow(const QString &pathToFile, const std::function<bool(const CSVRowReader& row)>& visitor, QString& err)
+{
+    CSVRowReader reader;
+
+    if(reader.open(pathToFile, err) != 0)
+        return -1;
+
+    while(reader.readRow(err))
+    {
+        if(!visitor(reader))
+            break;
+    }
+
+    if(!err.isEmpty())
+        return -1;
+
+    return 0;
+}
@@ -40,25 +40,51 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 
 #include <QVector>
 
+#include <functional>
+
 class QString;
+class QByteArray;
 class QStringList;
+class CSVTable;
+class CSVRowReader;
 
 class CSVReaderWriter
 {
 public:
     CSVReaderWriter();
 
-    // Saves data in the format of a CSV file
+    // Saves data in the format of a CSV file, the first row is the header
     int saveCSVFile(const QVector<QStringList>& data, const QString& pathToFile, QString& err);
 
+    // Saves a CSV file without first copying the cells into string lists. The cell at a row and column is returned by cellData, where row 0 is the first row after the header
+    // The rows are formatted in blocks on multiple threads, so cellData must be safe to call from any thread while the file is being written
+    // The columns flagged as true in numericColumns are written as they are, without checking for commas or quotes that need to be escaped
+    int saveCSVFile(const QStringList& header, const int numRows, const std::function<QString(const int row, const int col)>& cellData, const QVector<bool>& numericColumns, const QString& pathToFile, QString& err);
+
     // Parses a CSV file and returns the file as a vector of string lists
     // Each item in the vector (string list) corresponds to a row of the csv file that is parsed
     // The string list corresponds to the items within a row, i.e., the values in the cells. There are as many items in the string list as there are in the row of the CSV file
-    QVector<QStringList> parseCSVFile(const QString &pathToFile, QString& err);
+    // If parallel is true, the file is parsed in chunks on multiple threads, the output is identical to the serial parse
+    QVector<QStringList> parseCSVFile(const QString &pathToFile, QString& err, const bool parallel = false);
+
+    // Memory maps a CSV file into the table without creating a string for each cell, the cells are accessed as views or as typed columns
+    // Use this for large files where the rows do not need to be kept as strings. Returns 0 on success
+    // If useCache is true, the table is loaded from a binary cache when the file has not changed since it was last loaded, see CSVTable::load()
+    int parseCSVFile(const QString &pathToFile, CSVTable& table, QString& err, const bool parallel = false, const bool useCache = false);
+
+    // Streams the rows of a CSV file through the visitor one at a time, so that the memory used does not depend on the size of the file
+    // The header row is read first and its column indexes can be resolved from the reader, e.g., with indexOfColumn()
+    // The visitor is called for each of the following rows, return false from the visitor to stop reading. Returns 0 on success
+    int forEachRow(const QString &pathToFile, const std::function<bool(const CSVRowReader& row)>& visitor, QString& err);
 
 private:
 
-    QStringList parseLineCSV(const QString &csvString);
+    // Appends a cell to the output as UTF-8. If escape is true, a cell containing a comma, quote, or newline is put in quotes and its quotes are doubled
+    static void appendCSVCell(const QString& cell, const bool escape, QByteArray& out);
+
+    // The number of rows formatted by each thread at a time, and the size the output buffer reaches before it is written to the file
+    static constexpr int rowsPerWriteBlock = 4096;
+    static constexpr int writeBufferSize = 1 << 22;
 
 };
 
@@ -0,0 +1,290 @@
+/* *****************************************************************************
+Copyright (c) 2016-2021, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+// Written by: Stevan Gavrilovic
+
+#include "CSVRowReader.h"
+#include "CSVScanner.h"
+#include "DecompressionDevice.h"
+
+#include <cstring>
+
+CSVRowReader::CSVRowReader()
+{
+
+}
+
+
+CSVRowReader::~CSVRowReader()
+{
+
+}
+
+
+int CSVRowReader::open(const QString& pathToFile, QString& err, const bool hasHeader)
+{
+    this->close();
+
+    // Compressed files are decompressed on a background thread as they are read
+    theDevice = DecompressionDevice::openFile(pathToFile, err);
+
+    if (theDevice == nullptr)
+        return -1;
+
+    decompressor = dynamic_cast<DecompressionDevice*>(theDevice.get());
+
+    fileSize = decompressor != nullptr ? decompressor->getCompressedSize() : theDevice->size();
+
+    buffer.resize(bufferSize);
+
+    if(this->refillBuffer() < 0)
+    {
+        err = "Error reading the file: " + pathToFile;
+        this->close();
+        return -1;
+    }
+
+    // Skip the UTF-8 byte order mark
+    if(bufferEnd >= 3 && uchar(buffer[0]) == 0xEF && uchar(buffer[1]) == 0xBB && uchar(buffer[2]) == 0xBF)
+    {
+        nextRowBegin = 3;
+        bytesConsumed = 3;
+    }
+
+    if(!hasHeader)
+        return 0;
+
+    if(!this->readRow(err))
+    {
+        if(err.isEmpty())
+            err = "Error in parsing the .csv file " + pathToFile + ", the file is empty";
+
+        this->close();
+        return -1;
+    }
+
+    headerRow = this->getRow();
+
+    return 0;
+}
+
+
+void CSVRowReader::close(void)
+{
+    decompressor = nullptr;
+    theDevice.reset();
+    buffer.clear();
+    bufferEnd = 0;
+    rowBegin = 0;
+    nextRowBegin = 0;
+    cellStarts.clear();
+    atEndOfFile = false;
+    rowNumber = -1;
+    bytesConsumed = 0;
+    fileSize = 0;
+    headerRow.clear();
+}
+
+
+qint64 CSVRowReader::refillBuffer(void)
+{
+    // Drop everything before the start of the next row
+    if(nextRowBegin > 0)
+    {
+        std::memmove(buffer.data(), buffer.constData() + nextRowBegin, bufferEnd - nextRowBegin);
+        bufferEnd -= nextRowBegin;
+        nextRowBegin = 0;
+    }
+
+    // The row does not fit into the buffer
+    if(bufferEnd == buffer.size())
+        buffer.resize(buffer.size()*2);
+
+    auto numRead = theDevice->read(buffer.data() + bufferEnd, buffer.size() - bufferEnd);
+
+    if(numRead < 0)
+        return -1;
+
+    if(numRead == 0)
+        atEndOfFile = true;
+
+    bufferEnd += static_cast<int>(numRead);
+
+    return numRead;
+}
+
+
+bool CSVRowReader::readRow(QString& err)
+{
+    if(!theDevice)
+        return false;
+
+    // Nothing left in the buffer or in the file
+    if(nextRowBegin >= bufferEnd && atEndOfFile)
+        return false;
+
+    cellStarts.clear();
+    cellStarts.push_back(0);
+
+    // Offset of the scan position from the start of the row, this stays valid when the buffer is refilled
+    int scanOffset = 0;
+
+    bool inQuotes = false;
+    bool foundNewline = false;
+
+    while(true)
+    {
+        CSVScanner scanner(buffer.constData() + nextRowBegin, scanOffset, bufferEnd - nextRowBegin, inQuotes);
+
+        for(qint64 pos = scanner.next(); pos != -1; pos = scanner.next())
+        {
+            if(buffer.at(nextRowBegin + static_cast<int>(pos)) == '\n')
+            {
+                scanOffset = static_cast<int>(pos);
+                foundNewline = true;
+                break;
+            }
+
+            cellStarts.push_back(static_cast<int>(pos) + 1);
+        }
+
+        if(foundNewline)
+            break;
+
+        // Continue from the end of the data in the buffer with the quote state at that point
+        scanOffset = bufferEnd - nextRowBegin;
+        inQuotes = scanner.isInQuotes();
+
+        if(atEndOfFile)
+            break;
+
+        if(this->refillBuffer() < 0)
+        {
+            err = "Error reading the file at row " + QString::number(rowNumber + 2);
+            return false;
+        }
+    }
+
+    // Nothing but the end of the file
+    if(!foundNewline && scanOffset == 0)
+    {
+        nextRowBegin = bufferEnd;
+        return false;
+    }
+
+    // One past the end of the last cell in the row
+    cellStarts.push_back(scanOffset + 1);
+
+    rowBegin = nextRowBegin;
+
+    // Skip over the newline
+    auto rowLength = qMin(scanOffset + 1, bufferEnd - rowBegin);
+    nextRowBegin = rowBegin + rowLength;
+    bytesConsumed += rowLength;
+
+    ++rowNumber;
+
+    return true;
+}
+
+
+int CSVRowReader::columnCount(void) const
+{
+    if(cellStarts.empty())
+        return 0;
+
+    return static_cast<int>(cellStarts.size()) - 1;
+}
+
+
+CSVField CSVRowReader::at(const int col) const
+{
+    if(col < 0 || col >= this->columnCount())
+        return CSVField();
+
+    const char* rowData = buffer.constData() + rowBegin;
+
+    return CSVField::fromCell(rowData + cellStarts[col], rowData + cellStarts[col+1] - 1);
+}
+
+
+QStringList CSVRowReader::getRow(void) const
+{
+    QStringList rowList;
+
+    auto numCols = this->columnCount();
+
+    rowList.reserve(numCols);
+
+    for(int i = 0; i<numCols; ++i)
+        rowList.append(this->at(i).toString());
+
+    return rowList;
+}
+
+
+qint64 CSVRowReader::getRowNumber(void) const
+{
+    return rowNumber;
+}
+
+
+QStringList CSVRowReader::getHeader(void) const
+{
+    return headerRow;
+}
+
+
+int CSVRowReader::indexOfColumn(const QString& name) const
+{
+    return headerRow.indexOf(name);
+}
+
+
+qint64 CSVRowReader::getBytesRead(void) const
+{
+    // The progress through a compressed file is measured on the compressed bytes
+    if(decompressor != nullptr)
+        return decompressor->getCompressedBytesRead();
+
+    return bytesConsumed;
+}
+
+
+qint64 CSVRowReader::getFileSize(void) const
+{
+    return fileSize;
+}
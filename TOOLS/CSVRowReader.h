@@ -0,0 +1,126 @@
+#ifndef CSVROWREADER_H
+#define CSVROWREADER_H
+/* *****************************************************************************
+Copyright (c) 2016-2021, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+// Written by: Stevan Gavrilovic
+
+// Reads a CSV file one row at a time through a fixed size buffer, so that the memory used does not depend on the size of the file
+// Only the current row is available, the cells are views into the buffer that are valid until the next call to readRow()
+
+#include "CSVTable.h"
+
+#include <QString>
+#include <QStringList>
+
+#include <memory>
+#include <vector>
+
+class QIODevice;
+class DecompressionDevice;
+
+class CSVRowReader
+{
+public:
+    CSVRowReader();
+    ~CSVRowReader();
+
+    // Opens the file and, if hasHeader is true, reads the first row as the header. Returns 0 on success
+    // Files compressed with gzip or zstd are detected from their first bytes and decompressed while they are read
+    int open(const QString& pathToFile, QString& err, const bool hasHeader = true);
+
+    void close(void);
+
+    // Advances to the next row. Returns false at the end of the file, or if there is an error in which case err is set
+    bool readRow(QString& err);
+
+    // The number of cells in the current row
+    int columnCount(void) const;
+
+    // The cell in the current row, an empty field is returned if the cell does not exist
+    CSVField at(const int col) const;
+
+    // Returns the current row as a string list
+    QStringList getRow(void) const;
+
+    // The index of the current row in the file, starting at zero with the header row
+    qint64 getRowNumber(void) const;
+
+    QStringList getHeader(void) const;
+
+    // Returns the index of the column in the header, or -1 if it is not found. Resolve the indexes once before reading the rows
+    int indexOfColumn(const QString& name) const;
+
+    // The number of bytes of the file that have been processed and the total size, for progress reporting
+    // For a compressed file these are the compressed bytes
+    qint64 getBytesRead(void) const;
+    qint64 getFileSize(void) const;
+
+private:
+
+    // Moves the current row to the front of the buffer and fills the rest of the buffer from the file, returns the number of bytes read
+    qint64 refillBuffer(void);
+
+    std::unique_ptr<QIODevice> theDevice;
+
+    // Points to the device if the file is compressed
+    DecompressionDevice* decompressor = nullptr;
+
+    QByteArray buffer;
+
+    // The number of valid bytes in the buffer
+    int bufferEnd = 0;
+
+    // The start of the current row and of the next row in the buffer
+    int rowBegin = 0;
+    int nextRowBegin = 0;
+
+    // Offsets of the cells in the current row relative to the row start, with an extra entry one past the end of the last cell
+    std::vector<int> cellStarts;
+
+    bool atEndOfFile = false;
+
+    qint64 rowNumber = -1;
+    qint64 bytesConsumed = 0;
+    qint64 fileSize = 0;
+
+    QStringList headerRow;
+
+    // The initial size of the buffer, the buffer only grows if a single row is longer than this
+    static constexpr int bufferSize = 4 << 20;
+};
+
+#endif // CSVROWREADER_H
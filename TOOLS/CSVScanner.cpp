@@ -0,0 +1,279 @@
+/* *****************************************************************************
+Copyright (c) 2016-2021, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+// Written by: Stevan Gavrilovic
+
+#include "CSVScanner.h"
+
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define CSV_SCANNER_X86
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+namespace
+{
+
+struct BlockMasks
+{
+    quint64 quotes;
+    quint64 commas;
+    quint64 newlines;
+};
+
+typedef void (*ClassifyBlockFunction)(const char* block, BlockMasks& masks);
+
+
+void classifyBlockScalar(const char* block, BlockMasks& masks)
+{
+    quint64 quotes = 0;
+    quint64 commas = 0;
+    quint64 newlines = 0;
+
+    for(int i = 0; i<64; ++i)
+    {
+        const quint64 bit = quint64(1) << i;
+        const char c = block[i];
+
+        quotes |= (c == '"') ? bit : 0;
+        commas |= (c == ',') ? bit : 0;
+        newlines |= (c == '\n') ? bit : 0;
+    }
+
+    masks.quotes = quotes;
+    masks.commas = commas;
+    masks.newlines = newlines;
+}
+
+
+#ifdef CSV_SCANNER_X86
+
+void classifyBlockSSE2(const char* block, BlockMasks& masks)
+{
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i comma = _mm_set1_epi8(',');
+    const __m128i newline = _mm_set1_epi8('\n');
+
+    masks.quotes = 0;
+    masks.commas = 0;
+    masks.newlines = 0;
+
+    for(int i = 0; i<4; ++i)
+    {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + 16*i));
+
+        masks.quotes |= quint64(quint32(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, quote)))) << (16*i);
+        masks.commas |= quint64(quint32(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, comma)))) << (16*i);
+        masks.newlines |= quint64(quint32(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, newline)))) << (16*i);
+    }
+}
+
+
+#if defined(__GNUC__) || defined(__clang__)
+__attribute__((target("avx2")))
+#endif
+void classifyBlockAVX2(const char* block, BlockMasks& masks)
+{
+    const __m256i quote = _mm256_set1_epi8('"');
+    const __m256i comma = _mm256_set1_epi8(',');
+    const __m256i newline = _mm256_set1_epi8('\n');
+
+    const __m256i low = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block));
+    const __m256i high = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + 32));
+
+    masks.quotes = quint64(quint32(_mm256_movemask_epi8(_mm256_cmpeq_epi8(low, quote))))
+            | (quint64(quint32(_mm256_movemask_epi8(_mm256_cmpeq_epi8(high, quote)))) << 32);
+
+    masks.commas = quint64(quint32(_mm256_movemask_epi8(_mm256_cmpeq_epi8(low, comma))))
+            | (quint64(quint32(_mm256_movemask_epi8(_mm256_cmpeq_epi8(high, comma)))) << 32);
+
+    masks.newlines = quint64(quint32(_mm256_movemask_epi8(_mm256_cmpeq_epi8(low, newline))))
+            | (quint64(quint32(_mm256_movemask_epi8(_mm256_cmpeq_epi8(high, newline)))) << 32);
+}
+
+
+bool hasAVX2(void)
+{
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+
+    if(info[0] < 7)
+        return false;
+
+    // The OS must also save the AVX registers
+    __cpuid(info, 1);
+
+    const bool hasOSXSave = (info[2] & (1 << 27)) != 0;
+    const bool hasAVX = (info[2] & (1 << 28)) != 0;
+
+    if(!hasOSXSave || !hasAVX || (_xgetbv(0) & 0x6) != 0x6)
+        return false;
+
+    __cpuidex(info, 7, 0);
+
+    return (info[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#endif
+
+
+struct ScannerDispatch
+{
+    ClassifyBlockFunction classifyBlock;
+    const char* name;
+};
+
+
+// Returns false if the instruction set is not supported on this processor
+bool makeDispatch(const CSVScanner::InstructionSet instructionSet, ScannerDispatch& dispatch)
+{
+    switch(instructionSet)
+    {
+    case CSVScanner::Scalar:
+        dispatch = ScannerDispatch{classifyBlockScalar, "Scalar"};
+        return true;
+#ifdef CSV_SCANNER_X86
+    case CSVScanner::SSE2:
+        // SSE2 is part of the x86-64 baseline
+        dispatch = ScannerDispatch{classifyBlockSSE2, "SSE2"};
+        return true;
+    case CSVScanner::AVX2:
+        if(!hasAVX2())
+            return false;
+
+        dispatch = ScannerDispatch{classifyBlockAVX2, "AVX2"};
+        return true;
+#endif
+    default:
+        return false;
+    }
+}
+
+
+// Chooses the fastest implementation once, on first use
+ScannerDispatch& getDispatch(void)
+{
+    static ScannerDispatch dispatch = []()
+    {
+        ScannerDispatch fastest{classifyBlockScalar, "Scalar"};
+
+        if(!makeDispatch(CSVScanner::AVX2, fastest))
+            makeDispatch(CSVScanner::SSE2, fastest);
+
+        return fastest;
+    }();
+
+    return dispatch;
+}
+
+
+// Each bit of the result is the XOR of all of the bits at and below it, i.e., the bits from an opening quote up to the closing quote are set
+inline quint64 prefixXor(quint64 mask)
+{
+    mask ^= mask << 1;
+    mask ^= mask << 2;
+    mask ^= mask << 4;
+    mask ^= mask << 8;
+    mask ^= mask << 16;
+    mask ^= mask << 32;
+
+    return mask;
+}
+
+}
+
+
+CSVScanner::CSVScanner(const char* data, const qint64 begin, const qint64 end, const bool inQuotes)
+    : data(data), currentBlock(begin), blockStart(begin), rangeEnd(end), quoteCarry(inQuotes ? ~quint64(0) : 0)
+{
+
+}
+
+
+void CSVScanner::scanNextBlock(void)
+{
+    const char* block = data + blockStart;
+    const qint64 numBytes = rangeEnd - blockStart;
+
+    // Pad the last partial block with zeros, these are never structural characters
+    char paddedBlock[64];
+    if(numBytes < 64)
+    {
+        std::memset(paddedBlock, 0, 64);
+        std::memcpy(paddedBlock, block, numBytes);
+        block = paddedBlock;
+    }
+
+    BlockMasks masks;
+    getDispatch().classifyBlock(block, masks);
+
+    const quint64 insideQuotes = prefixXor(masks.quotes) ^ quoteCarry;
+
+    // Carry the quote state of the last byte over into the next block
+    quoteCarry = quint64(qint64(insideQuotes) >> 63);
+
+    structuralMask = (masks.commas | masks.newlines) & ~insideQuotes;
+
+    currentBlock = blockStart;
+    blockStart += 64;
+}
+
+
+bool CSVScanner::isInQuotes(void) const
+{
+    return quoteCarry != 0;
+}
+
+
+const char* CSVScanner::getInstructionSetName(void)
+{
+    return getDispatch().name;
+}
+
+
+bool CSVScanner::setInstructionSet(const InstructionSet instructionSet)
+{
+    return makeDispatch(instructionSet, getDispatch());
+}
@@ -0,0 +1,119 @@
+#ifndef CSVSCANNER_H
+#define CSVSCANNER_H
+/* *****************************************************************************
+Copyright (c) 2016-2021, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+// Written by: Stevan Gavrilovic
+
+// Finds the structural characters of a CSV file, i.e., the commas and newlines that are not within quotes, 64 bytes at a time
+// Each block of 64 bytes is classified into bit masks of the quotes, commas and newlines using SIMD instructions when they are available.
+// The quoted regions are found from the prefix XOR of the quote mask, so that there is no branch per character. The instruction set is
+// chosen at runtime, AVX2 or SSE2 on x86-64 processors with a scalar fallback for all other processors
+
+#include <QtGlobal>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+class CSVScanner
+{
+public:
+
+    // Scans the bytes in the range [begin, end) of data, where inQuotes is the quote state at begin
+    CSVScanner(const char* data, const qint64 begin, const qint64 end, const bool inQuotes = false);
+
+    // Returns the position of the next comma or newline outside of quotes, or -1 when the end of the range is reached
+    inline qint64 next(void)
+    {
+        while(structuralMask == 0)
+        {
+            if(blockStart >= rangeEnd)
+                return -1;
+
+            this->scanNextBlock();
+        }
+
+        const qint64 pos = currentBlock + countTrailingZeros(structuralMask);
+
+        // Clear the lowest set bit
+        structuralMask &= structuralMask - 1;
+
+        return pos;
+    }
+
+    // The quote state at the end of the scanned blocks, valid once next() has returned -1
+    bool isInQuotes(void) const;
+
+    // The name of the instruction set that is used on this processor
+    static const char* getInstructionSetName(void);
+
+    enum InstructionSet { Scalar, SSE2, AVX2 };
+
+    // Makes the scanners use the given instruction set instead of the fastest one, for the tests and benchmarks. Call this before any
+    // scanning starts. Returns false and keeps the current instruction set if this processor does not support the given one
+    static bool setInstructionSet(const InstructionSet instructionSet);
+
+private:
+
+    void scanNextBlock(void);
+
+    static inline int countTrailingZeros(const quint64 mask)
+    {
+#if defined(_MSC_VER)
+        unsigned long index;
+        _BitScanForward64(&index, mask);
+        return static_cast<int>(index);
+#else
+        return __builtin_ctzll(mask);
+#endif
+    }
+
+    const char* data;
+
+    // The start of the block being iterated over and of the next block to scan
+    qint64 currentBlock;
+    qint64 blockStart;
+    qint64 rangeEnd;
+
+    // All ones if the previous block ended within quotes
+    quint64 quoteCarry;
+
+    // The commas and newlines outside of quotes in the current block that have not been returned yet
+    quint64 structuralMask = 0;
+};
+
+#endif // CSVSCANNER_H
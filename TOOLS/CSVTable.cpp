@@ -0,0 +1,1289 @@
+/* *****************************************************************************
+Copyright (c) 2016-2021, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+// Written by: Stevan Gavrilovic
+
+#include "CSVTable.h"
+#include "CSVScanner.h"
+#include "DecompressionDevice.h"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QStandardPaths>
+#include <QThread>
+#include <QtConcurrent/QtConcurrentMap>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+namespace
+{
+
+// The layout of the cache file, the header is followed by the arrays at the given offsets, each of which is aligned to 8 bytes
+// The column types follow the cell starts, then for each column that is not text, one 8 byte value per row below the header
+struct CacheHeader
+{
+    char magic[8];
+    quint32 version;
+    quint32 headerSize;
+
+    // The state of the CSV file when the cache was made
+    qint64 sourceSize;
+    qint64 sourceModified;
+    char sourceHash[24];
+
+    qint64 numRows;
+    qint64 numCells;
+    qint64 numColumns;
+
+    qint64 rowStartsOffset;
+    qint64 rowCellsOffset;
+    qint64 cellStartsOffset;
+    qint64 columnTypesOffset;
+    qint64 columnDataOffset;
+
+    qint64 cacheSize;
+};
+
+const char cacheMagic[8] = {'R','2','D','C','S','V','\0','\0'};
+const quint32 cacheVersion = 2;
+
+inline qint64 alignTo8(const qint64 offset)
+{
+    return (offset + 7) & ~qint64(7);
+}
+
+inline bool isWhiteSpace(const char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\v' || c == '\f';
+}
+
+// Returns true if the cell starts with a zero followed by another digit, e.g., a zip code such as 02139. These are codes rather than numbers,
+// and they are kept as text so that the zeros are not lost, in the same way as the component database keeps them
+inline bool hasLeadingZero(const CSVField& field)
+{
+    const char* str = field.data();
+    const int len = field.size();
+
+    const int first = (len > 0 && (str[0] == '-' || str[0] == '+')) ? 1 : 0;
+
+    return len > first + 1 && str[first] == '0' && str[first + 1] >= '0' && str[first + 1] <= '9';
+}
+
+// Parses a plain decimal number of the form [+-]digits[.digits][(e|E)[+-]digits] when the result can be computed exactly in double precision,
+// i.e., when the mantissa fits into 53 bits and the power of ten is exactly representable. Returns false for anything else so that the
+// caller can fall back on the full conversion
+bool fastStringToDouble(const char* str, const int len, double& val)
+{
+    static const double powersOfTen[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                                         1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+    int i = 0;
+
+    bool negative = false;
+    if(i < len && (str[i] == '-' || str[i] == '+'))
+    {
+        negative = str[i] == '-';
+        ++i;
+    }
+
+    quint64 mantissa = 0;
+    int numDigits = 0;
+    int exponent = 0;
+    bool hasDigits = false;
+
+    for(; i < len && str[i] >= '0' && str[i] <= '9'; ++i)
+    {
+        hasDigits = true;
+
+        if(mantissa == 0 && str[i] == '0')
+            continue;
+
+        if(++numDigits > 19)
+            return false;
+
+        mantissa = mantissa*10 + (str[i] - '0');
+    }
+
+    if(i < len && str[i] == '.')
+    {
+        ++i;
+
+        for(; i < len && str[i] >= '0' && str[i] <= '9'; ++i)
+        {
+            hasDigits = true;
+            --exponent;
+
+            if(mantissa == 0 && str[i] == '0')
+                continue;
+
+            if(++numDigits > 19)
+                return false;
+
+            mantissa = mantissa*10 + (str[i] - '0');
+        }
+    }
+
+    if(!hasDigits)
+        return false;
+
+    if(i < len && (str[i] == 'e' || str[i] == 'E'))
+    {
+        ++i;
+
+        bool negativeExp = false;
+        if(i < len && (str[i] == '-' || str[i] == '+'))
+        {
+            negativeExp = str[i] == '-';
+            ++i;
+        }
+
+        if(i == len)
+            return false;
+
+        int exp = 0;
+        for(; i < len && str[i] >= '0' && str[i] <= '9'; ++i)
+        {
+            if(exp > 10000)
+                return false;
+
+            exp = exp*10 + (str[i] - '0');
+        }
+
+        exponent += negativeExp ? -exp : exp;
+    }
+
+    // Trailing characters that are not part of a number
+    if(i != len)
+        return false;
+
+    if(mantissa > (quint64(1) << 53) || exponent < -22 || exponent > 22)
+        return false;
+
+    val = static_cast<double>(mantissa);
+
+    if(exponent < 0)
+        val /= powersOfTen[-exponent];
+    else
+        val *= powersOfTen[exponent];
+
+    if(negative)
+        val = -val;
+
+    return true;
+}
+
+}
+
+
+CSVField CSVField::fromCell(const char* begin, const char* end)
+{
+    // Remove the whitespace, including any carriage return left over from a Windows line ending
+    while(begin < end && isWhiteSpace(*begin))
+        ++begin;
+
+    while(end > begin && isWhiteSpace(*(end-1)))
+        --end;
+
+    // Remove the quotes
+    bool quoted = false;
+    if(begin < end && *begin == '"')
+    {
+        quoted = true;
+        ++begin;
+
+        if(end > begin && *(end-1) == '"')
+            --end;
+    }
+
+    return CSVField(begin, static_cast<int>(end - begin), quoted);
+}
+
+
+QString CSVField::toString(void) const
+{
+    // Empty cells are returned as null strings
+    if(len == 0)
+        return QString();
+
+    auto str = QString::fromUtf8(ptr, len);
+
+    // Any double quotes within a quoted cell are escaped by another double quote
+    if(isQuoted && std::memchr(ptr, '"', len) != nullptr)
+        str.replace("\"\"","\"");
+
+    return str;
+}
+
+
+double CSVField::toDouble(bool* ok) const
+{
+    double val = 0.0;
+
+    if(fastStringToDouble(ptr, len, val))
+    {
+        if(ok)
+            *ok = true;
+
+        return val;
+    }
+
+    // Handles the special cases, e.g., inf, nan, and long mantissas
+    return QByteArray(ptr, len).toDouble(ok);
+}
+
+
+qint64 CSVField::toLongLong(bool* ok) const
+{
+    if(ok)
+        *ok = false;
+
+    int i = 0;
+
+    bool negative = false;
+    if(i < len && (ptr[i] == '-' || ptr[i] == '+'))
+    {
+        negative = ptr[i] == '-';
+        ++i;
+    }
+
+    if(i == len)
+        return 0;
+
+    quint64 val = 0;
+    const quint64 maxVal = quint64(std::numeric_limits<qint64>::max()) + (negative ? 1 : 0);
+
+    for(; i < len; ++i)
+    {
+        if(ptr[i] < '0' || ptr[i] > '9')
+            return 0;
+
+        const quint64 digit = ptr[i] - '0';
+
+        if(val > (maxVal - digit)/10)
+            return 0;
+
+        val = val*10 + digit;
+    }
+
+    if(ok)
+        *ok = true;
+
+    return negative ? qint64(0 - val) : qint64(val);
+}
+
+
+int CSVField::toInt(bool* ok) const
+{
+    bool convOK = false;
+    auto val = this->toLongLong(&convOK);
+
+    if(!convOK || val < std::numeric_limits<int>::min() || val > std::numeric_limits<int>::max())
+    {
+        if(ok)
+            *ok = false;
+
+        return 0;
+    }
+
+    if(ok)
+        *ok = true;
+
+    return static_cast<int>(val);
+}
+
+
+bool CSVField::operator==(const CSVField& other) const
+{
+    return len == other.len && (len == 0 || std::memcmp(ptr, other.ptr, len) == 0);
+}
+
+
+bool CSVField::operator==(const char* str) const
+{
+    const auto strLen = std::strlen(str);
+
+    return size_t(len) == strLen && (len == 0 || std::memcmp(ptr, str, len) == 0);
+}
+
+
+CSVTable::CSVTable()
+{
+
+}
+
+
+CSVTable::~CSVTable()
+{
+
+}
+
+
+CSVTable::CSVTable(CSVTable&& other)
+{
+    *this = std::move(other);
+}
+
+
+CSVTable& CSVTable::operator=(CSVTable&& other)
+{
+    if(this == &other)
+        return *this;
+
+    theFile = std::move(other.theFile);
+    fileBuffer = std::move(other.fileBuffer);
+    fileData = other.fileData;
+    fileSize = other.fileSize;
+    rowStarts = std::move(other.rowStarts);
+    rowCells = std::move(other.rowCells);
+    cellStarts = std::move(other.cellStarts);
+    rowStartData = other.rowStartData;
+    rowCellData = other.rowCellData;
+    cellStartData = other.cellStartData;
+    numRows = other.numRows;
+    cacheFile = std::move(other.cacheFile);
+    typedColumns = std::move(other.typedColumns);
+
+    other.clear();
+
+    return *this;
+}
+
+
+int CSVTable::load(const QString& pathToFile, QString& err, const bool parallel, const bool useCache)
+{
+    this->clear();
+
+    // Compressed files are decompressed into memory, they are not cached since the cache refers to the cells in the mapped file
+    if(DecompressionDevice::detectFormat(pathToFile) != DecompressionDevice::Format::None)
+    {
+        if(DecompressionDevice::readFile(pathToFile, fileBuffer, err) != 0)
+            return -1;
+
+        if(fileBuffer.isEmpty())
+        {
+            err = "Error in parsing the .csv file " + pathToFile + ", the file is empty";
+            this->clear();
+            return -1;
+        }
+
+        fileData = fileBuffer.constData();
+        fileSize = fileBuffer.size();
+
+        return this->tokenizeLoadedFile(pathToFile, err, parallel, false);
+    }
+
+    theFile = std::make_unique<QFile>(pathToFile);
+
+    if (!theFile->open(QIODevice::ReadOnly))
+    {
+        err = "Cannot find the file: " + pathToFile + "\nCheck your directory and try again.";
+        theFile.reset();
+        return -1;
+    }
+
+    fileSize = theFile->size();
+
+    if(fileSize == 0)
+    {
+        err = "Error in parsing the .csv file " + pathToFile + ", the file is empty";
+        this->clear();
+        return -1;
+    }
+
+    auto mappedData = theFile->map(0, fileSize);
+
+    if(mappedData != nullptr)
+    {
+        fileData = reinterpret_cast<const char*>(mappedData);
+    }
+    else
+    {
+        // Not all files can be mapped, e.g., files on some network drives, fall back on reading the file into memory
+        fileBuffer = theFile->readAll();
+        theFile.reset();
+
+        fileData = fileBuffer.constData();
+        fileSize = fileBuffer.size();
+    }
+
+    if(useCache && this->loadCache(pathToFile) == 0)
+        return 0;
+
+    return this->tokenizeLoadedFile(pathToFile, err, parallel, useCache);
+}
+
+
+int CSVTable::tokenizeLoadedFile(const QString& pathToFile, QString& err, const bool parallel, const bool useCache)
+{
+    this->tokenize(parallel);
+    this->setIndexData();
+
+    if(numRows == 0)
+    {
+        err = "Error in parsing the .csv file " + pathToFile + ", no rows were found";
+        this->clear();
+        return -1;
+    }
+
+    if(useCache)
+    {
+        this->findColumnTypes();
+
+        // The table is still good if the cache cannot be written, e.g., if the disk is full
+        QString cacheErr;
+        if(this->saveCache(pathToFile, cacheErr) != 0)
+            qDebug()<<cacheErr;
+    }
+
+    return 0;
+}
+
+
+void CSVTable::setIndexData(void)
+{
+    rowStartData = rowStarts.data();
+    rowCellData = rowCells.data();
+    cellStartData = cellStarts.data();
+    numRows = static_cast<int>(rowStarts.size());
+}
+
+
+QString CSVTable::getCachePath(const QString& pathToFile)
+{
+    // The cache is named after a hash of the absolute path so that files with the same name in different folders do not collide
+    auto absolutePath = QFileInfo(pathToFile).absoluteFilePath();
+
+    auto pathHash = QCryptographicHash::hash(absolutePath.toUtf8(), QCryptographicHash::Sha1).toHex();
+
+    auto cacheDir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + QDir::separator() + "AssetCache";
+
+    return cacheDir + QDir::separator() + QString::fromLatin1(pathHash) + ".bin";
+}
+
+
+QByteArray CSVTable::getContentHash(void) const
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+
+    if(fileSize <= maxFullHashSize)
+    {
+        hash.addData(fileData, static_cast<int>(fileSize));
+    }
+    else
+    {
+        // The first and last samples are always included, the rest are spread evenly through the file
+        const qint64 stride = (fileSize - hashSampleSize)/(numHashSamples - 1);
+
+        for(int i = 0; i<numHashSamples; ++i)
+            hash.addData(fileData + i*stride, static_cast<int>(hashSampleSize));
+    }
+
+    return hash.result();
+}
+
+
+int CSVTable::loadCache(const QString& pathToFile)
+{
+    auto cache = std::make_unique<QFile>(getCachePath(pathToFile));
+
+    if(!cache->exists() || !cache->open(QIODevice::ReadOnly))
+        return -1;
+
+    const qint64 cacheSize = cache->size();
+
+    if(cacheSize < qint64(sizeof(CacheHeader)))
+        return -1;
+
+    auto mappedCache = cache->map(0, cacheSize);
+
+    if(mappedCache == nullptr)
+        return -1;
+
+    const char* cacheData = reinterpret_cast<const char*>(mappedCache);
+
+    CacheHeader header;
+    std::memcpy(&header, cacheData, sizeof(CacheHeader));
+
+    if(std::memcmp(header.magic, cacheMagic, sizeof(cacheMagic)) != 0 || header.version != cacheVersion ||
+            header.headerSize != sizeof(CacheHeader) || header.cacheSize != cacheSize)
+        return -1;
+
+    // Check that the CSV file has not changed since the cache was made, the hash is checked last since it has to read the file
+    QFileInfo sourceInfo(pathToFile);
+
+    if(header.sourceSize != fileSize || header.sourceModified != sourceInfo.lastModified().toMSecsSinceEpoch())
+        return -1;
+
+    auto contentHash = this->getContentHash();
+
+    if(contentHash.size() > int(sizeof(header.sourceHash)) || std::memcmp(header.sourceHash, contentHash.constData(), contentHash.size()) != 0)
+        return -1;
+
+    if(header.numRows <= 0 || header.numRows > std::numeric_limits<int>::max() || header.numCells < 0 || header.numCells > cacheSize ||
+            header.numColumns < 0 || header.numColumns > cacheSize)
+        return -1;
+
+    // Check that the arrays start after the header, are aligned, and fit within the file. The counts and offsets are bounded by the size
+    // of the cache first so that the sums below cannot overflow
+    auto isValidOffset = [&](const qint64 offset)
+    {
+        return offset >= alignTo8(sizeof(CacheHeader)) && offset <= cacheSize && offset % 8 == 0;
+    };
+
+    if(!isValidOffset(header.rowStartsOffset) || !isValidOffset(header.rowCellsOffset) || !isValidOffset(header.cellStartsOffset) ||
+            !isValidOffset(header.columnTypesOffset) || !isValidOffset(header.columnDataOffset))
+        return -1;
+
+    const qint64 numTypedValues = header.numRows - 1;
+
+    if(header.rowStartsOffset + 8*header.numRows > cacheSize || header.rowCellsOffset + 8*(header.numRows + 1) > cacheSize ||
+            header.cellStartsOffset + 4*header.numCells > cacheSize || header.columnTypesOffset + header.numColumns > cacheSize)
+        return -1;
+
+    // Check the contents of the index arrays, so that a damaged or stale cache cannot point outside of the mapped file. Each row needs the
+    // extra entry past its last cell, the cells of a row are in order, and the last cell ends at most at the end of the file
+    const qint64* cachedRowStarts = reinterpret_cast<const qint64*>(cacheData + header.rowStartsOffset);
+    const quint64* cachedRowCells = reinterpret_cast<const quint64*>(cacheData + header.rowCellsOffset);
+    const quint32* cachedCellStarts = reinterpret_cast<const quint32*>(cacheData + header.cellStartsOffset);
+
+    if(cachedRowCells[0] != 0 || cachedRowCells[header.numRows] != quint64(header.numCells))
+        return -1;
+
+    for(qint64 row = 0; row<header.numRows; ++row)
+    {
+        const qint64 rowStart = cachedRowStarts[row];
+        const quint64 firstCell = cachedRowCells[row];
+        const quint64 lastCell = cachedRowCells[row+1];
+
+        if(rowStart < 0 || rowStart > fileSize || (row > 0 && rowStart < cachedRowStarts[row-1]) || lastCell <= firstCell ||
+                lastCell > quint64(header.numCells))
+            return -1;
+
+        for(quint64 cell = firstCell + 1; cell<lastCell; ++cell)
+        {
+            if(cachedCellStarts[cell] <= cachedCellStarts[cell-1])
+                return -1;
+        }
+
+        if(rowStart + qint64(cachedCellStarts[lastCell-1]) > fileSize + 1)
+            return -1;
+    }
+
+    const quint8* columnTypes = reinterpret_cast<const quint8*>(cacheData + header.columnTypesOffset);
+
+    std::vector<TypedColumn> cachedColumns(header.numColumns);
+
+    qint64 columnOffset = header.columnDataOffset;
+
+    for(qint64 i = 0; i<header.numColumns; ++i)
+    {
+        if(columnTypes[i] > quint8(ColumnType::Double))
+            return -1;
+
+        auto& column = cachedColumns[i];
+        column.type = static_cast<ColumnType>(columnTypes[i]);
+
+        if(column.type == ColumnType::Text)
+            continue;
+
+        if(columnOffset + 8*numTypedValues > cacheSize)
+            return -1;
+
+        if(column.type == ColumnType::Double)
+            column.doubles = reinterpret_cast<const double*>(cacheData + columnOffset);
+        else
+            column.integers = reinterpret_cast<const qint64*>(cacheData + columnOffset);
+
+        columnOffset += 8*numTypedValues;
+    }
+
+    rowStartData = cachedRowStarts;
+    rowCellData = cachedRowCells;
+    cellStartData = cachedCellStarts;
+    numRows = static_cast<int>(header.numRows);
+
+    typedColumns = std::move(cachedColumns);
+    cacheFile = std::move(cache);
+
+    return 0;
+}
+
+
+int CSVTable::saveCache(const QString& pathToFile, QString& err) const
+{
+    auto cachePath = getCachePath(pathToFile);
+
+    QFileInfo cacheInfo(cachePath);
+
+    if(!QDir().mkpath(cacheInfo.absolutePath()))
+    {
+        err = "Could not create the folder for the cache " + cacheInfo.absolutePath();
+        return -1;
+    }
+
+    const qint64 numTypedValues = numRows - 1;
+    const qint64 numCells = static_cast<qint64>(rowCellData[numRows]);
+    const qint64 numColumns = static_cast<qint64>(typedColumns.size());
+
+    CacheHeader header;
+    std::memset(&header, 0, sizeof(CacheHeader));
+
+    std::memcpy(header.magic, cacheMagic, sizeof(cacheMagic));
+    header.version = cacheVersion;
+    header.headerSize = sizeof(CacheHeader);
+
+    header.sourceSize = fileSize;
+    header.sourceModified = QFileInfo(pathToFile).lastModified().toMSecsSinceEpoch();
+
+    auto contentHash = this->getContentHash();
+    std::memcpy(header.sourceHash, contentHash.constData(), qMin(contentHash.size(), int(sizeof(header.sourceHash))));
+
+    header.numRows = numRows;
+    header.numCells = numCells;
+    header.numColumns = numColumns;
+
+    header.rowStartsOffset = alignTo8(sizeof(CacheHeader));
+    header.rowCellsOffset = header.rowStartsOffset + 8*qint64(numRows);
+    header.cellStartsOffset = header.rowCellsOffset + 8*(qint64(numRows) + 1);
+    header.columnTypesOffset = alignTo8(header.cellStartsOffset + 4*numCells);
+    header.columnDataOffset = alignTo8(header.columnTypesOffset + numColumns);
+
+    qint64 cacheSize = header.columnDataOffset;
+    for(auto&& column : typedColumns)
+    {
+        if(column.type != ColumnType::Text)
+            cacheSize += 8*numTypedValues;
+    }
+
+    header.cacheSize = cacheSize;
+
+    // Write to a temporary file first so that a cache that is only partly written is never picked up
+    QFile cache(cachePath + ".tmp");
+
+    if(!cache.open(QIODevice::WriteOnly))
+    {
+        err = "Could not create the cache file " + cachePath;
+        return -1;
+    }
+
+    bool ok = true;
+
+    auto writeData = [&](const void* data, const qint64 numBytes)
+    {
+        if(ok && numBytes > 0)
+            ok = cache.write(reinterpret_cast<const char*>(data), numBytes) == numBytes;
+    };
+
+    auto writePadding = [&](const qint64 offset)
+    {
+        const char zeros[8] = {0};
+        writeData(zeros, alignTo8(offset) - offset);
+    };
+
+    writeData(&header, sizeof(CacheHeader));
+    writePadding(sizeof(CacheHeader));
+    writeData(rowStartData, 8*qint64(numRows));
+    writeData(rowCellData, 8*(qint64(numRows) + 1));
+    writeData(cellStartData, 4*numCells);
+    writePadding(header.cellStartsOffset + 4*numCells);
+
+    std::vector<quint8> columnTypes;
+    for(auto&& column : typedColumns)
+        columnTypes.push_back(quint8(column.type));
+
+    writeData(columnTypes.data(), numColumns);
+    writePadding(header.columnTypesOffset + numColumns);
+
+    for(auto&& column : typedColumns)
+    {
+        if(column.type == ColumnType::Double)
+            writeData(column.doubles, 8*numTypedValues);
+        else if(column.type == ColumnType::Integer)
+            writeData(column.integers, 8*numTypedValues);
+    }
+
+    cache.close();
+
+    if(!ok || cache.size() != cacheSize)
+    {
+        err = "Error writing the cache file " + cachePath;
+        cache.remove();
+        return -1;
+    }
+
+    QFile::remove(cachePath);
+
+    if(!cache.rename(cachePath))
+    {
+        err = "Could not rename the cache file to " + cachePath;
+        cache.remove();
+        return -1;
+    }
+
+    return 0;
+}
+
+
+void CSVTable::findColumnTypes(void)
+{
+    std::vector<TypedColumn> columns(this->columnCount(0));
+
+    if(columns.empty())
+    {
+        typedColumns.clear();
+        return;
+    }
+
+    QVector<int> columnIndexes;
+    for(int i = 0; i<int(columns.size()); ++i)
+        columnIndexes.push_back(i);
+
+    // Each column is typed independently on the thread pool. A column is an integer column if every cell below the header is an integer,
+    // otherwise it is a double column if every cell is a number. Empty cells are given a value of zero, but a column of only empty cells is text,
+    // as is a column with any numbers that have leading zeros
+    QtConcurrent::blockingMap(columnIndexes, [this, &columns](const int col)
+    {
+        auto& column = columns[col];
+
+        column.type = ColumnType::Integer;
+
+        bool hasValue = false;
+
+        for(int i = 1; i<numRows; ++i)
+        {
+            if(col >= this->columnCount(i))
+            {
+                column.type = ColumnType::Text;
+                break;
+            }
+
+            auto field = this->at(i,col);
+
+            if(field.isEmpty())
+            {
+                if(column.type == ColumnType::Integer)
+                    column.integerStorage.push_back(0);
+                else
+                    column.doubleStorage.push_back(0.0);
+
+                continue;
+            }
+
+            hasValue = true;
+
+            if(hasLeadingZero(field))
+            {
+                column.type = ColumnType::Text;
+                break;
+            }
+
+            bool OK = false;
+
+            if(column.type == ColumnType::Integer)
+            {
+                auto val = field.toLongLong(&OK);
+
+                if(OK)
+                {
+                    column.integerStorage.push_back(val);
+                    continue;
+                }
+
+                // Switch to doubles and convert the integers read so far
+                column.type = ColumnType::Double;
+                column.doubleStorage.assign(column.integerStorage.begin(), column.integerStorage.end());
+                std::vector<qint64>().swap(column.integerStorage);
+            }
+
+            auto val = field.toDouble(&OK);
+
+            if(!OK)
+            {
+                column.type = ColumnType::Text;
+                break;
+            }
+
+            column.doubleStorage.push_back(val);
+        }
+
+        if(!hasValue)
+            column.type = ColumnType::Text;
+
+        if(column.type != ColumnType::Integer)
+            std::vector<qint64>().swap(column.integerStorage);
+
+        if(column.type != ColumnType::Double)
+            std::vector<double>().swap(column.doubleStorage);
+
+        column.integers = column.integerStorage.data();
+        column.doubles = column.doubleStorage.data();
+    });
+
+    typedColumns = std::move(columns);
+}
+
+
+CSVTable::ColumnType CSVTable::getColumnType(const int col) const
+{
+    if(col < 0 || col >= int(typedColumns.size()))
+        return ColumnType::Text;
+
+    return typedColumns[col].type;
+}
+
+
+bool CSVTable::hasColumnTypes(void) const
+{
+    return !typedColumns.empty();
+}
+
+
+const double* CSVTable::getDoubleData(const int col) const
+{
+    if(this->getColumnType(col) != ColumnType::Double)
+        return nullptr;
+
+    return typedColumns[col].doubles;
+}
+
+
+const qint64* CSVTable::getInt64Data(const int col) const
+{
+    if(this->getColumnType(col) != ColumnType::Integer)
+        return nullptr;
+
+    return typedColumns[col].integers;
+}
+
+
+void CSVTable::tokenize(const bool parallel)
+{
+    qint64 start = 0;
+
+    // Skip the UTF-8 byte order mark
+    if(fileSize >= 3 && uchar(fileData[0]) == 0xEF && uchar(fileData[1]) == 0xBB && uchar(fileData[2]) == 0xBF)
+        start = 3;
+
+    auto numThreads = QThread::idealThreadCount();
+
+    // Small files are not worth the overhead of splitting up
+    if(!parallel || numThreads < 2 || fileSize - start < 2*minChunkSize)
+    {
+        rowCells.push_back(0);
+        tokenizeRows(fileData, start, fileSize, fileSize, rowStarts, rowCells, cellStarts);
+        return;
+    }
+
+    this->tokenizeParallel(start, numThreads);
+}
+
+
+void CSVTable::tokenizeRows(const char* data, const qint64 begin, const qint64 end, const qint64 numBytes,
+                            std::vector<qint64>& rowStarts, std::vector<quint64>& rowCells, std::vector<quint32>& cellStarts)
+{
+    // Only the rows that start before the end are tokenized, the last row is followed past the end until it is complete
+    if(begin >= end)
+        return;
+
+    qint64 rowStart = begin;
+
+    rowStarts.push_back(rowStart);
+    cellStarts.push_back(0);
+
+    // Rows always start outside of quotes
+    CSVScanner scanner(data, begin, numBytes);
+
+    for(qint64 pos = scanner.next(); pos != -1; pos = scanner.next())
+    {
+        // The start of the next cell, or one past the end of the last cell in the row
+        cellStarts.push_back(quint32(pos + 1 - rowStart));
+
+        if(data[pos] == ',')
+            continue;
+
+        rowCells.push_back(cellStarts.size());
+
+        // Skip over the newline
+        rowStart = pos + 1;
+
+        if(rowStart >= end)
+            return;
+
+        rowStarts.push_back(rowStart);
+        cellStarts.push_back(0);
+    }
+
+    // The last row in the file does not end with a newline
+    cellStarts.push_back(quint32(numBytes + 1 - rowStart));
+    rowCells.push_back(cellStarts.size());
+}
+
+
+void CSVTable::tokenizeParallel(const qint64 start, const int numThreads)
+{
+    struct Chunk
+    {
+        // The nominal byte range of the chunk, a row belongs to the chunk where it starts
+        qint64 begin = 0;
+        qint64 end = 0;
+
+        // Whether the chunk begins within a quoted cell
+        bool startsInQuotes = false;
+
+        qint64 numQuotes = 0;
+
+        std::vector<qint64> rowStarts;
+        std::vector<quint64> rowCells;
+        std::vector<quint32> cellStarts;
+
+        // Where the results of this chunk go in the stitched arrays
+        size_t rowOffset = 0;
+        size_t cellOffset = 0;
+    };
+
+    const char* data = fileData;
+    const qint64 numBytes = fileSize;
+
+    // Use a few chunks per thread so that the work stays balanced when the rows vary in length
+    auto numChunks = qMax(qint64(1), qMin(qint64(numThreads)*4, (numBytes - start)/minChunkSize));
+    auto chunkSize = (numBytes - start + numChunks - 1)/numChunks;
+
+    QVector<Chunk> chunks(static_cast<int>(numChunks));
+
+    for(int i = 0; i<chunks.size(); ++i)
+    {
+        chunks[i].begin = qMin(start + i*chunkSize, numBytes);
+        chunks[i].end = qMin(start + (i+1)*chunkSize, numBytes);
+    }
+
+    // First pass, count the quotes in each chunk
+    QtConcurrent::blockingMap(chunks, [data](Chunk& chunk)
+    {
+        chunk.numQuotes = std::count(data + chunk.begin, data + chunk.end, '"');
+    });
+
+    // The parity of the quotes in all of the preceding chunks gives the quote state at the start of each chunk
+    qint64 numQuotes = 0;
+    for(auto&& chunk : chunks)
+    {
+        chunk.startsInQuotes = (numQuotes % 2) != 0;
+        numQuotes += chunk.numQuotes;
+    }
+
+    // Second pass, each chunk finds its first row and tokenizes the rows that start within it
+    QtConcurrent::blockingMap(chunks, [data, numBytes, start](Chunk& chunk)
+    {
+        qint64 firstRow = chunk.begin;
+
+        if(chunk.begin != start)
+        {
+            // A row starts at the beginning of the chunk only if the previous character is a newline outside of quotes
+            if(chunk.startsInQuotes || data[chunk.begin-1] != '\n')
+            {
+                bool inQuotes = chunk.startsInQuotes;
+
+                for(; firstRow < numBytes; ++firstRow)
+                {
+                    const char c = data[firstRow];
+
+                    if(c == '"')
+                        inQuotes = !inQuotes;
+                    else if(c == '\n' && !inQuotes)
+                        break;
+                }
+
+                ++firstRow;
+            }
+        }
+
+        // Rough guess of the memory needed assuming rows of around 100 bytes
+        chunk.rowStarts.reserve((chunk.end - chunk.begin)/100);
+        chunk.rowCells.reserve((chunk.end - chunk.begin)/100);
+
+        tokenizeRows(data, firstRow, chunk.end, numBytes, chunk.rowStarts, chunk.rowCells, chunk.cellStarts);
+    });
+
+    // Stitch the chunks back together in order
+    size_t totalRows = 0;
+    size_t totalCells = 0;
+    for(auto&& chunk : chunks)
+    {
+        chunk.rowOffset = totalRows;
+        chunk.cellOffset = totalCells;
+
+        totalRows += chunk.rowStarts.size();
+        totalCells += chunk.cellStarts.size();
+    }
+
+    rowStarts.resize(totalRows);
+    rowCells.resize(totalRows + 1);
+    cellStarts.resize(totalCells);
+
+    rowCells[0] = 0;
+
+    QtConcurrent::blockingMap(chunks, [this](Chunk& chunk)
+    {
+        std::copy(chunk.rowStarts.begin(), chunk.rowStarts.end(), rowStarts.begin() + chunk.rowOffset);
+        std::copy(chunk.cellStarts.begin(), chunk.cellStarts.end(), cellStarts.begin() + chunk.cellOffset);
+
+        // The cell indexes are relative to the chunk
+        for(size_t i = 0; i<chunk.rowCells.size(); ++i)
+            rowCells[chunk.rowOffset + i + 1] = chunk.rowCells[i] + chunk.cellOffset;
+
+        std::vector<qint64>().swap(chunk.rowStarts);
+        std::vector<quint64>().swap(chunk.rowCells);
+        std::vector<quint32>().swap(chunk.cellStarts);
+    });
+}
+
+
+void CSVTable::clear(void)
+{
+    theFile.reset();
+    fileBuffer.clear();
+    fileData = nullptr;
+    fileSize = 0;
+
+    // Swap with empty vectors to release the memory
+    std::vector<qint64>().swap(rowStarts);
+    std::vector<quint64>().swap(rowCells);
+    std::vector<quint32>().swap(cellStarts);
+
+    rowStartData = nullptr;
+    rowCellData = nullptr;
+    cellStartData = nullptr;
+    numRows = 0;
+
+    cacheFile.reset();
+    typedColumns.clear();
+}
+
+
+bool CSVTable::isEmpty(void) const
+{
+    return numRows == 0;
+}
+
+
+int CSVTable::rowCount(void) const
+{
+    return numRows;
+}
+
+
+int CSVTable::columnCount(const int row) const
+{
+    if(row < 0 || row >= this->rowCount())
+        return 0;
+
+    return static_cast<int>(rowCellData[row+1] - rowCellData[row] - 1);
+}
+
+
+CSVField CSVTable::at(const int row, const int col) const
+{
+    if(col < 0 || col >= this->columnCount(row))
+        return CSVField();
+
+    const auto cellIndex = rowCellData[row] + col;
+
+    const char* rowData = fileData + rowStartData[row];
+
+    return CSVField::fromCell(rowData + cellStartData[cellIndex], rowData + cellStartData[cellIndex+1] - 1);
+}
+
+
+QStringList CSVTable::getRow(const int row) const
+{
+    QStringList rowList;
+
+    auto numCols = this->columnCount(row);
+
+    rowList.reserve(numCols);
+
+    for(int i = 0; i<numCols; ++i)
+        rowList.append(this->at(row,i).toString());
+
+    return rowList;
+}
+
+
+int CSVTable::indexOfColumn(const QString& name, const int headerRow) const
+{
+    auto numCols = this->columnCount(headerRow);
+
+    const auto nameUtf8 = name.toUtf8();
+
+    for(int i = 0; i<numCols; ++i)
+    {
+        if(this->at(headerRow,i) == nameUtf8.constData())
+            return i;
+    }
+
+    return -1;
+}
+
+
+QVector<CSVField> CSVTable::getColumn(const int col, const int firstRow) const
+{
+    QVector<CSVField> column;
+
+    auto numRows = this->rowCount();
+
+    if(firstRow >= numRows)
+        return column;
+
+    column.reserve(numRows - firstRow);
+
+    for(int i = firstRow; i<numRows; ++i)
+        column.push_back(this->at(i,col));
+
+    return column;
+}
+
+
+QVector<double> CSVTable::getDoubleColumn(const int col, const int firstRow, QString& err) const
+{
+    QVector<double> column;
+
+    auto numRows = this->rowCount();
+
+    if(firstRow >= numRows)
+        return column;
+
+    // The typed columns start at the row after the header
+    if(firstRow >= 1 && this->getColumnType(col) != ColumnType::Text)
+    {
+        const auto& typedColumn = typedColumns[col];
+
+        if(typedColumn.type == ColumnType::Double)
+            column = QVector<double>(typedColumn.doubles + firstRow - 1, typedColumn.doubles + numRows - 1);
+        else
+            column = QVector<double>(typedColumn.integers + firstRow - 1, typedColumn.integers + numRows - 1);
+
+        return column;
+    }
+
+    column.reserve(numRows - firstRow);
+
+    for(int i = firstRow; i<numRows; ++i)
+    {
+        if(col >= this->columnCount(i))
+        {
+            err = "Row " + QString::number(i+1) + " does not have a column " + QString::number(col+1);
+            return QVector<double>();
+        }
+
+        auto field = this->at(i,col);
+
+        if(field.isEmpty())
+        {
+            column.push_back(0.0);
+            continue;
+        }
+
+        bool OK = false;
+        auto val = field.toDouble(&OK);
+
+        if(!OK)
+        {
+            err = "Could not convert the value " + field.toString() + " in row " + QString::number(i+1) + " to a number";
+            return QVector<double>();
+        }
+
+        column.push_back(val);
+    }
+
+    return column;
+}
+
+
+QVector<qint64> CSVTable::getInt64Column(const int col, const int firstRow, QString& err) const
+{
+    QVector<qint64> column;
+
+    auto numRows = this->rowCount();
+
+    if(firstRow >= numRows)
+        return column;
+
+    if(firstRow >= 1 && this->getColumnType(col) == ColumnType::Integer)
+    {
+        const auto& typedColumn = typedColumns[col];
+
+        column = QVector<qint64>(typedColumn.integers + firstRow - 1, typedColumn.integers + numRows - 1);
+
+        return column;
+    }
+
+    column.reserve(numRows - firstRow);
+
+    for(int i = firstRow; i<numRows; ++i)
+    {
+        if(col >= this->columnCount(i))
+        {
+            err = "Row " + QString::number(i+1) + " does not have a column " + QString::number(col+1);
+            return QVector<qint64>();
+        }
+
+        auto field = this->at(i,col);
+
+        if(field.isEmpty())
+        {
+            column.push_back(0);
+            continue;
+        }
+
+        bool OK = false;
+        auto val = field.toLongLong(&OK);
+
+        if(!OK)
+        {
+            err = "Could not convert the value " + field.toString() + " in row " + QString::number(i+1) + " to an integer";
+            return QVector<qint64>();
+        }
+
+        column.push_back(val);
+    }
+
+    return column;
+}
@@ -0,0 +1,229 @@
+#ifndef CSVTABLE_H
+#define CSVTABLE_H
+/* *****************************************************************************
+Copyright (c) 2016-2021, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+// Written by: Stevan Gavrilovic
+
+// A CSV file that is memory mapped and tokenized in place. Only the byte offsets of the cells are stored, the cell contents are returned as
+// lightweight views into the mapped file and are only converted to strings or numbers when they are accessed
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+#include <memory>
+#include <vector>
+
+class QFile;
+
+// View of a single cell in the mapped file, it is only valid while the CSVTable it came from is alive
+class CSVField
+{
+public:
+    CSVField() = default;
+    CSVField(const char* data, int size, bool quoted) : ptr(data), len(size), isQuoted(quoted) {}
+
+    // Creates the field from the raw bytes of a cell, i.e., the bytes between the separators, removing the whitespace and surrounding quotes
+    static CSVField fromCell(const char* begin, const char* end);
+
+    // The raw bytes of the cell, without the surrounding quotes and whitespace
+    const char* data(void) const { return ptr; }
+    int size(void) const { return len; }
+    bool isEmpty(void) const { return len == 0; }
+
+    // Empty cells are treated as null values, as with the strings returned by toString()
+    bool isNull(void) const { return len == 0; }
+
+    // Returns the cell as a string, any escaped double quotes "" within a quoted cell are collapsed to a single quote
+    QString toString(void) const;
+
+    // Parses the cell as a number, ok is set to false if the cell is not a valid number
+    double toDouble(bool* ok = nullptr) const;
+    qint64 toLongLong(bool* ok = nullptr) const;
+    int toInt(bool* ok = nullptr) const;
+
+    bool operator==(const CSVField& other) const;
+    bool operator!=(const CSVField& other) const { return !(*this == other); }
+
+    bool operator==(const char* str) const;
+    bool operator!=(const char* str) const { return !(*this == str); }
+
+private:
+    const char* ptr = nullptr;
+    int len = 0;
+    bool isQuoted = false;
+};
+
+
+class CSVTable
+{
+public:
+    CSVTable();
+    ~CSVTable();
+
+    CSVTable(CSVTable&& other);
+    CSVTable& operator=(CSVTable&& other);
+
+    CSVTable(const CSVTable&) = delete;
+    CSVTable& operator=(const CSVTable&) = delete;
+
+    // The type of a column, determined from all of its cells below the header row
+    enum class ColumnType : quint8 { Text = 0, Integer = 1, Double = 2 };
+
+    // Maps the file and finds the cell boundaries, returns 0 on success
+    // If parallel is true, the file is split into chunks that are tokenized concurrently, the resulting table is identical to the serial one
+    // Files compressed with gzip or zstd are decompressed into memory first
+    // If useCache is true, the cell boundaries and the typed columns are read from a binary cache of the file, when one exists and the
+    // file has not changed since it was made. Otherwise, the file is tokenized, the column types are found, and the cache is written for next time
+    int load(const QString& pathToFile, QString& err, const bool parallel = false, const bool useCache = false);
+
+    void clear(void);
+
+    bool isEmpty(void) const;
+
+    int rowCount(void) const;
+
+    // The number of cells in the given row, the rows of a CSV file are not required to have the same number of cells
+    int columnCount(const int row = 0) const;
+
+    // Returns the cell at the given row and column, an empty field is returned if the cell does not exist
+    CSVField at(const int row, const int col) const;
+
+    // Returns the row as a string list, for callers that need to keep a copy of the row
+    QStringList getRow(const int row) const;
+
+    // Returns the index of the column whose cell in the header row matches the given name, or -1 if it is not found
+    int indexOfColumn(const QString& name, const int headerRow = 0) const;
+
+    // Returns a column as views or as typed arrays, starting at the row firstRow
+    // For the typed columns, empty cells are given a value of zero and err is set if a cell cannot be converted
+    QVector<CSVField> getColumn(const int col, const int firstRow = 0) const;
+    QVector<double> getDoubleColumn(const int col, const int firstRow, QString& err) const;
+    QVector<qint64> getInt64Column(const int col, const int firstRow, QString& err) const;
+
+    // Finds the types of the columns in the header row, assuming that the first row is the header
+    // This is done when the cache is written, otherwise every column is text until this is called
+    void findColumnTypes(void);
+
+    ColumnType getColumnType(const int col) const;
+
+    // Returns true once the column types are found, either by findColumnTypes() or from the cache
+    bool hasColumnTypes(void) const;
+
+    // The values of a double or an integer column in place, one for each row below the header, or nullptr if the column is not of that type
+    // Empty cells have a value of zero, as in the typed columns above. The values are valid while the table is alive
+    const double* getDoubleData(const int col) const;
+    const qint64* getInt64Data(const int col) const;
+
+    // Returns the path to the binary cache of the given CSV file
+    static QString getCachePath(const QString& pathToFile);
+
+    // A hash of the contents of the loaded file, for checking the caches that are made from it. Large files are hashed from evenly spaced
+    // samples so that checking a cache stays fast
+    QByteArray getContentHash(void) const;
+
+private:
+
+    // A column of numbers for the rows below the header, the values are either owned by the table or point into the mapped cache
+    struct TypedColumn
+    {
+        ColumnType type = ColumnType::Text;
+
+        const double* doubles = nullptr;
+        const qint64* integers = nullptr;
+
+        std::vector<double> doubleStorage;
+        std::vector<qint64> integerStorage;
+    };
+
+    // Tokenizes the file once it is mapped or read into memory, and writes the cache if useCache is true
+    int tokenizeLoadedFile(const QString& pathToFile, QString& err, const bool parallel, const bool useCache);
+
+    // Points the index arrays at the vectors filled in by the tokenizer
+    void setIndexData(void);
+
+    // Returns 0 if the cache exists and is valid for the mapped file
+    int loadCache(const QString& pathToFile);
+    int saveCache(const QString& pathToFile, QString& err) const;
+
+    void tokenize(const bool parallel);
+
+    void tokenizeParallel(const qint64 start, const int numThreads);
+
+    // Tokenizes the rows that start in the range [begin, end) and appends them to the given arrays
+    static void tokenizeRows(const char* data, const qint64 begin, const qint64 end, const qint64 numBytes,
+                             std::vector<qint64>& rowStarts, std::vector<quint64>& rowCells, std::vector<quint32>& cellStarts);
+
+    // Files are not split into chunks smaller than this
+    static constexpr qint64 minChunkSize = 1 << 20;
+
+    // Files larger than this are hashed from samples rather than in full
+    static constexpr qint64 maxFullHashSize = 1 << 24;
+    static constexpr qint64 hashSampleSize = 1 << 16;
+    static constexpr int numHashSamples = 64;
+
+    std::unique_ptr<QFile> theFile;
+
+    // Holds the data if the file could not be mapped
+    QByteArray fileBuffer;
+
+    const char* fileData = nullptr;
+    qint64 fileSize = 0;
+
+    // The offset of the first byte of each row in the file
+    std::vector<qint64> rowStarts;
+
+    // Index into cellStarts of the first cell of each row, the extra entry at the end marks the end of the last row
+    std::vector<quint64> rowCells;
+
+    // Offset of each cell relative to the start of its row. Each row has an additional entry one past the end of its last cell, so that a
+    // cell always ends one byte before the start of the next entry, i.e., at the comma or the newline
+    std::vector<quint32> cellStarts;
+
+    // The arrays that are used to access the cells, they point either to the vectors above or into the mapped cache
+    const qint64* rowStartData = nullptr;
+    const quint64* rowCellData = nullptr;
+    const quint32* cellStartData = nullptr;
+    int numRows = 0;
+
+    // The mapped cache file, if the table was loaded from the cache
+    std::unique_ptr<QFile> cacheFile;
+
+    std::vector<TypedColumn> typedColumns;
+};
+
+#endif // CSVTABLE_H
@@ -38,51 +38,451 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 
 #include "ComponentDatabase.h"
 
-ComponentDatabase::ComponentDatabase()
+#include <QDebug>
+#include <QLocale>
+#include <QVector>
+#include <QtConcurrent/QtConcurrentMap>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+const double nullNumber = std::numeric_limits<double>::quiet_NaN();
+
+const RTree::Box nullBox = {nullNumber, nullNumber, nullNumber, nullNumber};
+
+// The number of components that are checked against the polygon in each task
+const int polygonChunkSize = 4096;
+
+// Where a bounding box is with respect to a polygon
+enum BoxPosition : quint8
+{
+    BoxOutside,
+    BoxInside,
+    BoxOnBoundary
+};
+
+// Returns true if the segment touches the box, by clipping the segment to the box
+bool segmentIntersectsBox(const double x1, const double y1, const double x2, const double y2, const RTree::Box& box)
+{
+    double tMin = 0.0;
+    double tMax = 1.0;
+
+    const double dx = x2 - x1;
+    const double dy = y2 - y1;
+
+    auto clip = [&](const double p, const double q)
+    {
+        if(p == 0.0)
+            return q >= 0.0;
+
+        const double t = q/p;
+
+        if(p < 0.0)
+            tMin = qMax(tMin, t);
+        else
+            tMax = qMin(tMax, t);
+
+        return tMin <= tMax;
+    };
+
+    return clip(-dx, x1 - box.xMin) && clip(dx, box.xMax - x1) && clip(-dy, y1 - box.yMin) && clip(dy, box.yMax - y1);
+}
+
+// Returns true if the point is inside the polygon by the even-odd rule, so that the holes are outside
+bool pointInPolygon(const double x, const double y, const std::vector<double>& coordinates, const std::vector<int>& partStarts)
+{
+    bool inside = false;
+
+    for(size_t part = 0; part + 1 < partStarts.size(); ++part)
+    {
+        const int first = partStarts[part];
+        const int last = partStarts[part+1];
+
+        for(int i = first, j = last - 1; i < last; j = i++)
+        {
+            const double xi = coordinates[2*i];
+            const double yi = coordinates[2*i+1];
+            const double xj = coordinates[2*j];
+            const double yj = coordinates[2*j+1];
+
+            if((yi > y) != (yj > y) && x < (xj - xi)*(y - yi)/(yj - yi) + xi)
+                inside = !inside;
+        }
+    }
+
+    return inside;
+}
+
+// If no edge of the polygon touches the box then the box is either all inside or all outside, which is the same as for its center
+BoxPosition getBoxPosition(const RTree::Box& box, const std::vector<double>& coordinates, const std::vector<int>& partStarts)
+{
+    for(size_t part = 0; part + 1 < partStarts.size(); ++part)
+    {
+        const int first = partStarts[part];
+        const int last = partStarts[part+1];
+
+        for(int i = first, j = last - 1; i < last; j = i++)
+        {
+            const double xi = coordinates[2*i];
+            const double yi = coordinates[2*i+1];
+            const double xj = coordinates[2*j];
+            const double yj = coordinates[2*j+1];
+
+            // Quick check on the bounds of the edge
+            if(qMax(xi, xj) < box.xMin || qMin(xi, xj) > box.xMax || qMax(yi, yj) < box.yMin || qMin(yi, yj) > box.yMax)
+                continue;
+
+            if(segmentIntersectsBox(xi, yi, xj, yj, box))
+                return BoxOnBoundary;
+        }
+    }
+
+    return pointInPolygon(0.5*(box.xMin + box.xMax), 0.5*(box.yMin + box.yMax), coordinates, partStarts) ? BoxInside : BoxOutside;
+}
+
+}
+
+
+Component::Component(ComponentDatabase* database, const int row) : theDatabase(database), row(row)
+{
+
+}
+
+
+void Component::addResult(const QString& key, const double res)
+{
+    if(!this->exists())
+        return;
+
+    theDatabase->addResult(row, key, res);
+}
+
+
+QVariant Component::getAttributeValue(const QString& key, const QVariant& defaultValue) const
+{
+    if(!this->exists())
+        return defaultValue;
+
+    auto col = theDatabase->getAttributeIndex(key);
+
+    if(col == -1)
+        return defaultValue;
+
+    return theDatabase->getAttributeValue(row, col);
+}
+
+
+double Component::getResultValue(const QString& key) const
+{
+    if(!this->exists())
+        return 0.0;
+
+    return theDatabase->getResultValue(row, key);
+}
+
+
+int Component::setAttributeValue(const QString& attribute, const QVariant& value)
+{
+    if(!this->exists())
+        return -1;
+
+    theDatabase->setAttributeValue(row, attribute, value);
+
+    auto feature = theDatabase->getFeature(row);
+
+    if(feature != nullptr)
+    {
+        feature->attributes()->replaceAttribute(attribute,value);
+        feature->featureTable()->updateFeature(feature);
+
+        if(feature->attributes()->attributeValue(attribute).isNull())
+        {
+            qDebug()<<"Failed to update feature "<<attribute<<" in component "<<this->getID();
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+
+QMap<QString, QVariant> Component::getAttributes(void) const
+{
+    QMap<QString, QVariant> attributes;
+
+    if(!this->exists())
+        return attributes;
+
+    auto names = theDatabase->getAttributeNames();
+
+    for(int i = 0; i<names.size(); ++i)
+        attributes.insert(names.at(i), theDatabase->getAttributeValue(row, i));
+
+    return attributes;
+}
+
+
+bool Component::isValid(void) const
+{
+    if(!this->exists() || theDatabase->getFeature(row) == nullptr || theDatabase->getAttributeNames().empty())
+        return false;
+
+    return true;
+}
+
+
+bool Component::exists(void) const
+{
+    return theDatabase != nullptr && row != -1;
+}
+
+
+int Component::getID(void) const
+{
+    if(!this->exists())
+        return -1;
+
+    return theDatabase->getID(row);
+}
+
+
+QString Component::getUID(void) const
+{
+    if(!this->exists())
+        return "NULL";
+
+    return theDatabase->getUID(row);
+}
+
+
+Esri::ArcGISRuntime::Feature* Component::getFeature(void) const
 {
+    if(!this->exists())
+        return nullptr;
 
+    return theDatabase->getFeature(row);
 }
 
 
-int ComponentDatabase::getNumberOfComponents()
+ComponentDatabase::ComponentDatabase()
 {
-    return ComponentMap.size();
+
 }
 
 
-void ComponentDatabase::addComponent(int ID, Component& asset)
+int ComponentDatabase::getNumberOfComponents() const
 {
-    ComponentMap.insert(ID, asset);
+    return numRows;
 }
 
 
-Component& ComponentDatabase::getComponent(const int ID)
+int ComponentDatabase::addComponent(const int ID, const QString& UID, Esri::ArcGISRuntime::Feature* feature, const QMap<QString, QVariant>& attributes)
 {
-    return ComponentMap[ID];
+    auto row = this->getRow(ID);
+
+    if(row == -1)
+    {
+        row = numRows;
+
+        this->indexID(ID, row);
+
+        ++numRows;
+
+        componentIDs.push_back(ID);
+        componentUIDs.push_back(UID);
+        componentFeatures.push_back(feature);
+        componentBounds.push_back(nullBox);
+
+        // The unique id can be set later if the component does not have one yet
+        if(!UID.isEmpty())
+            rowsByUID.insert(UID, row);
+
+        // New rows start out null in every column
+        for(auto&& column : attributeColumns)
+        {
+            if(column.isText)
+            {
+                column.stringIndexes.push_back(0);
+            }
+            else
+            {
+                column.numbers.push_back(nullNumber);
+
+                if(column.isInteger)
+                    column.integers.push_back(0);
+            }
+        }
+
+        for(auto&& column : resultColumns)
+            column.push_back(nullNumber);
+    }
+    else
+    {
+        this->setUID(row, UID);
+
+        componentFeatures[row] = feature;
+        componentBounds[row] = nullBox;
+
+        for(auto&& column : attributeColumns)
+            this->setValue(column, row, QVariant());
+    }
+
+    spatialIndexIsValid = false;
+
+    if(!searchIndexes.isEmpty())
+        searchIndexes.clear();
+
+    for(auto it = attributes.begin(); it != attributes.end(); ++it)
+    {
+        auto col = this->addAttribute(it.key());
+
+        this->setValue(attributeColumns[col], row, it.value());
+    }
+
+    return row;
 }
 
 
-Component ComponentDatabase::getComponent(const QString UID)
+int ComponentDatabase::appendComponents(const ComponentBlock& block, QString& err)
 {
-    for(auto&& it: ComponentMap)
+    const int numNew = int(block.IDs.size());
+
+    if(block.columns.size() != size_t(block.attributeNames.size()))
+    {
+        err = "The number of attribute columns does not match the number of attribute names";
+        return -1;
+    }
+
+    for(auto&& column : block.columns)
+    {
+        if((column.isText ? column.stringIndexes.size() : column.numbers.size()) != size_t(numNew) ||
+                (!column.isText && column.isInteger && column.integers.size() != size_t(numNew)))
+        {
+            err = "The number of attribute values does not match the number of components";
+            return -1;
+        }
+    }
+
+    for(auto&& ID : block.IDs)
+    {
+        if(this->getRow(ID) != -1)
+        {
+            err = "The component with the ID " + QString::number(ID) + " is already in the database";
+            return -1;
+        }
+    }
+
+    // The column of the block that goes into each column of the database, if the same name is given more than once the last one is used
+    std::vector<const AttributeColumn*> blockColumns;
+
+    for(int j = 0; j<block.attributeNames.size(); ++j)
+    {
+        auto col = this->addAttribute(block.attributeNames.at(j));
+
+        if(col >= int(blockColumns.size()))
+            blockColumns.resize(col + 1, nullptr);
+
+        blockColumns[col] = &block.columns[j];
+    }
+
+    blockColumns.resize(attributeColumns.size(), nullptr);
+
+    for(size_t col = 0; col<attributeColumns.size(); ++col)
+        this->appendColumn(attributeColumns[col], blockColumns[col], numNew);
+
+    for(auto&& column : resultColumns)
+        column.resize(column.size() + numNew, nullNumber);
+
+    const int firstRow = numRows;
+
+    componentIDs.reserve(numRows + numNew);
+
+    for(int i = 0; i<numNew; ++i)
     {
-        if(it.UID.compare(UID) == 0)
-            return it;
+        this->indexID(block.IDs[i], numRows);
+        ++numRows;
+
+        componentIDs.push_back(block.IDs[i]);
     }
 
-    return Component();
+    componentUIDs.resize(numRows);
+    componentFeatures.resize(numRows, nullptr);
+    componentBounds.resize(numRows, nullBox);
+
+    spatialIndexIsValid = false;
+
+    if(!searchIndexes.isEmpty())
+        searchIndexes.clear();
+
+    return firstRow;
+}
+
+
+Component ComponentDatabase::getComponent(const int ID)
+{
+    auto row = this->getRow(ID);
+
+    if(row == -1)
+        return Component();
+
+    return Component(this, row);
+}
+
+
+Component ComponentDatabase::getComponent(const QString& UID)
+{
+    auto row = rowsByUID.value(UID, -1);
+
+    if(row == -1)
+        return Component();
+
+    return Component(this, row);
 }
 
 
 void ComponentDatabase::clear(void)
 {
-    ComponentMap.clear();
+    attributeNames.clear();
+    attributeIndexes.clear();
+    std::vector<AttributeColumn>().swap(attributeColumns);
+
+    resultNames.clear();
+    resultIndexes.clear();
+    std::vector<std::vector<double>>().swap(resultColumns);
+
+    std::vector<int>().swap(componentIDs);
+    std::vector<QString>().swap(componentUIDs);
+    std::vector<Esri::ArcGISRuntime::Feature*>().swap(componentFeatures);
+
+    minID = 0;
+    std::vector<int>().swap(rowsByID);
+    rowsByIDHash.clear();
+    useIDHash = false;
+
+    rowsByUID.clear();
+
+    std::vector<RTree::Box>().swap(componentBounds);
+    spatialIndex.clear();
+    spatialIndexIsValid = false;
+
+    searchIndexes.clear();
+
+    numRows = 0;
+}
+
+
+QStringList ComponentDatabase::getAttributeNames(void) const
+{
+    return attributeNames;
 }
 
 
-QMap<int, Component> ComponentDatabase::getComponentsMap() const
+int ComponentDatabase::getAttributeIndex(const QString& attribute) const
 {
-    return ComponentMap;
+    return attributeIndexes.value(attribute, -1);
 }
 
 
@@ -90,5 +490,897 @@ void ComponentDatabase::updateComponentAttribute(const int ID, const QString& at
 {
     auto component = this->getComponent(ID);
 
-   component.setAttributeValue(attribute,value);
+    component.setAttributeValue(attribute,value);
+}
+
+
+int ComponentDatabase::updateComponentAttributes(const QString& attribute, const QVector<int>& IDs, const QVector<QVariant>& values)
+{
+    if(IDs.size() != values.size())
+    {
+        qDebug()<<"The number of IDs and values do not match when updating the attribute "<<attribute;
+        return -1;
+    }
+
+    auto col = this->addAttribute(attribute);
+
+    auto& column = attributeColumns[col];
+
+    // The features to update grouped by their table
+    QHash<Esri::ArcGISRuntime::FeatureTable*, QList<Esri::ArcGISRuntime::Feature*>> featuresByTable;
+
+    int numMissing = 0;
+
+    for(int i = 0; i<IDs.size(); ++i)
+    {
+        auto row = this->getRow(IDs.at(i));
+
+        if(row == -1)
+        {
+            ++numMissing;
+            continue;
+        }
+
+        this->setValue(column, row, values.at(i));
+
+        auto feature = componentFeatures[row];
+
+        if(feature == nullptr)
+            continue;
+
+        feature->attributes()->replaceAttribute(attribute,values.at(i));
+
+        featuresByTable[feature->featureTable()].append(feature);
+    }
+
+    for(auto it = featuresByTable.begin(); it != featuresByTable.end(); ++it)
+        it.key()->updateFeatures(it.value());
+
+    if(numMissing != 0)
+    {
+        qDebug()<<"Could not find "<<numMissing<<" of the components when updating the attribute "<<attribute;
+        return -1;
+    }
+
+    return 0;
+}
+
+
+void ComponentDatabase::forEach(const std::function<bool(Component& component)>& visitor)
+{
+    for(int i = 0; i<numRows; ++i)
+    {
+        Component component(this, i);
+
+        if(!visitor(component))
+            return;
+    }
+}
+
+
+void ComponentDatabase::forEachInRange(const int firstID, const int lastID, const std::function<bool(Component& component)>& visitor)
+{
+    if(lastID < firstID)
+        return;
+
+    if(useIDHash)
+    {
+        // Look up each ID in the range if there are fewer of them than components, otherwise pick out the components in the range
+        std::vector<std::pair<int, int>> IDsAndRows;
+
+        if(qint64(lastID) - firstID < numRows)
+        {
+            for(qint64 ID = firstID; ID <= lastID; ++ID)
+            {
+                auto row = rowsByIDHash.value(int(ID), -1);
+
+                if(row != -1)
+                    IDsAndRows.emplace_back(int(ID), row);
+            }
+        }
+        else
+        {
+            for(auto it = rowsByIDHash.constBegin(); it != rowsByIDHash.constEnd(); ++it)
+            {
+                if(it.key() >= firstID && it.key() <= lastID)
+                    IDsAndRows.emplace_back(it.key(), it.value());
+            }
+
+            std::sort(IDsAndRows.begin(), IDsAndRows.end());
+        }
+
+        for(auto&& it : IDsAndRows)
+        {
+            Component component(this, it.second);
+
+            if(!visitor(component))
+                return;
+        }
+
+        return;
+    }
+
+    if(rowsByID.empty())
+        return;
+
+    // Clamp the range to the IDs in the index
+    const qint64 firstOffset = qMax(qint64(0), qint64(firstID) - minID);
+    const qint64 lastOffset = qMin(qint64(rowsByID.size()) - 1, qint64(lastID) - minID);
+
+    for(qint64 offset = firstOffset; offset <= lastOffset; ++offset)
+    {
+        auto row = rowsByID[offset];
+
+        if(row == -1)
+            continue;
+
+        Component component(this, row);
+
+        if(!visitor(component))
+            return;
+    }
+}
+
+
+void ComponentDatabase::forEachSelected(const IntervalSet& IDs, const std::function<bool(Component& component)>& visitor)
+{
+    bool stopped = false;
+
+    auto visitUntilStopped = [&](Component& component)
+    {
+        stopped = !visitor(component);
+        return !stopped;
+    };
+
+    // Each range of IDs is a contiguous run in the ID index
+    for(auto&& interval : IDs.getIntervals())
+    {
+        this->forEachInRange(interval.first, interval.last, visitUntilStopped);
+
+        if(stopped)
+            return;
+    }
+}
+
+
+const std::vector<int>& ComponentDatabase::getComponentIDs(void) const
+{
+    return componentIDs;
+}
+
+
+const std::vector<double>* ComponentDatabase::getNumberColumn(const int col) const
+{
+    if(col < 0 || col >= int(attributeColumns.size()) || attributeColumns[col].isText)
+        return nullptr;
+
+    return &attributeColumns[col].numbers;
+}
+
+
+const std::vector<quint32>* ComponentDatabase::getStringIndexColumn(const int col) const
+{
+    if(col < 0 || col >= int(attributeColumns.size()) || !attributeColumns[col].isText)
+        return nullptr;
+
+    return &attributeColumns[col].stringIndexes;
+}
+
+
+const QStringList* ComponentDatabase::getColumnStrings(const int col) const
+{
+    if(col < 0 || col >= int(attributeColumns.size()) || !attributeColumns[col].isText)
+        return nullptr;
+
+    return &attributeColumns[col].strings;
+}
+
+
+int ComponentDatabase::getRow(const int ID) const
+{
+    if(useIDHash)
+        return rowsByIDHash.value(ID, -1);
+
+    const qint64 offset = qint64(ID) - minID;
+
+    if(offset < 0 || offset >= qint64(rowsByID.size()))
+        return -1;
+
+    return rowsByID[offset];
+}
+
+
+void ComponentDatabase::indexID(const int ID, const int row)
+{
+    if(useIDHash)
+    {
+        rowsByIDHash.insert(ID, row);
+        return;
+    }
+
+    if(rowsByID.empty())
+        minID = ID;
+
+    const qint64 firstID = qMin(minID, qint64(ID));
+    const qint64 lastID = qMax(minID + qint64(rowsByID.size()) - 1, qint64(ID));
+
+    // Move the index into the hash if the array would be mostly empty
+    if(lastID - firstID + 1 > maxIDArrayFactor*qint64(numRows + 1) + minIDArraySize)
+    {
+        rowsByIDHash.reserve(numRows + 1);
+
+        for(size_t offset = 0; offset<rowsByID.size(); ++offset)
+        {
+            if(rowsByID[offset] != -1)
+                rowsByIDHash.insert(int(minID + qint64(offset)), rowsByID[offset]);
+        }
+
+        std::vector<int>().swap(rowsByID);
+        minID = 0;
+        useIDHash = true;
+
+        rowsByIDHash.insert(ID, row);
+        return;
+    }
+
+    if(ID < minID)
+    {
+        // Grow the front by at least the size of the array, so that adding the IDs in decreasing order does not shift the array every time
+        qint64 growth = qMax(minID - ID, qint64(rowsByID.size()));
+        growth = qMin(growth, minID - qint64(std::numeric_limits<int>::min()));
+
+        rowsByID.insert(rowsByID.begin(), size_t(growth), -1);
+        minID -= growth;
+    }
+
+    const qint64 offset = qint64(ID) - minID;
+
+    if(offset >= qint64(rowsByID.size()))
+        rowsByID.resize(size_t(offset) + 1, -1);
+
+    rowsByID[offset] = row;
+}
+
+
+bool ComponentDatabase::isValidRow(const int row) const
+{
+    return row >= 0 && row < numRows;
+}
+
+
+int ComponentDatabase::getIDFromUID(const QString& UID) const
+{
+    auto row = rowsByUID.value(UID, -1);
+
+    if(row == -1)
+        return -1;
+
+    return componentIDs[row];
+}
+
+
+int ComponentDatabase::getID(const int row) const
+{
+    if(!this->isValidRow(row))
+        return -1;
+
+    return componentIDs[row];
+}
+
+
+QString ComponentDatabase::getUID(const int row) const
+{
+    if(!this->isValidRow(row))
+        return QString();
+
+    return componentUIDs[row];
+}
+
+
+Esri::ArcGISRuntime::Feature* ComponentDatabase::getFeature(const int row) const
+{
+    if(!this->isValidRow(row))
+        return nullptr;
+
+    return componentFeatures[row];
+}
+
+
+void ComponentDatabase::setUID(const int row, const QString& UID)
+{
+    if(!this->isValidRow(row))
+        return;
+
+    // Only remove the old unique id if it still points to this row
+    if(rowsByUID.value(componentUIDs[row], -1) == row)
+        rowsByUID.remove(componentUIDs[row]);
+
+    componentUIDs[row] = UID;
+
+    if(!UID.isEmpty())
+        rowsByUID.insert(UID, row);
+
+    if(!searchIndexes.isEmpty())
+        searchIndexes.remove("UID");
+}
+
+
+void ComponentDatabase::setFeature(const int row, Esri::ArcGISRuntime::Feature* feature)
+{
+    if(!this->isValidRow(row))
+        return;
+
+    componentFeatures[row] = feature;
+
+    // The bounds of a component without a bounding box come from its feature
+    if(!componentBounds[row].isValid())
+        spatialIndexIsValid = false;
+}
+
+
+void ComponentDatabase::setBounds(const int row, const RTree::Box& bounds)
+{
+    if(!this->isValidRow(row))
+        return;
+
+    componentBounds[row] = bounds;
+
+    spatialIndexIsValid = false;
+}
+
+
+const RTree& ComponentDatabase::getSpatialIndex(void)
+{
+    if(spatialIndexIsValid)
+        return spatialIndex;
+
+    for(int row = 0; row<numRows; ++row)
+    {
+        auto feature = componentFeatures[row];
+
+        if(componentBounds[row].isValid() || feature == nullptr)
+            continue;
+
+        auto extent = feature->geometry().extent();
+
+        if(!extent.isEmpty())
+            componentBounds[row] = {extent.xMin(), extent.yMin(), extent.xMax(), extent.yMax()};
+    }
+
+    spatialIndex.build(componentBounds);
+    spatialIndexIsValid = true;
+
+    return spatialIndex;
+}
+
+
+void ComponentDatabase::getComponentsInPolygon(const std::vector<double>& coordinates, const std::vector<int>& partStarts, IntervalSet& insideIDs, std::vector<int>& boundaryRows)
+{
+    const int numPoints = int(coordinates.size()/2);
+
+    if(numPoints == 0)
+        return;
+
+    RTree::Box polygonBounds = {coordinates[0], coordinates[1], coordinates[0], coordinates[1]};
+
+    for(int i = 1; i<numPoints; ++i)
+        polygonBounds.expand({coordinates[2*i], coordinates[2*i+1], coordinates[2*i], coordinates[2*i+1]});
+
+    // The index narrows the components down to those whose boxes overlap the bounds of the polygon
+    std::vector<int> candidateRows;
+
+    this->getSpatialIndex().search(polygonBounds, [&](int row, const RTree::Box& /*box*/)
+    {
+        candidateRows.push_back(row);
+    });
+
+    if(candidateRows.empty())
+        return;
+
+    // Sorted so that the IDs come out in order, which is the fast path of the interval set
+    std::sort(candidateRows.begin(), candidateRows.end());
+
+    const int numCandidates = int(candidateRows.size());
+
+    std::vector<quint8> positions(numCandidates, BoxOutside);
+
+    QVector<int> chunkStarts;
+    for(int i = 0; i<numCandidates; i += polygonChunkSize)
+        chunkStarts.push_back(i);
+
+    QtConcurrent::blockingMap(chunkStarts, [&](const int chunkStart)
+    {
+        const int chunkEnd = qMin(chunkStart + polygonChunkSize, numCandidates);
+
+        for(int i = chunkStart; i<chunkEnd; ++i)
+            positions[i] = getBoxPosition(componentBounds[candidateRows[i]], coordinates, partStarts);
+    });
+
+    for(int i = 0; i<numCandidates; ++i)
+    {
+        if(positions[i] == BoxInside)
+            insideIDs.insert(componentIDs[candidateRows[i]]);
+        else if(positions[i] == BoxOnBoundary)
+            boundaryRows.push_back(candidateRows[i]);
+    }
+}
+
+
+int ComponentDatabase::findComponents(const QString& attribute, const QString& text, std::vector<int>& rows, const int maxResults)
+{
+    auto it = searchIndexes.find(attribute);
+
+    if(it == searchIndexes.end())
+    {
+        AttributeIndex index;
+
+        if(!this->buildSearchIndex(attribute, index))
+            return 0;
+
+        it = searchIndexes.insert(attribute, std::move(index));
+    }
+
+    // The index orders the values as text, so the matches in a column of numbers are sorted by value, e.g., so that 9 comes before 10
+    auto col = this->getAttributeIndex(attribute);
+    auto numbers = this->getNumberColumn(col);
+
+    if(numbers != nullptr || (col == -1 && attribute == "ID"))
+    {
+        auto valueOf = [&](const int row)
+        {
+            return numbers != nullptr ? (*numbers)[row] : double(componentIDs[row]);
+        };
+
+        // Equal values stay in the order of the index
+        struct Match
+        {
+            double value;
+            int order;
+            int row;
+        };
+
+        auto isBefore = [](const Match& a, const Match& b)
+        {
+            return a.value < b.value || (a.value == b.value && a.order < b.order);
+        };
+
+        // Only the maxResults smallest values are kept, in a heap with the largest of them on top
+        std::vector<Match> matches;
+        int order = 0;
+
+        it->search(text, [&](int row)
+        {
+            const Match match{valueOf(row), order++, row};
+
+            if(maxResults < 0)
+            {
+                matches.push_back(match);
+            }
+            else if(int(matches.size()) < maxResults)
+            {
+                matches.push_back(match);
+                std::push_heap(matches.begin(), matches.end(), isBefore);
+            }
+            else if(maxResults > 0 && isBefore(match, matches.front()))
+            {
+                std::pop_heap(matches.begin(), matches.end(), isBefore);
+                matches.back() = match;
+                std::push_heap(matches.begin(), matches.end(), isBefore);
+            }
+
+            return true;
+        });
+
+        if(maxResults < 0)
+            std::sort(matches.begin(), matches.end(), isBefore);
+        else
+            std::sort_heap(matches.begin(), matches.end(), isBefore);
+
+        for(auto&& match : matches)
+            rows.push_back(match.row);
+
+        return int(matches.size());
+    }
+
+    int numFound = 0;
+
+    it->search(text, [&](int row)
+    {
+        if(maxResults >= 0 && numFound >= maxResults)
+            return false;
+
+        rows.push_back(row);
+        ++numFound;
+
+        return true;
+    });
+
+    return numFound;
+}
+
+
+bool ComponentDatabase::buildSearchIndex(const QString& attribute, AttributeIndex& index) const
+{
+    auto col = this->getAttributeIndex(attribute);
+
+    if(col != -1)
+    {
+        const auto& column = attributeColumns[col];
+
+        for(int row = 0; row<numRows; ++row)
+        {
+            // The numbers are searched as they are shown
+            index.addValue(this->getText(column, row), row);
+        }
+    }
+    else if(attribute == "ID")
+    {
+        for(int row = 0; row<numRows; ++row)
+            index.addValue(QString::number(componentIDs[row]), row);
+    }
+    else if(attribute == "UID")
+    {
+        for(int row = 0; row<numRows; ++row)
+            index.addValue(componentUIDs[row], row);
+    }
+    else
+    {
+        return false;
+    }
+
+    index.build();
+
+    return true;
+}
+
+
+QVariant ComponentDatabase::getAttributeValue(const int row, const int col) const
+{
+    if(!this->isValidRow(row) || col < 0 || col >= int(attributeColumns.size()))
+        return QVariant();
+
+    return this->getValue(attributeColumns[col], row);
+}
+
+
+void ComponentDatabase::setAttributeValue(const int row, const int col, const QVariant& value)
+{
+    if(!this->isValidRow(row) || col < 0 || col >= int(attributeColumns.size()))
+        return;
+
+    this->setValue(attributeColumns[col], row, value);
+}
+
+
+QString ComponentDatabase::getAttributeText(const int row, const int col) const
+{
+    if(!this->isValidRow(row) || col < 0 || col >= int(attributeColumns.size()))
+        return QString();
+
+    return this->getText(attributeColumns[col], row);
+}
+
+
+void ComponentDatabase::setAttributeValue(const int row, const QString& attribute, const QVariant& value)
+{
+    if(!this->isValidRow(row))
+        return;
+
+    auto col = this->addAttribute(attribute);
+
+    this->setValue(attributeColumns[col], row, value);
+}
+
+
+double ComponentDatabase::getResultValue(const int row, const QString& key) const
+{
+    auto col = resultIndexes.value(key, -1);
+
+    if(col == -1 || !this->isValidRow(row))
+        return 0.0;
+
+    auto val = resultColumns[col][row];
+
+    return std::isnan(val) ? 0.0 : val;
+}
+
+
+void ComponentDatabase::addResult(const int row, const QString& key, const double res)
+{
+    if(!this->isValidRow(row))
+        return;
+
+    auto col = resultIndexes.value(key, -1);
+
+    if(col == -1)
+    {
+        col = static_cast<int>(resultColumns.size());
+
+        resultNames.append(key);
+        resultIndexes.insert(key, col);
+        resultColumns.emplace_back(numRows, nullNumber);
+    }
+
+    resultColumns[col][row] = res;
+}
+
+
+int ComponentDatabase::addAttribute(const QString& attribute)
+{
+    auto col = attributeIndexes.value(attribute, -1);
+
+    if(col != -1)
+        return col;
+
+    col = static_cast<int>(attributeColumns.size());
+
+    attributeNames.append(attribute);
+    attributeIndexes.insert(attribute, col);
+
+    AttributeColumn newColumn;
+    newColumn.numbers.assign(numRows, nullNumber);
+    newColumn.integers.assign(numRows, 0);
+
+    attributeColumns.push_back(std::move(newColumn));
+
+    return col;
+}
+
+
+void ComponentDatabase::setValue(AttributeColumn& column, const int row, const QVariant& value)
+{
+    // The search indexes are rebuilt when they are next used
+    if(!searchIndexes.isEmpty())
+        searchIndexes.clear();
+
+    // Empty values are null in either kind of column
+    const bool isNull = value.isNull() || (value.type() == QVariant::String && value.toString().isEmpty());
+
+    if(!column.isText)
+    {
+        if(isNull)
+        {
+            column.numbers[row] = nullNumber;
+
+            if(column.isInteger)
+                column.integers[row] = 0;
+
+            return;
+        }
+
+        const bool isString = value.type() == QVariant::String;
+
+        bool OK = false;
+        auto val = value.toDouble(&OK);
+
+        // Whole numbers are read exactly, numbers given as doubles rather than text are taken to have decimals
+        bool isWhole = false;
+        qint64 integer = 0;
+
+        // The decimals of a number that is not given as text are not known, it is shown with the decimals of the column if that is exact
+        int decimals = unknownDecimals;
+
+        if(isString)
+        {
+            auto str = value.toString().trimmed();
+            auto firstDigit = (str.startsWith('-') || str.startsWith('+')) ? 1 : 0;
+
+            // Codes with leading zeros, e.g., zip codes, are kept as text so that they are not changed
+            if(str.size() > firstDigit + 1 && str.at(firstDigit) == '0' && str.at(firstDigit + 1).isDigit())
+                OK = false;
+
+            integer = str.toLongLong(&isWhole);
+
+            auto utf8 = str.toUtf8();
+            decimals = countDecimals(utf8.constData(), utf8.size());
+        }
+        else if(value.type() == QVariant::Int || value.type() == QVariant::LongLong || value.type() == QVariant::UInt)
+        {
+            integer = value.toLongLong(&isWhole);
+            decimals = 0;
+        }
+        else if(column.decimals >= 0 && QString::number(val, 'f', column.decimals).toDouble() != val)
+        {
+            // The number would be rounded if it was shown with the decimals of the column
+            decimals = mixedDecimals;
+        }
+
+        if(OK && !std::isnan(val))
+        {
+            if(column.isInteger && !isWhole)
+                this->convertToDecimals(column);
+
+            column.numbers[row] = val;
+
+            if(column.isInteger)
+                column.integers[row] = integer;
+
+            column.decimals = mergeDecimals(column.decimals, decimals);
+
+            return;
+        }
+
+        this->convertToText(column);
+    }
+
+    column.stringIndexes[row] = isNull ? 0 : this->getStringIndex(column, value.toString());
+}
+
+
+QVariant ComponentDatabase::getValue(const AttributeColumn& column, const int row) const
+{
+    // Null values are returned as null strings, which is how empty cells are read from the input file
+    if(column.isText)
+        return QVariant(column.strings.at(column.stringIndexes[row]));
+
+    auto val = column.numbers[row];
+
+    if(std::isnan(val))
+        return QVariant(QString());
+
+    if(column.isInteger)
+        return QVariant(column.integers[row]);
+
+    return QVariant(val);
+}
+
+
+QString ComponentDatabase::getText(const AttributeColumn& column, const int row) const
+{
+    if(column.isText)
+        return column.strings.at(column.stringIndexes[row]);
+
+    auto val = column.numbers[row];
+
+    if(std::isnan(val))
+        return QString();
+
+    if(column.isInteger)
+        return QString::number(column.integers[row]);
+
+    if(column.decimals >= 0)
+        return QString::number(val, 'f', column.decimals);
+
+    return QString::number(val, 'g', QLocale::FloatingPointShortest);
+}
+
+
+void ComponentDatabase::convertToDecimals(AttributeColumn& column)
+{
+    column.isInteger = false;
+
+    std::vector<qint64>().swap(column.integers);
+}
+
+
+void ComponentDatabase::convertToText(AttributeColumn& column)
+{
+    // Index 0 is the null string
+    column.strings = QStringList{QString()};
+    column.stringLookup.clear();
+
+    // The numbers keep the text that they were shown with
+    std::vector<quint32> stringIndexes(column.numbers.size());
+
+    for(size_t i = 0; i<column.numbers.size(); ++i)
+        stringIndexes[i] = std::isnan(column.numbers[i]) ? 0 : this->getStringIndex(column, this->getText(column, int(i)));
+
+    column.isText = true;
+    column.stringIndexes = std::move(stringIndexes);
+
+    std::vector<double>().swap(column.numbers);
+    std::vector<qint64>().swap(column.integers);
+}
+
+
+void ComponentDatabase::appendColumn(AttributeColumn& column, const AttributeColumn* blockColumn, const int numRowsToAdd)
+{
+    // A text column of the block that only has nulls is added as nulls, so that it does not change the type of the column
+    if(blockColumn == nullptr || (blockColumn->isText && blockColumn->strings.size() <= 1))
+    {
+        if(column.isText)
+        {
+            column.stringIndexes.resize(column.stringIndexes.size() + numRowsToAdd, 0);
+        }
+        else
+        {
+            column.numbers.resize(column.numbers.size() + numRowsToAdd, nullNumber);
+
+            if(column.isInteger)
+                column.integers.resize(column.integers.size() + numRowsToAdd, 0);
+        }
+
+        return;
+    }
+
+    if(!blockColumn->isText && !column.isText)
+    {
+        if(column.isInteger && !blockColumn->isInteger)
+            this->convertToDecimals(column);
+
+        column.numbers.insert(column.numbers.end(), blockColumn->numbers.begin(), blockColumn->numbers.end());
+
+        if(column.isInteger)
+            column.integers.insert(column.integers.end(), blockColumn->integers.begin(), blockColumn->integers.end());
+
+        column.decimals = mergeDecimals(column.decimals, blockColumn->decimals);
+
+        return;
+    }
+
+    if(!column.isText)
+        this->convertToText(column);
+
+    column.stringIndexes.reserve(column.stringIndexes.size() + numRowsToAdd);
+
+    if(!blockColumn->isText)
+    {
+        for(int i = 0; i<numRowsToAdd; ++i)
+            column.stringIndexes.push_back(std::isnan(blockColumn->numbers[i]) ? 0 : this->getStringIndex(column, this->getText(*blockColumn, i)));
+
+        return;
+    }
+
+    // Find each string of the block in the column once
+    std::vector<quint32> stringMap(blockColumn->strings.size(), 0);
+
+    for(int i = 1; i<blockColumn->strings.size(); ++i)
+    {
+        const auto& str = blockColumn->strings.at(i);
+
+        stringMap[i] = str.isEmpty() ? 0 : this->getStringIndex(column, str);
+    }
+
+    for(auto&& index : blockColumn->stringIndexes)
+        column.stringIndexes.push_back(stringMap[index]);
+}
+
+
+quint32 ComponentDatabase::getStringIndex(AttributeColumn& column, const QString& str)
+{
+    auto it = column.stringLookup.constFind(str);
+
+    if(it != column.stringLookup.constEnd())
+        return it.value();
+
+    auto index = quint32(column.strings.size());
+
+    column.strings.append(str);
+    column.stringLookup.insert(str, index);
+
+    return index;
+}
+
+
+int ComponentDatabase::countDecimals(const char* text, const int size)
+{
+    int decimals = 0;
+    bool afterPoint = false;
+
+    for(int i = 0; i<size; ++i)
+    {
+        const char c = text[i];
+
+        if(c == 'e' || c == 'E')
+            return mixedDecimals;
+
+        if(c == '.')
+            afterPoint = true;
+        else if(afterPoint && c >= '0' && c <= '9')
+            ++decimals;
+    }
+
+    return decimals;
+}
+
+
+int ComponentDatabase::mergeDecimals(const int decimals, const int otherDecimals)
+{
+    if(decimals == unknownDecimals)
+        return otherDecimals;
+
+    if(otherDecimals == unknownDecimals || otherDecimals == decimals)
+        return decimals;
+
+    return mixedDecimals;
 }
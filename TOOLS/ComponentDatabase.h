@@ -38,12 +38,26 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 
 // Written by: Stevan Gavrilovic
 
+// Stores the components column by column. The attribute names are kept once in a schema that maps each name to a column, and each
+// column stores its values contiguously, as numbers if all of its values are numbers or otherwise as indexes into a table of its distinct
+// strings. The rows are found from the component IDs by an offset into an array, since the IDs are usually sequential
+
+#include "AttributeIndex.h"
+#include "IntervalSet.h"
+#include "RTree.h"
+
+#include <QHash>
 #include <QMap>
+#include <QStringList>
 #include <QVariant>
+#include <QVector>
 
 #include <Feature.h>
 #include <FeatureTable.h>
 
+#include <functional>
+#include <vector>
+
 namespace Esri
 {
 namespace ArcGISRuntime
@@ -52,65 +66,47 @@ class Feature;
 }
 }
 
-struct Component
+class ComponentDatabase;
+
+// A handle to a component in the database. It refers to the row in the database rather than holding a copy of the data, so it is cheap to
+// copy and any changes made through it are kept. A default constructed handle is invalid
+class Component
 {
 public:
+    Component() = default;
+    Component(ComponentDatabase* database, const int row);
 
-    void addResult(const QString& key, const double res)
-    {
-        ResultsValues.insert(key,res);
-    }
+    void addResult(const QString& key, const double res);
 
-    QVariant getAttributeValue(const QString& key)
-    {
-        return ComponentAttributes.value(key);
-    }
+    // Returns the value of the attribute, or defaultValue if the database does not have the attribute
+    QVariant getAttributeValue(const QString& key, const QVariant& defaultValue = QVariant()) const;
 
-    double getResultValue(const QString& key)
-    {
-        return ResultsValues.value(key);
-    }
+    // Returns the result, or zero if it has not been set
+    double getResultValue(const QString& key) const;
 
-    int setAttributeValue(const QString& attribute, const QVariant& value)
-    {
-        ComponentAttributes[attribute] = value;
+    // Sets the value of the attribute in the database and in the GIS feature, returns 0 on success
+    int setAttributeValue(const QString& attribute, const QVariant& value);
 
-        if(ComponentFeature != nullptr)
-        {
-            ComponentFeature->attributes()->replaceAttribute(attribute,value);
-            ComponentFeature->featureTable()->updateFeature(ComponentFeature);
+    // All of the attributes of the component as a map, this makes a copy
+    QMap<QString, QVariant> getAttributes(void) const;
 
-            if(ComponentFeature->attributes()->attributeValue(attribute).isNull())
-            {
-                qDebug()<<"Failed to update feature "<<attribute<<" in component "<<ID;
-                return -1;
-            }
-        }
+    // Returns true if the handle refers to a component that has a feature and attributes
+    bool isValid(void) const;
 
-        return 0;
-    }
+    // Returns true if the handle refers to a component in the database
+    bool exists(void) const;
 
-    bool isValid(void)
-    {
-        if(ComponentFeature == nullptr || ComponentAttributes.empty())
-            return false;
-
-        return true;
-    }
-
-    int ID = -1;
+    int getID(void) const;
 
     // Unique id of this component
-    QString UID = "NULL";
+    QString getUID(void) const;
 
     // The Component feature in the GIS widget
-    Esri::ArcGISRuntime::Feature* ComponentFeature = nullptr;
-
-    // Map to store the Component attributes
-    QMap<QString, QVariant> ComponentAttributes;
+    Esri::ArcGISRuntime::Feature* getFeature(void) const;
 
-    // Map to store the results - the QString (key) is the header text while the double is the value for that Component
-    QMap<QString, double> ResultsValues;
+private:
+    ComponentDatabase* theDatabase = nullptr;
+    int row = -1;
 };
 
 
@@ -119,25 +115,209 @@ class ComponentDatabase
 public:
     ComponentDatabase();
 
-    // Gets the Component as a modifiable reference
-    Component& getComponent(const int ID);
+    // The number of decimals of a column whose numbers were written in different ways, and of a column that has no numbers yet
+    static const int mixedDecimals = -1;
+    static const int unknownDecimals = -2;
+
+    // A column of attribute values. The column starts out as whole numbers, is changed to numbers with decimals the first time it is given
+    // one, and to text the first time it is given a value that is not a number. Null values are stored as NaN in a number column, and as
+    // index 0, which is always the null string, in a text column
+    struct AttributeColumn
+    {
+        bool isText = false;
+
+        // Whole numbers are also kept as integers, since a double only holds them exactly up to 2^53. Nulls are zero in the integers
+        bool isInteger = true;
+
+        // The number of decimals that all of the numbers were written with, so that they are shown as written, e.g., 1.50 rather than 1.5
+        int decimals = unknownDecimals;
+
+        std::vector<double> numbers;
+        std::vector<qint64> integers;
+
+        std::vector<quint32> stringIndexes;
+        QStringList strings;
+        QHash<QString, quint32> stringLookup;
+    };
+
+    // Consecutive components with their attributes laid out in columns as in the database, so that they can be put together off of the GUI
+    // thread and then appended all at once. Each column must have one value for each ID
+    struct ComponentBlock
+    {
+        std::vector<int> IDs;
+
+        QStringList attributeNames;
+        std::vector<AttributeColumn> columns;
+    };
+
+    // Gets the Component as a handle through which it can be modified, the handle is invalid if there is no component with that ID
+    Component getComponent(const int ID);
 
-    Component getComponent(const QString UID);
+    // Gets the Component from its unique id, the lookup is done in a hash index of the unique ids
+    Component getComponent(const QString& UID);
 
-    int getNumberOfComponents();
+    int getNumberOfComponents() const;
 
-    void addComponent(int ID, Component& asset);
+    // Adds a component with the given attributes, any attributes that are not yet in the schema are added as new columns
+    // If a component with this ID already exists, it is replaced. Returns the row of the component
+    int addComponent(const int ID, const QString& UID, Esri::ArcGISRuntime::Feature* feature, const QMap<QString, QVariant>& attributes);
+
+    // Appends the components in the block, without features or unique ids. The columns are copied over as they are, and the strings of a
+    // text column are only looked up once each. None of the IDs may already be in the database. Returns the row of the first component
+    // in the block, or -1 on error
+    int appendComponents(const ComponentBlock& block, QString& err);
 
     void clear(void);
 
-    QMap<int, Component> getComponentsMap() const;
+    // The attribute names in the order of the columns
+    QStringList getAttributeNames(void) const;
+
+    // Returns the column of the attribute, or -1 if the attribute is not in the schema
+    int getAttributeIndex(const QString& attribute) const;
 
     void updateComponentAttribute(const int ID, const QString& attribute, const QVariant& value);
 
+    // Sets an attribute of many components at once, IDs and values must be the same size. Returns 0 on success
+    // The GIS features are updated with one call per feature table rather than one call per feature
+    int updateComponentAttributes(const QString& attribute, const QVector<int>& IDs, const QVector<QVariant>& values);
+
+    // Visitors that are given a handle to each component in place, without copying any data. Return false from the visitor to stop
+    // forEach visits the components in the order that they were added, forEachInRange visits the components with IDs from firstID to
+    // lastID inclusive, and forEachSelected visits the components with the given IDs. Both of the latter go in increasing order of ID and
+    // skip the IDs that are not in the database
+    void forEach(const std::function<bool(Component& component)>& visitor);
+    void forEachInRange(const int firstID, const int lastID, const std::function<bool(Component& component)>& visitor);
+    void forEachSelected(const IntervalSet& IDs, const std::function<bool(Component& component)>& visitor);
+
+    // Read-only views of the data by row, they are valid until the next component or attribute is added
+    const std::vector<int>& getComponentIDs(void) const;
+
+    // Returns the values of an attribute column, with NaN for null values, or nullptr if the column holds text
+    // Whole numbers beyond 2^53 are rounded here, getAttributeValue() returns them exactly
+    const std::vector<double>* getNumberColumn(const int col) const;
+
+    // Returns the values of an attribute column as indexes into its table of distinct strings, or nullptr if the column holds numbers
+    // Index 0 of the table is always the null string
+    const std::vector<quint32>* getStringIndexColumn(const int col) const;
+    const QStringList* getColumnStrings(const int col) const;
+
+    // Returns the row of the component with the given ID, or -1 if it is not in the database
+    int getRow(const int ID) const;
+
+    // The functions by row below return a null value, i.e., -1, an empty string, or nullptr, or do nothing if the row is not in the database
+
+    // Returns the ID of the component with the given unique id, or -1 if it is not in the database
+    int getIDFromUID(const QString& UID) const;
+
+    // Access by row, see the Component class for the equivalent functions by component
+    int getID(const int row) const;
+    QString getUID(const int row) const;
+    Esri::ArcGISRuntime::Feature* getFeature(const int row) const;
+
+    // Set the unique id and the feature of a component, for when the components are loaded before their features are created
+    void setUID(const int row, const QString& UID);
+    void setFeature(const int row, Esri::ArcGISRuntime::Feature* feature);
+    QVariant getAttributeValue(const int row, const int col) const;
+    void setAttributeValue(const int row, const int col, const QVariant& value);
+
+    // The value as text, with the numbers written as they were given, e.g., with the same number of decimals. Use this to show or save values
+    QString getAttributeText(const int row, const int col) const;
+
+    // Sets the value by attribute name, adding the attribute to the schema if it is not already in there
+    void setAttributeValue(const int row, const QString& attribute, const QVariant& value);
+    double getResultValue(const int row, const QString& key) const;
+    void addResult(const int row, const QString& key, const double res);
+
+    // Adds the attribute to the schema if it is not already in there, and returns its column
+    int addAttribute(const QString& attribute);
+
+    // Sets the bounding box of the geometry of a component in WGS84, for the spatial index
+    void setBounds(const int row, const RTree::Box& bounds);
+
+    // The spatial index of the components by their bounding boxes, with the rows as the items. It is rebuilt on first use after any
+    // component or bounding box changes, and the bounding boxes that were not set are taken from the GIS features
+    const RTree& getSpatialIndex(void);
+
+    // Finds the components in a polygon, given by the x and y of the points of its rings in WGS84 and the index of the first point of each ring
+    // followed by the number of points. The components whose bounding boxes are inside the polygon are added to insideIDs, and the rows
+    // of those whose bounding boxes cross its edges are added to boundaryRows, for the caller to check against their exact geometry
+    void getComponentsInPolygon(const std::vector<double>& coordinates, const std::vector<int>& partStarts, IntervalSet& insideIDs, std::vector<int>& boundaryRows);
+
+    // Finds the components whose value of the attribute starts with the text, ignoring case, and adds their rows in order of the values, up
+    // to maxResults if it is not negative. Numbers are matched by their text but ordered by value, text is ordered ignoring case. The ID
+    // and UID can be searched like the attributes. The search index of an attribute is built the first time that it is searched and kept
+    // until a component or a value changes. Returns the number of rows added
+    int findComponents(const QString& attribute, const QString& text, std::vector<int>& rows, const int maxResults = -1);
+
+    // The number of decimals that a number is written with, or mixedDecimals if it has an exponent
+    static int countDecimals(const char* text, const int size);
+
+    // The number of decimals of a column after adding numbers written with otherDecimals
+    static int mergeDecimals(const int decimals, const int otherDecimals);
+
 private:
 
-    QMap<int,Component> ComponentMap;
+    void setValue(AttributeColumn& column, const int row, const QVariant& value);
+    QVariant getValue(const AttributeColumn& column, const int row) const;
+    QString getText(const AttributeColumn& column, const int row) const;
+
+    // Changes a column of whole numbers to a column of numbers with decimals
+    void convertToDecimals(AttributeColumn& column);
+
+    // Changes a number column to a text column
+    void convertToText(AttributeColumn& column);
+
+    // Appends the values of a column from a block, or numRowsToAdd null values if blockColumn is nullptr
+    void appendColumn(AttributeColumn& column, const AttributeColumn* blockColumn, const int numRowsToAdd);
+
+    quint32 getStringIndex(AttributeColumn& column, const QString& str);
+
+    // The schema, i.e., the attribute names and their columns
+    QStringList attributeNames;
+    QHash<QString, int> attributeIndexes;
+    std::vector<AttributeColumn> attributeColumns;
+
+    // The results are stored in the same way, with NaN for the results that are not set
+    QStringList resultNames;
+    QHash<QString, int> resultIndexes;
+    std::vector<std::vector<double>> resultColumns;
+
+    // The data that every component has, by row
+    std::vector<int> componentIDs;
+    std::vector<QString> componentUIDs;
+    std::vector<Esri::ArcGISRuntime::Feature*> componentFeatures;
+
+    // The row of each ID, stored at the offset of the ID from minID, with -1 for IDs that are not in the database. If the IDs are spread too
+    // far apart for an array, e.g., 1 and 2000000000, the index is moved into a hash
+    qint64 minID = 0;
+    std::vector<int> rowsByID;
+    QHash<int, int> rowsByIDHash;
+    bool useIDHash = false;
+
+    // The array is used as long as it has at most this many entries for each component, plus minIDArraySize
+    static const int maxIDArrayFactor = 4;
+    static const int minIDArraySize = 1024;
+
+    // Adds the ID of a new row to the index
+    void indexID(const int ID, const int row);
+
+    bool isValidRow(const int row) const;
+
+    // The row of each unique id
+    QHash<QString, int> rowsByUID;
+
+    // The bounding box of each component, invalid if it has not been set, and the index of the boxes
+    std::vector<RTree::Box> componentBounds;
+    RTree spatialIndex;
+    bool spatialIndexIsValid = false;
+
+    // The search indexes of the attributes that were searched, with the rows as the items
+    QHash<QString, AttributeIndex> searchIndexes;
+
+    // Builds the search index of the attribute, returns false if there is no such attribute
+    bool buildSearchIndex(const QString& attribute, AttributeIndex& index) const;
 
+    int numRows = 0;
 };
 
 #endif // ComponentDATABASE_H
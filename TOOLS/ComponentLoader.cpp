@@ -0,0 +1,387 @@
+/* *****************************************************************************
+Copyright (c) 2016-2021, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+// Written by: Stevan Gavrilovic
+
+#include "ComponentLoader.h"
+#include "CSVReaderWriter.h"
+#include "GeometryCache.h"
+
+#include <QDebug>
+#include <QThread>
+#include <QtConcurrent/QtConcurrentMap>
+
+#include <cmath>
+#include <limits>
+
+ComponentLoader::ComponentLoader(const QString& pathToFile) : pathToFile(pathToFile), cancelled(false), batchSlots(maxQueuedBatches)
+{
+    qRegisterMetaType<ComponentBatch>("ComponentBatch");
+}
+
+
+void ComponentLoader::setGeometryBuilder(const GeometryBuilder& builder, const QString& cacheKey)
+{
+    geometryBuilder = builder;
+    geometryCacheKey = cacheKey;
+}
+
+
+void ComponentLoader::cancel(void)
+{
+    cancelled = true;
+}
+
+
+void ComponentLoader::releaseBatch(void)
+{
+    batchSlots.release();
+}
+
+
+void ComponentLoader::load(void)
+{
+    QString err;
+    this->loadBatches(err);
+
+    emit loadingFinished(cancelled, err);
+}
+
+
+int ComponentLoader::loadBatches(QString& err)
+{
+    CSVReaderWriter csvTool;
+
+    // The inventory is cached after the first load so that reopening a project does not tokenize the file again. The batches share the
+    // table so that it stays mapped until the last batch is done with
+    auto table = std::make_shared<CSVTable>();
+    auto& data = *table;
+
+    csvTool.parseCSVFile(pathToFile,data,err,true,true);
+
+    if(!err.isEmpty())
+        return -1;
+
+    if(data.isEmpty())
+    {
+        err = "Input file is empty";
+        return -1;
+    }
+
+    // Get the header file, the first row of the file contains the header information
+    QStringList headings = data.getRow(0);
+
+    auto numRows = data.rowCount()-1;
+    auto numCols = headings.size();
+
+    if(numRows == 0)
+    {
+        err = "Input file is empty";
+        return -1;
+    }
+
+    if(data.columnCount(1) == 0)
+    {
+        err = "First row is empty";
+        return -1;
+    }
+
+    // Check all of the rows before any are sent, so that the receiver does not get a partial inventory if the file is invalid
+    auto initialID = data.at(1,0).toInt();
+
+    for(int i = 0; i<numRows; ++i)
+    {
+        // Skip over the header row
+        auto rowIndex = i+1;
+
+        if(data.columnCount(rowIndex) != numCols)
+        {
+            err = "Error, the number of items in row " + QString::number(i+1) + " does not equal number of headings in the file";
+            return -1;
+        }
+
+        if(initialID+i != data.at(rowIndex,0).toInt())
+        {
+            err = "Error, the asset IDs must be sequential";
+            return -1;
+        }
+    }
+
+    if(cancelled)
+        return 0;
+
+    // Compressed files are not cached, so their columns are typed here
+    if(!data.hasColumnTypes())
+        data.findColumnTypes();
+
+    // The geometries are read from their cache if the file has not changed since it was made, otherwise they are built and the cache is
+    // written as the batches are sent. The inventory is still loaded if the cache cannot be written
+    GeometryCache geometryCache;
+    bool readGeometryCache = false;
+    bool writeGeometryCache = false;
+
+    if(geometryBuilder && !geometryCacheKey.isEmpty())
+    {
+        auto sourceHash = data.getContentHash();
+
+        readGeometryCache = geometryCache.load(pathToFile, geometryCacheKey, sourceHash, numRows) == 0;
+
+        if(!readGeometryCache)
+        {
+            QString cacheErr;
+            writeGeometryCache = geometryCache.beginWrite(pathToFile, geometryCacheKey, sourceHash, cacheErr) == 0;
+
+            if(!writeGeometryCache)
+                qDebug()<<cacheErr;
+        }
+    }
+
+    const int numBatches = (numRows + rowsPerBatch - 1)/rowsPerBatch;
+
+    // Enough batches are built at a time to keep every thread busy
+    const int batchesPerGroup = qMax(1, QThread::idealThreadCount());
+
+    for(int firstBatch = 0; firstBatch < numBatches; firstBatch += batchesPerGroup)
+    {
+        if(cancelled)
+            return 0;
+
+        const int numInGroup = qMin(batchesPerGroup, numBatches - firstBatch);
+
+        QVector<ComponentBatch> batches(numInGroup);
+        QVector<QString> batchErrors(numInGroup);
+
+        // The geometries of each batch for the cache, and any error flattening them
+        QVector<GeometryCache::FlatGeometries> flatGeometries(writeGeometryCache ? numInGroup : 0);
+        QVector<QString> flattenErrors(numInGroup);
+
+        for(int i = 0; i<numInGroup; ++i)
+        {
+            batches[i].firstRow = (firstBatch + i)*rowsPerBatch;
+            batches[i].numRows = qMin(rowsPerBatch, numRows - batches[i].firstRow);
+            batches[i].table = table;
+        }
+
+        auto buildBatch = [&](ComponentBatch& batch)
+        {
+            auto batchIndex = int(&batch - batches.data());
+
+            auto numBatchRows = batch.numRows;
+
+            fillComponentBlock(data, headings, initialID, batch);
+
+            if(readGeometryCache)
+            {
+                QString cacheErr;
+                if(geometryCache.getGeometries(batch.firstRow, numBatchRows, batch.geometries, cacheErr) == 0)
+                    return;
+
+                // Build the geometries if they cannot be read from the cache
+                qDebug()<<cacheErr;
+                batch.geometries.clear();
+            }
+
+            if(!geometryBuilder)
+                return;
+
+            if(geometryBuilder(headings, batch, batchErrors[batchIndex]) != 0 || !writeGeometryCache)
+                return;
+
+            if(batch.geometries.size() != batch.numRows)
+                flattenErrors[batchIndex] = "The number of geometries does not match the number of components";
+            else
+                GeometryCache::flatten(batch.geometries, flatGeometries[batchIndex], flattenErrors[batchIndex]);
+        };
+
+        QtConcurrent::blockingMap(batches, buildBatch);
+
+        // Send the batches in order
+        for(int i = 0; i<numInGroup; ++i)
+        {
+            if(!batchErrors.at(i).isEmpty())
+            {
+                err = batchErrors.at(i);
+                return -1;
+            }
+
+            // The headings are sent once the first batches are built, so that nothing is sent if the geometries cannot be built at all, e.g.,
+            // if the columns that they are built from are missing
+            if(firstBatch == 0 && i == 0)
+                emit headingsLoaded(headings, numRows);
+
+            if(writeGeometryCache)
+            {
+                QString cacheErr = flattenErrors.at(i);
+
+                if(!cacheErr.isEmpty() || geometryCache.write(flatGeometries.at(i), cacheErr) != 0)
+                {
+                    qDebug()<<cacheErr;
+                    geometryCache.cancelWrite();
+                    writeGeometryCache = false;
+                }
+            }
+
+            // Wait until the receiver has room for another batch, checking every so often if the loading was cancelled
+            while(!batchSlots.tryAcquire(1, 100))
+            {
+                if(cancelled)
+                    return 0;
+            }
+
+            if(cancelled)
+                return 0;
+
+            emit batchLoaded(batches.at(i));
+        }
+    }
+
+    if(writeGeometryCache)
+    {
+        QString cacheErr;
+        if(geometryCache.finishWrite(cacheErr) != 0)
+            qDebug()<<cacheErr;
+    }
+
+    return 0;
+}
+
+
+void ComponentLoader::fillComponentBlock(const CSVTable& data, const QStringList& headings, const int firstID, ComponentBatch& batch)
+{
+    auto block = std::make_shared<ComponentDatabase::ComponentBlock>();
+
+    const int numBatchRows = batch.numRows;
+
+    // The IDs were checked to be sequential
+    block->IDs.resize(numBatchRows);
+    for(int i = 0; i<numBatchRows; ++i)
+        block->IDs[i] = firstID + batch.firstRow + i;
+
+    // The first column is the ID, the other columns are attributes
+    const int numCols = headings.size();
+
+    block->attributeNames = headings.mid(1);
+    block->columns.resize(numCols - 1);
+
+    const double nullNumber = std::numeric_limits<double>::quiet_NaN();
+
+    for(int j = 1; j<numCols; ++j)
+    {
+        auto& column = block->columns[j-1];
+
+        // The typed values start at the row after the header, and empty cells are null
+        const auto doubles = data.getDoubleData(j);
+        const auto integers = data.getInt64Data(j);
+
+        if(doubles != nullptr)
+        {
+            // Keep the number of decimals so that the numbers are shown as they are in the file
+            column.isInteger = false;
+            column.numbers.resize(numBatchRows);
+
+            for(int i = 0; i<numBatchRows; ++i)
+            {
+                auto field = batch.cell(i,j);
+
+                if(field.isEmpty())
+                {
+                    column.numbers[i] = nullNumber;
+                    continue;
+                }
+
+                column.numbers[i] = doubles[batch.firstRow + i];
+                column.decimals = ComponentDatabase::mergeDecimals(column.decimals, ComponentDatabase::countDecimals(field.data(), field.size()));
+            }
+
+            continue;
+        }
+
+        if(integers != nullptr)
+        {
+            // The integers are kept as they are, IDs can be larger than a double holds exactly
+            column.numbers.resize(numBatchRows);
+            column.integers.resize(numBatchRows);
+            column.decimals = 0;
+
+            for(int i = 0; i<numBatchRows; ++i)
+            {
+                const int row = batch.firstRow + i;
+
+                if(batch.cell(i,j).isEmpty())
+                {
+                    column.numbers[i] = nullNumber;
+                    column.integers[i] = 0;
+                    continue;
+                }
+
+                column.numbers[i] = double(integers[row]);
+                column.integers[i] = integers[row];
+            }
+
+            continue;
+        }
+
+        // Index 0 is the null string
+        column.isText = true;
+        column.strings = QStringList{QString()};
+        column.stringIndexes.resize(numBatchRows);
+
+        for(int i = 0; i<numBatchRows; ++i)
+        {
+            auto field = batch.cell(i,j);
+
+            if(field.isEmpty())
+            {
+                column.stringIndexes[i] = 0;
+                continue;
+            }
+
+            auto str = field.toString();
+
+            auto it = column.stringLookup.constFind(str);
+
+            if(it == column.stringLookup.constEnd())
+            {
+                it = column.stringLookup.insert(str, quint32(column.strings.size()));
+                column.strings.append(str);
+            }
+
+            column.stringIndexes[i] = it.value();
+        }
+    }
+
+    batch.components = block;
+}
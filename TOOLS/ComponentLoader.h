@@ -0,0 +1,140 @@
+#ifndef COMPONENTLOADER_H
+#define COMPONENTLOADER_H
+/* *****************************************************************************
+Copyright (c) 2016-2021, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+// Written by: Stevan Gavrilovic
+
+// Loads a component inventory off of the GUI thread. The file is parsed and validated first, then the attribute columns of the components
+// and their geometries are put together in batches on multiple threads. The batches are handed to the GUI thread in order through queued
+// signals, so that the components can be shown while the rest of the file is still loading
+
+#include "ComponentDatabase.h"
+#include "CSVTable.h"
+#include "Geometry.h"
+
+#include <QObject>
+#include <QSemaphore>
+#include <QStringList>
+#include <QVector>
+
+#include <atomic>
+#include <functional>
+#include <memory>
+
+// A batch of consecutive rows from the inventory file. The rows are not copied, the cells are read in place from the parsed file
+struct ComponentBatch
+{
+    // The row of the first component in the batch, not counting the header row
+    int firstRow = 0;
+    int numRows = 0;
+
+    // The parsed file, which is shared by all of the batches
+    std::shared_ptr<const CSVTable> table;
+
+    // The cell in the given column of the ith component of the batch, the first column is the component ID
+    CSVField cell(const int i, const int col) const
+    {
+        return table->at(firstRow + i + 1, col);
+    }
+
+    // The components of the batch laid out as in the database, ready to be appended to it
+    std::shared_ptr<const ComponentDatabase::ComponentBlock> components;
+
+    // The geometry of each row, or empty if no geometry builder is set
+    QVector<Esri::ArcGISRuntime::Geometry> geometries;
+};
+
+Q_DECLARE_METATYPE(ComponentBatch)
+
+class ComponentLoader : public QObject
+{
+    Q_OBJECT
+
+public:
+    ComponentLoader(const QString& pathToFile);
+
+    // Builds the geometries of a batch from its cells and the header row. It is called on worker threads, so it must not use any widget or map state
+    // Returns 0 on success
+    using GeometryBuilder = std::function<int(const QStringList& headings, ComponentBatch& batch, QString& err)>;
+
+    // If a cache key is given, the geometries are cached under that key after they are built, and are read from the cache instead of being
+    // built again when the same file is loaded with the same key. The key must change if the builder would build different geometries
+    void setGeometryBuilder(const GeometryBuilder& builder, const QString& cacheKey = QString());
+
+    // Can be called from any thread, the loading stops before the next batch is sent
+    void cancel(void);
+
+    // Called by the receiver of a batch when it is done with it. The loader does not get more than a few batches ahead of the receiver, so
+    // that the whole file is not queued up in memory if the GUI thread is slower than the workers
+    void releaseBatch(void);
+
+public slots:
+    // Runs the loader, connect this to the started signal of the thread that the loader was moved to
+    void load(void);
+
+signals:
+    // Sent once the file is parsed and validated and the first batches are built, right before the first batch
+    void headingsLoaded(QStringList headings, int numRows);
+
+    void batchLoaded(ComponentBatch batch);
+
+    // Sent last, err is empty unless the loading failed
+    void loadingFinished(bool cancelled, QString err);
+
+private:
+
+    // Parses and validates the file, and sends the batches. Returns 0 on success
+    int loadBatches(QString& err);
+
+    // Puts the attribute columns of the batch together from the typed columns of the file
+    static void fillComponentBlock(const CSVTable& data, const QStringList& headings, const int firstID, ComponentBatch& batch);
+
+    QString pathToFile;
+
+    GeometryBuilder geometryBuilder;
+    QString geometryCacheKey;
+
+    std::atomic<bool> cancelled;
+
+    QSemaphore batchSlots;
+
+    static const int rowsPerBatch = 5000;
+
+    static const int maxQueuedBatches = 8;
+};
+
+#endif // COMPONENTLOADER_H
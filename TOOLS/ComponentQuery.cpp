@@ -0,0 +1,874 @@
+/* *****************************************************************************
+Copyright (c) 2016-2021, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+// Written by: Stevan Gavrilovic
+
+#include "ComponentQuery.h"
+#include "ComponentDatabase.h"
+
+#include <QStringList>
+#include <QVector>
+#include <QtConcurrent/QtConcurrentMap>
+
+struct ComponentQuery::Node
+{
+    enum class Type {Compare, In, And, Or, Not};
+
+    enum class Operator {Less, LessEqual, Greater, GreaterEqual, Equal, NotEqual};
+
+    struct Value
+    {
+        bool isNumber = false;
+        double number = 0.0;
+        QString text;
+    };
+
+    Type type = Type::Compare;
+
+    // The comparison, for the Compare and In nodes
+    Operator op = Operator::Equal;
+    QString attribute;
+    std::vector<Value> values;
+
+    // The operands, the Not node only has the left operand
+    std::unique_ptr<Node> left;
+    std::unique_ptr<Node> right;
+};
+
+namespace
+{
+
+using Node = ComponentQuery::Node;
+
+// The number of rows that each task on the thread pool works on
+const int chunkSize = 65536;
+
+// While the query is evaluated, each row holds one of these results. A comparison with a null value is unknown, as in SQL, so that it stays
+// unknown under not. With this ordering, and is the smaller of the two results, or is the larger, and not is isTrue minus the result
+const quint8 isFalse = 0;
+const quint8 isUnknown = 1;
+const quint8 isTrue = 2;
+
+struct Token
+{
+    enum class Type {Word, Number, String, Operator, LeftParen, RightParen, Comma, End};
+
+    Type type = Type::End;
+    QString text;
+    double number = 0.0;
+
+    // The position of the token in the query, for the error messages
+    int pos = 0;
+};
+
+
+int tokenize(const QString& query, std::vector<Token>& tokens, QString& err)
+{
+    const int length = query.size();
+
+    int i = 0;
+    while(i < length)
+    {
+        const QChar c = query.at(i);
+
+        if(c.isSpace())
+        {
+            ++i;
+            continue;
+        }
+
+        Token token;
+        token.pos = i;
+
+        // A sign is part of a number if it cannot be a binary operator, i.e., if it follows an operator, a comma, a parenthesis or nothing
+        const bool canBeSigned = tokens.empty() || tokens.back().type == Token::Type::Operator || tokens.back().type == Token::Type::Comma || tokens.back().type == Token::Type::LeftParen;
+        const bool isSignedNumber = canBeSigned && (c == '-' || c == '+') && i + 1 < length && (query.at(i + 1).isDigit() || query.at(i + 1) == '.');
+
+        if(c == '(')
+        {
+            token.type = Token::Type::LeftParen;
+            ++i;
+        }
+        else if(c == ')')
+        {
+            token.type = Token::Type::RightParen;
+            ++i;
+        }
+        else if(c == ',')
+        {
+            token.type = Token::Type::Comma;
+            ++i;
+        }
+        else if(c == '\'' || c == '"')
+        {
+            auto end = query.indexOf(c, i + 1);
+
+            if(end == -1)
+            {
+                err = "Error in the query, the quote at position " + QString::number(i + 1) + " is not closed";
+                return -1;
+            }
+
+            token.type = Token::Type::String;
+            token.text = query.mid(i + 1, end - i - 1);
+            i = end + 1;
+        }
+        else if(c.isDigit() || (c == '.' && i + 1 < length && query.at(i + 1).isDigit()) || isSignedNumber)
+        {
+            int end = i + 1;
+            while(end < length)
+            {
+                const QChar next = query.at(end);
+
+                // Take the sign of an exponent
+                if(next.isDigit() || next == '.' || next == 'e' || next == 'E' || ((next == '-' || next == '+') && (query.at(end - 1) == 'e' || query.at(end - 1) == 'E')))
+                    ++end;
+                else
+                    break;
+            }
+
+            bool OK = false;
+            token.type = Token::Type::Number;
+            token.text = query.mid(i, end - i);
+            token.number = token.text.toDouble(&OK);
+
+            if(!OK)
+            {
+                err = "Error in the query, could not read the number " + token.text + " at position " + QString::number(i + 1);
+                return -1;
+            }
+
+            i = end;
+        }
+        else if(c.isLetter() || c == '_')
+        {
+            int end = i + 1;
+            while(end < length && (query.at(end).isLetterOrNumber() || query.at(end) == '_'))
+                ++end;
+
+            token.type = Token::Type::Word;
+            token.text = query.mid(i, end - i);
+            i = end;
+        }
+        else
+        {
+            // The operators, with && || and ! as the alternatives to the words and or not
+            const auto twoChars = query.mid(i, 2);
+
+            if(twoChars == "<=" || twoChars == ">=" || twoChars == "==" || twoChars == "!=" || twoChars == "<>")
+            {
+                token.type = Token::Type::Operator;
+                token.text = twoChars;
+                i += 2;
+            }
+            else if(twoChars == "&&" || twoChars == "||")
+            {
+                token.type = Token::Type::Word;
+                token.text = twoChars == "&&" ? "and" : "or";
+                i += 2;
+            }
+            else if(c == '<' || c == '>' || c == '=')
+            {
+                token.type = Token::Type::Operator;
+                token.text = c;
+                ++i;
+            }
+            else if(c == '!')
+            {
+                token.type = Token::Type::Word;
+                token.text = "not";
+                ++i;
+            }
+            else
+            {
+                err = "Error in the query, unexpected character '" + QString(c) + "' at position " + QString::number(i + 1);
+                return -1;
+            }
+        }
+
+        tokens.push_back(token);
+    }
+
+    Token endToken;
+    endToken.pos = length;
+    tokens.push_back(endToken);
+
+    return 0;
+}
+
+
+// Recursive descent parser, in order of increasing precedence: or, and, not, then a comparison or a query in parentheses
+class QueryParser
+{
+public:
+    QueryParser(const std::vector<Token>& tokens) : tokens(tokens) {}
+
+    std::unique_ptr<Node> parse(QString& err)
+    {
+        auto node = this->parseOr(err);
+
+        if(node == nullptr)
+            return nullptr;
+
+        if(this->current().type != Token::Type::End)
+        {
+            err = this->errorAt("expected 'and', 'or' or the end of the query");
+            return nullptr;
+        }
+
+        return node;
+    }
+
+private:
+
+    const Token& current(void) const
+    {
+        return tokens[pos];
+    }
+
+    bool isKeyword(const Token& token, const char* keyword) const
+    {
+        return token.type == Token::Type::Word && token.text.compare(keyword, Qt::CaseInsensitive) == 0;
+    }
+
+    bool isAnyKeyword(const Token& token) const
+    {
+        return isKeyword(token, "and") || isKeyword(token, "or") || isKeyword(token, "not") || isKeyword(token, "in");
+    }
+
+    QString errorAt(const QString& msg) const
+    {
+        return "Error in the query at position " + QString::number(this->current().pos + 1) + ", " + msg;
+    }
+
+    std::unique_ptr<Node> makeBinary(const Node::Type type, std::unique_ptr<Node> left, std::unique_ptr<Node> right)
+    {
+        auto node = std::make_unique<Node>();
+        node->type = type;
+        node->left = std::move(left);
+        node->right = std::move(right);
+
+        return node;
+    }
+
+    std::unique_ptr<Node> parseOr(QString& err)
+    {
+        auto node = this->parseAnd(err);
+
+        while(node != nullptr && isKeyword(this->current(), "or"))
+        {
+            ++pos;
+
+            auto right = this->parseAnd(err);
+
+            if(right == nullptr)
+                return nullptr;
+
+            node = this->makeBinary(Node::Type::Or, std::move(node), std::move(right));
+        }
+
+        return node;
+    }
+
+    std::unique_ptr<Node> parseAnd(QString& err)
+    {
+        auto node = this->parseNot(err);
+
+        while(node != nullptr && isKeyword(this->current(), "and"))
+        {
+            ++pos;
+
+            auto right = this->parseNot(err);
+
+            if(right == nullptr)
+                return nullptr;
+
+            node = this->makeBinary(Node::Type::And, std::move(node), std::move(right));
+        }
+
+        return node;
+    }
+
+    std::unique_ptr<Node> parseNot(QString& err)
+    {
+        if(isKeyword(this->current(), "not"))
+        {
+            ++pos;
+
+            auto operand = this->parseNot(err);
+
+            if(operand == nullptr)
+                return nullptr;
+
+            return this->makeBinary(Node::Type::Not, std::move(operand), nullptr);
+        }
+
+        return this->parsePrimary(err);
+    }
+
+    std::unique_ptr<Node> parsePrimary(QString& err)
+    {
+        if(this->current().type == Token::Type::LeftParen)
+        {
+            ++pos;
+
+            auto node = this->parseOr(err);
+
+            if(node == nullptr)
+                return nullptr;
+
+            if(this->current().type != Token::Type::RightParen)
+            {
+                err = this->errorAt("expected a ')'");
+                return nullptr;
+            }
+
+            ++pos;
+
+            return node;
+        }
+
+        return this->parseComparison(err);
+    }
+
+    std::unique_ptr<Node> parseComparison(QString& err)
+    {
+        const auto& nameToken = this->current();
+
+        if((nameToken.type != Token::Type::Word && nameToken.type != Token::Type::String) || isAnyKeyword(nameToken))
+        {
+            err = this->errorAt("expected the name of an attribute");
+            return nullptr;
+        }
+
+        auto node = std::make_unique<Node>();
+        node->attribute = nameToken.text;
+
+        ++pos;
+
+        // Handle the attribute not in (...)
+        bool isNegated = false;
+        if(isKeyword(this->current(), "not") && isKeyword(tokens[pos + 1], "in"))
+        {
+            isNegated = true;
+            ++pos;
+        }
+
+        if(isKeyword(this->current(), "in"))
+        {
+            ++pos;
+
+            node->type = Node::Type::In;
+
+            if(this->current().type != Token::Type::LeftParen)
+            {
+                err = this->errorAt("expected a '(' to start the list of values");
+                return nullptr;
+            }
+
+            ++pos;
+
+            while(true)
+            {
+                Node::Value value;
+                if(this->parseValue(value, err) != 0)
+                    return nullptr;
+
+                node->values.push_back(value);
+
+                if(this->current().type == Token::Type::Comma)
+                {
+                    ++pos;
+                    continue;
+                }
+
+                if(this->current().type != Token::Type::RightParen)
+                {
+                    err = this->errorAt("expected a ',' or a ')' in the list of values");
+                    return nullptr;
+                }
+
+                ++pos;
+                break;
+            }
+
+            if(isNegated)
+                return this->makeBinary(Node::Type::Not, std::move(node), nullptr);
+
+            return node;
+        }
+
+        const auto& opToken = this->current();
+
+        if(opToken.type != Token::Type::Operator)
+        {
+            err = this->errorAt("expected a comparison operator after the attribute " + node->attribute);
+            return nullptr;
+        }
+
+        if(opToken.text == "<")
+            node->op = Node::Operator::Less;
+        else if(opToken.text == "<=")
+            node->op = Node::Operator::LessEqual;
+        else if(opToken.text == ">")
+            node->op = Node::Operator::Greater;
+        else if(opToken.text == ">=")
+            node->op = Node::Operator::GreaterEqual;
+        else if(opToken.text == "=" || opToken.text == "==")
+            node->op = Node::Operator::Equal;
+        else
+            node->op = Node::Operator::NotEqual;
+
+        ++pos;
+
+        Node::Value value;
+        if(this->parseValue(value, err) != 0)
+            return nullptr;
+
+        node->type = Node::Type::Compare;
+        node->values.push_back(value);
+
+        return node;
+    }
+
+    int parseValue(Node::Value& value, QString& err)
+    {
+        const auto& token = this->current();
+
+        if(token.type == Token::Type::Number)
+        {
+            value.isNumber = true;
+            value.number = token.number;
+        }
+        else if(token.type == Token::Type::String || (token.type == Token::Type::Word && !isAnyKeyword(token)))
+        {
+            value.isNumber = false;
+            value.text = token.text;
+        }
+        else
+        {
+            err = this->errorAt("expected a value");
+            return -1;
+        }
+
+        ++pos;
+
+        return 0;
+    }
+
+    const std::vector<Token>& tokens;
+    size_t pos = 0;
+};
+
+
+// Runs the kernel over the rows from begin to end, in chunks on the thread pool if there is more than one chunk
+template <typename Kernel>
+void runInChunks(const int numRows, const Kernel& kernel)
+{
+    if(numRows <= chunkSize)
+    {
+        kernel(0, numRows);
+        return;
+    }
+
+    QVector<int> chunkStarts;
+    for(int i = 0; i<numRows; i += chunkSize)
+        chunkStarts.push_back(i);
+
+    QtConcurrent::blockingMap(chunkStarts, [&kernel, numRows](const int chunkStart)
+    {
+        kernel(chunkStart, qMin(chunkStart + chunkSize, numRows));
+    });
+}
+
+
+// Sets the mask of each row to the result of the predicate on the value of that row, or to unknown if the value is NaN, i.e., null
+template <typename T, typename Predicate>
+void runPredicate(const T* values, const int numRows, const Predicate& predicate, quint8* mask)
+{
+    runInChunks(numRows, [values, mask, &predicate](const int begin, const int end)
+    {
+        for(int i = begin; i<end; ++i)
+        {
+            const T v = values[i];
+            mask[i] = v != v ? isUnknown : (predicate(v) ? isTrue : isFalse);
+        }
+    });
+}
+
+
+// Compares the column with a number. One loop is made for each operator so that the comparison is inlined into the loop
+template <typename T>
+void compareColumn(const T* values, const int numRows, const Node::Operator op, const double x, quint8* mask)
+{
+    switch(op)
+    {
+    case Node::Operator::Less:
+        runPredicate(values, numRows, [x](const T v) { return v < x; }, mask);
+        break;
+    case Node::Operator::LessEqual:
+        runPredicate(values, numRows, [x](const T v) { return v <= x; }, mask);
+        break;
+    case Node::Operator::Greater:
+        runPredicate(values, numRows, [x](const T v) { return v > x; }, mask);
+        break;
+    case Node::Operator::GreaterEqual:
+        runPredicate(values, numRows, [x](const T v) { return v >= x; }, mask);
+        break;
+    case Node::Operator::Equal:
+        runPredicate(values, numRows, [x](const T v) { return v == x; }, mask);
+        break;
+    case Node::Operator::NotEqual:
+        runPredicate(values, numRows, [x](const T v) { return v != x; }, mask);
+        break;
+    }
+}
+
+
+template <typename T>
+void columnInList(const T* values, const int numRows, const std::vector<double>& list, quint8* mask)
+{
+    runPredicate(values, numRows, [&list](const T v)
+    {
+        for(auto&& x : list)
+        {
+            if(v == x)
+                return true;
+        }
+
+        return false;
+    }, mask);
+}
+
+
+bool compareResult(const Node::Operator op, const int cmp)
+{
+    switch(op)
+    {
+    case Node::Operator::Less:
+        return cmp < 0;
+    case Node::Operator::LessEqual:
+        return cmp <= 0;
+    case Node::Operator::Greater:
+        return cmp > 0;
+    case Node::Operator::GreaterEqual:
+        return cmp >= 0;
+    case Node::Operator::Equal:
+        return cmp == 0;
+    case Node::Operator::NotEqual:
+        return cmp != 0;
+    }
+
+    return false;
+}
+
+
+// Compares a string from a text column with a value, numbers are compared by value if the string is a number
+bool matchesValue(const QString& str, const Node::Operator op, const Node::Value& value)
+{
+    if(value.isNumber)
+    {
+        bool OK = false;
+        auto number = str.toDouble(&OK);
+
+        if(!OK)
+            return false;
+
+        return compareResult(op, number < value.number ? -1 : (number > value.number ? 1 : 0));
+    }
+
+    return compareResult(op, str.compare(value.text));
+}
+
+}
+
+
+ComponentQuery::ComponentQuery()
+{
+
+}
+
+
+ComponentQuery::~ComponentQuery()
+{
+
+}
+
+
+int ComponentQuery::parse(const QString& query, QString& err)
+{
+    std::vector<Token> tokens;
+
+    if(tokenize(query, tokens, err) != 0)
+        return -1;
+
+    if(tokens.size() == 1)
+    {
+        err = "Error, the query is empty";
+        return -1;
+    }
+
+    QueryParser parser(tokens);
+
+    auto node = parser.parse(err);
+
+    if(node == nullptr)
+        return -1;
+
+    root = std::move(node);
+    queryText = query;
+
+    return 0;
+}
+
+
+QString ComponentQuery::getQuery(void) const
+{
+    return queryText;
+}
+
+
+int ComponentQuery::run(const ComponentDatabase& database, std::vector<quint8>& selection, QString& err) const
+{
+    if(root == nullptr)
+    {
+        err = "Error, there is no query to run";
+        return -1;
+    }
+
+    selection.resize(database.getNumberOfComponents());
+
+    if(this->evaluate(*root, database, selection, err) != 0)
+        return -1;
+
+    // Only the rows where the query is true are selected, not those where it is unknown
+    quint8* data = selection.data();
+
+    runInChunks(int(selection.size()), [data](const int begin, const int end)
+    {
+        for(int i = begin; i<end; ++i)
+            data[i] = data[i] == isTrue ? 1 : 0;
+    });
+
+    return 0;
+}
+
+
+int ComponentQuery::select(const ComponentDatabase& database, IntervalSet& selectedIDs, QString& err) const
+{
+    std::vector<quint8> selection;
+
+    if(this->run(database, selection, err) != 0)
+        return -1;
+
+    selectedIDs.clear();
+
+    // The IDs usually increase with the rows, in which case each ID is appended to the last range
+    const auto& IDs = database.getComponentIDs();
+
+    for(size_t i = 0; i<selection.size(); ++i)
+    {
+        if(selection[i])
+            selectedIDs.insert(IDs[i]);
+    }
+
+    return 0;
+}
+
+
+int ComponentQuery::evaluate(const Node& node, const ComponentDatabase& database, std::vector<quint8>& mask, QString& err) const
+{
+    const int numRows = int(mask.size());
+
+    switch(node.type)
+    {
+    case Node::Type::Compare:
+    case Node::Type::In:
+        return this->evaluateComparison(node, database, mask, err);
+
+    case Node::Type::Not:
+    {
+        if(this->evaluate(*node.left, database, mask, err) != 0)
+            return -1;
+
+        quint8* data = mask.data();
+
+        runInChunks(numRows, [data](const int begin, const int end)
+        {
+            for(int i = begin; i<end; ++i)
+                data[i] = quint8(isTrue - data[i]);
+        });
+
+        return 0;
+    }
+
+    case Node::Type::And:
+    case Node::Type::Or:
+    {
+        std::vector<quint8> rightMask(mask.size());
+
+        if(this->evaluate(*node.left, database, mask, err) != 0 || this->evaluate(*node.right, database, rightMask, err) != 0)
+            return -1;
+
+        quint8* data = mask.data();
+        const quint8* rightData = rightMask.data();
+
+        if(node.type == Node::Type::And)
+        {
+            runInChunks(numRows, [data, rightData](const int begin, const int end)
+            {
+                for(int i = begin; i<end; ++i)
+                    data[i] = qMin(data[i], rightData[i]);
+            });
+        }
+        else
+        {
+            runInChunks(numRows, [data, rightData](const int begin, const int end)
+            {
+                for(int i = begin; i<end; ++i)
+                    data[i] = qMax(data[i], rightData[i]);
+            });
+        }
+
+        return 0;
+    }
+    }
+
+    return 0;
+}
+
+
+int ComponentQuery::evaluateComparison(const Node& node, const ComponentDatabase& database, std::vector<quint8>& mask, QString& err) const
+{
+    const int numRows = int(mask.size());
+
+    quint8* data = mask.data();
+
+    auto col = database.getAttributeIndex(node.attribute);
+
+    const bool isIDColumn = col == -1 && node.attribute.compare("ID", Qt::CaseInsensitive) == 0;
+
+    if(col == -1 && !isIDColumn)
+    {
+        err = "Error in the query, the attribute " + node.attribute + " could not be found";
+        return -1;
+    }
+
+    // Compare a text column by working out the result for each of its distinct strings, then looking up the result of each row
+    if(!isIDColumn && database.getStringIndexColumn(col) != nullptr)
+    {
+        const auto& strings = *database.getColumnStrings(col);
+        const quint32* indexes = database.getStringIndexColumn(col)->data();
+
+        // Index 0 is the null string, whose comparisons are unknown
+        std::vector<quint8> matches(strings.size(), isFalse);
+        matches[0] = isUnknown;
+
+        for(int i = 1; i<strings.size(); ++i)
+        {
+            if(node.type == Node::Type::Compare)
+            {
+                matches[i] = matchesValue(strings.at(i), node.op, node.values.front()) ? isTrue : isFalse;
+            }
+            else
+            {
+                for(auto&& value : node.values)
+                {
+                    if(matchesValue(strings.at(i), Node::Operator::Equal, value))
+                    {
+                        matches[i] = isTrue;
+                        break;
+                    }
+                }
+            }
+        }
+
+        const quint8* matchData = matches.data();
+
+        runInChunks(numRows, [indexes, matchData, data](const int begin, const int end)
+        {
+            for(int i = begin; i<end; ++i)
+                data[i] = matchData[indexes[i]];
+        });
+
+        return 0;
+    }
+
+    // Otherwise the column holds numbers, so the values need to be numbers as well
+    std::vector<double> numbers;
+    numbers.reserve(node.values.size());
+
+    for(auto&& value : node.values)
+    {
+        if(value.isNumber)
+        {
+            numbers.push_back(value.number);
+            continue;
+        }
+
+        bool OK = false;
+        auto number = value.text.toDouble(&OK);
+
+        if(!OK)
+        {
+            err = "Error in the query, the attribute " + node.attribute + " holds numbers and cannot be compared with the text '" + value.text + "'";
+            return -1;
+        }
+
+        numbers.push_back(number);
+    }
+
+    if(isIDColumn)
+    {
+        const int* IDs = database.getComponentIDs().data();
+
+        if(node.type == Node::Type::Compare)
+            compareColumn(IDs, numRows, node.op, numbers.front(), data);
+        else
+            columnInList(IDs, numRows, numbers, data);
+    }
+    else
+    {
+        const double* values = database.getNumberColumn(col)->data();
+
+        if(node.type == Node::Type::Compare)
+            compareColumn(values, numRows, node.op, numbers.front(), data);
+        else
+            columnInList(values, numRows, numbers, data);
+    }
+
+    return 0;
+}
@@ -0,0 +1,92 @@
+#ifndef COMPONENTQUERY_H
+#define COMPONENTQUERY_H
+/* *****************************************************************************
+Copyright (c) 2016-2021, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+// Written by: Stevan Gavrilovic
+
+// Selects components by a query on their attributes, e.g., YearBuilt < 1970 and NumberOfStories >= 4 and OccupancyClass = 'RES1'
+//
+// A query is made of comparisons of an attribute with a value, using <, <=, >, >=, = or !=, or of tests that an attribute is in a list of
+// values, e.g., OccupancyClass in ('RES1', 'RES3'). These are joined with and, or and not, and grouped with parentheses. Values are
+// numbers or text, where text is put in quotes unless it is a single word. Attribute names that are not a single word are put in quotes
+// The component ID can be queried as the attribute ID. Null values never match a comparison, and as in SQL this holds under not as well,
+// e.g., not (YearBuilt < 1970) does not select the components that have no YearBuilt
+//
+// The query is parsed once into a tree. When it is run, each comparison is a loop over a whole attribute column that is split into chunks
+// on the thread pool, and the results of the comparisons are combined into a bitmap that has one byte per row of the database
+
+#include "IntervalSet.h"
+
+#include <QString>
+
+#include <memory>
+#include <vector>
+
+class ComponentDatabase;
+
+class ComponentQuery
+{
+public:
+    ComponentQuery();
+    ~ComponentQuery();
+
+    // Parses the query, returns 0 on success
+    int parse(const QString& query, QString& err);
+
+    QString getQuery(void) const;
+
+    // Runs the query over the database. The selection is resized to the number of rows in the database, and each row is set to 1 if the
+    // component matches the query or 0 if it does not. Returns 0 on success
+    int run(const ComponentDatabase& database, std::vector<quint8>& selection, QString& err) const;
+
+    // Runs the query and returns the IDs of the components that match
+    int select(const ComponentDatabase& database, IntervalSet& selectedIDs, QString& err) const;
+
+    struct Node;
+
+private:
+
+    int evaluate(const Node& node, const ComponentDatabase& database, std::vector<quint8>& mask, QString& err) const;
+
+    int evaluateComparison(const Node& node, const ComponentDatabase& database, std::vector<quint8>& mask, QString& err) const;
+
+    QString queryText;
+
+    std::unique_ptr<Node> root;
+};
+
+#endif // COMPONENTQUERY_H
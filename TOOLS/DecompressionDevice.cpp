@@ -0,0 +1,588 @@
+/* *****************************************************************************
+Copyright (c) 2016-2021, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+// Written by: Stevan Gavrilovic
+
+#include "DecompressionDevice.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QThread>
+
+#include <cstring>
+#include <limits>
+
+#include <zlib.h>
+
+#ifdef INCLUDE_ZSTD
+#include <zstd.h>
+#endif
+
+DecompressionDevice::DecompressionDevice(const QString& pathToFile, const Format format) : QIODevice(), filePath(pathToFile), fileFormat(format)
+{
+
+}
+
+
+DecompressionDevice::~DecompressionDevice()
+{
+    this->stopThread();
+}
+
+
+DecompressionDevice::Format DecompressionDevice::detectFormat(const QString& pathToFile)
+{
+    QFile file(pathToFile);
+
+    if (!file.open(QIODevice::ReadOnly))
+        return Format::None;
+
+    auto magic = file.read(4);
+
+    if(magic.size() >= 2 && uchar(magic[0]) == 0x1F && uchar(magic[1]) == 0x8B)
+        return Format::Gzip;
+
+    if(magic.size() == 4 && uchar(magic[0]) == 0x28 && uchar(magic[1]) == 0xB5 && uchar(magic[2]) == 0x2F && uchar(magic[3]) == 0xFD)
+        return Format::Zstd;
+
+    return Format::None;
+}
+
+
+std::unique_ptr<QIODevice> DecompressionDevice::openFile(const QString& pathToFile, QString& err)
+{
+    auto format = detectFormat(pathToFile);
+
+    std::unique_ptr<QIODevice> device;
+
+    if(format == Format::None)
+        device = std::make_unique<QFile>(pathToFile);
+    else
+        device = std::make_unique<DecompressionDevice>(pathToFile, format);
+
+    if (!device->open(QIODevice::ReadOnly))
+    {
+        err = "Cannot open the file: " + pathToFile + "\nCheck your directory and try again.";
+
+        if(!device->errorString().isEmpty())
+            err += "\n" + device->errorString();
+
+        return nullptr;
+    }
+
+    return device;
+}
+
+
+int DecompressionDevice::readFile(const QString& pathToFile, QByteArray& data, QString& err)
+{
+    auto device = openFile(pathToFile, err);
+
+    if(device == nullptr)
+        return -1;
+
+    data = device->readAll();
+
+    // A decompression error shows up as a short read, so check whether the background thread failed
+    auto decompressor = dynamic_cast<DecompressionDevice*>(device.get());
+
+    if(decompressor != nullptr && decompressor->hasFailed())
+    {
+        err = "Error reading the file: " + pathToFile + "\n" + device->errorString();
+        data.clear();
+        return -1;
+    }
+
+    return 0;
+}
+
+
+bool DecompressionDevice::open(OpenMode mode)
+{
+    if(mode & QIODevice::WriteOnly)
+    {
+        this->setErrorString("Compressed files can only be opened for reading");
+        return false;
+    }
+
+    if(fileFormat == Format::None)
+    {
+        this->setErrorString("The file is not compressed");
+        return false;
+    }
+
+#ifndef INCLUDE_ZSTD
+    if(fileFormat == Format::Zstd)
+    {
+        this->setErrorString("This build does not support zstd compressed files");
+        return false;
+    }
+#endif
+
+    QFileInfo fileInfo(filePath);
+
+    if(!fileInfo.isFile() || !fileInfo.isReadable())
+    {
+        this->setErrorString("Cannot read the file " + filePath);
+        return false;
+    }
+
+    compressedSize = fileInfo.size();
+    compressedBytesRead = 0;
+
+    blockQueue.clear();
+    currentBlock.clear();
+    currentPos = 0;
+    isFinished = false;
+    isCancelled = false;
+    decompressError.clear();
+
+    // The output is already buffered in blocks, so skip the buffer in QIODevice
+    QIODevice::open(mode | QIODevice::Unbuffered);
+
+    theThread.reset(QThread::create([this](){ this->decompress(); }));
+    theThread->start();
+
+    return true;
+}
+
+
+void DecompressionDevice::close(void)
+{
+    this->stopThread();
+
+    blockQueue.clear();
+    currentBlock.clear();
+    currentPos = 0;
+
+    QIODevice::close();
+}
+
+
+void DecompressionDevice::stopThread(void)
+{
+    if(theThread == nullptr)
+        return;
+
+    {
+        QMutexLocker locker(&queueMutex);
+        isCancelled = true;
+        blockRemoved.wakeAll();
+    }
+
+    theThread->wait();
+    theThread.reset();
+}
+
+
+bool DecompressionDevice::isSequential(void) const
+{
+    return true;
+}
+
+
+bool DecompressionDevice::atEnd(void) const
+{
+    QMutexLocker locker(&queueMutex);
+
+    return isFinished && blockQueue.isEmpty() && currentPos >= currentBlock.size();
+}
+
+
+qint64 DecompressionDevice::bytesAvailable(void) const
+{
+    QMutexLocker locker(&queueMutex);
+
+    qint64 numBytes = currentBlock.size() - currentPos;
+
+    for(auto&& block : blockQueue)
+        numBytes += block.size();
+
+    return numBytes + QIODevice::bytesAvailable();
+}
+
+
+bool DecompressionDevice::hasFailed(void) const
+{
+    QMutexLocker locker(&queueMutex);
+
+    return !decompressError.isEmpty();
+}
+
+
+qint64 DecompressionDevice::getCompressedBytesRead(void) const
+{
+    return compressedBytesRead;
+}
+
+
+qint64 DecompressionDevice::getCompressedSize(void) const
+{
+    return compressedSize;
+}
+
+
+qint64 DecompressionDevice::readData(char* data, qint64 maxSize)
+{
+    qint64 numRead = 0;
+
+    while(numRead < maxSize)
+    {
+        if(currentPos >= currentBlock.size())
+        {
+            QMutexLocker locker(&queueMutex);
+
+            // Wait for the next block unless something was already read, in which case return what there is
+            while(blockQueue.isEmpty() && !isFinished)
+            {
+                if(numRead > 0)
+                    return numRead;
+
+                blockAdded.wait(&queueMutex);
+            }
+
+            if(blockQueue.isEmpty())
+            {
+                if(!decompressError.isEmpty())
+                {
+                    this->setErrorString(decompressError);
+
+                    if(numRead == 0)
+                        return -1;
+                }
+
+                return numRead;
+            }
+
+            currentBlock = blockQueue.dequeue();
+            currentPos = 0;
+
+            blockRemoved.wakeAll();
+        }
+
+        auto numToCopy = qMin(maxSize - numRead, qint64(currentBlock.size() - currentPos));
+
+        std::memcpy(data + numRead, currentBlock.constData() + currentPos, numToCopy);
+
+        numRead += numToCopy;
+        currentPos += static_cast<int>(numToCopy);
+    }
+
+    return numRead;
+}
+
+
+qint64 DecompressionDevice::writeData(const char* /*data*/, qint64 /*maxSize*/)
+{
+    return -1;
+}
+
+
+bool DecompressionDevice::pushBlock(QByteArray&& block)
+{
+    QMutexLocker locker(&queueMutex);
+
+    while(blockQueue.size() >= maxQueuedBlocks && !isCancelled)
+        blockRemoved.wait(&queueMutex);
+
+    if(isCancelled)
+        return false;
+
+    blockQueue.enqueue(std::move(block));
+
+    blockAdded.wakeAll();
+
+    return true;
+}
+
+
+void DecompressionDevice::decompress(void)
+{
+    QString err;
+
+    QFile file(filePath);
+
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        err = "Cannot open the file: " + filePath;
+    }
+    else
+    {
+        if(fileFormat == Format::Gzip)
+            this->decompressGzip(file, err);
+        else if(fileFormat == Format::Zstd)
+            this->decompressZstd(file, err);
+    }
+
+    QMutexLocker locker(&queueMutex);
+
+    decompressError = err;
+    isFinished = true;
+
+    blockAdded.wakeAll();
+}
+
+
+bool DecompressionDevice::decompressGzip(QFile& file, QString& err)
+{
+    z_stream stream;
+    std::memset(&stream, 0, sizeof(z_stream));
+
+    // Adding 32 to the window bits detects either a gzip or a zlib header
+    if(inflateInit2(&stream, 15 + 32) != Z_OK)
+    {
+        err = "Could not initialize the gzip decompression";
+        return false;
+    }
+
+    QByteArray input(readSize, Qt::Uninitialized);
+    QByteArray output(blockSize, Qt::Uninitialized);
+
+    stream.next_out = reinterpret_cast<Bytef*>(output.data());
+    stream.avail_out = blockSize;
+
+    bool ok = true;
+    bool atStreamEnd = false;
+    bool atEndOfFile = false;
+
+    while(ok)
+    {
+        // Zeros after the end of a member are padding, e.g., from a tape archive, rather than the start of another member
+        if(atStreamEnd)
+        {
+            while(stream.avail_in > 0 && *stream.next_in == 0)
+            {
+                ++stream.next_in;
+                --stream.avail_in;
+            }
+        }
+
+        if(stream.avail_in == 0 && !atEndOfFile)
+        {
+            auto numRead = file.read(input.data(), readSize);
+
+            if(numRead < 0)
+            {
+                err = "Error reading the file: " + filePath;
+                ok = false;
+                break;
+            }
+
+            if(numRead == 0)
+            {
+                atEndOfFile = true;
+            }
+            else
+            {
+                compressedBytesRead += numRead;
+
+                stream.next_in = reinterpret_cast<Bytef*>(input.data());
+                stream.avail_in = static_cast<uInt>(numRead);
+            }
+
+            continue;
+        }
+
+        // A file can be made of several gzip members one after the other
+        if(atStreamEnd)
+        {
+            // Only padding was left after the last member
+            if(stream.avail_in == 0)
+                break;
+
+            inflateReset(&stream);
+            atStreamEnd = false;
+        }
+
+        const auto availInBefore = stream.avail_in;
+        const auto availOutBefore = stream.avail_out;
+
+        auto res = inflate(&stream, Z_NO_FLUSH);
+
+        if(res == Z_STREAM_END)
+        {
+            atStreamEnd = true;
+        }
+        else if(res != Z_OK && res != Z_BUF_ERROR)
+        {
+            err = "Error decompressing the file " + filePath + ": " + QString(stream.msg != nullptr ? stream.msg : "corrupt data");
+            ok = false;
+            break;
+        }
+
+        // After the end of the file, inflate keeps going without input while it still has output buffered from the last input, e.g., when
+        // the output block filled up. The data is only cut short if the member has not ended and inflate cannot make any more progress
+        if(atEndOfFile && !atStreamEnd && stream.avail_in == availInBefore && stream.avail_out == availOutBefore)
+        {
+            err = "The file " + filePath + " ended before the end of the compressed data";
+            ok = false;
+            break;
+        }
+
+        if(stream.avail_out == 0)
+        {
+            // The device was closed before the end of the file
+            if(!this->pushBlock(std::move(output)))
+            {
+                ok = false;
+                break;
+            }
+
+            output = QByteArray(blockSize, Qt::Uninitialized);
+            stream.next_out = reinterpret_cast<Bytef*>(output.data());
+            stream.avail_out = blockSize;
+        }
+    }
+
+    // Push out the last partial block
+    if(ok && stream.avail_out != uInt(blockSize))
+    {
+        output.resize(blockSize - static_cast<int>(stream.avail_out));
+        this->pushBlock(std::move(output));
+    }
+
+    inflateEnd(&stream);
+
+    return ok;
+}
+
+
+bool DecompressionDevice::decompressZstd(QFile& file, QString& err)
+{
+#ifdef INCLUDE_ZSTD
+    auto stream = ZSTD_createDStream();
+
+    if(stream == nullptr)
+    {
+        err = "Could not initialize the zstd decompression";
+        return false;
+    }
+
+    ZSTD_initDStream(stream);
+
+    QByteArray input(readSize, Qt::Uninitialized);
+    QByteArray output(blockSize, Qt::Uninitialized);
+
+    ZSTD_inBuffer inBuffer = {input.constData(), 0, 0};
+    ZSTD_outBuffer outBuffer = {output.data(), size_t(blockSize), 0};
+
+    bool ok = true;
+    bool atEndOfFile = false;
+
+    // Zero once a frame has been completely decoded and flushed, the file can hold several frames one after the other
+    size_t remaining = 0;
+
+    while(ok)
+    {
+        if(inBuffer.pos == inBuffer.size && !atEndOfFile)
+        {
+            auto numRead = file.read(input.data(), readSize);
+
+            if(numRead < 0)
+            {
+                err = "Error reading the file: " + filePath;
+                ok = false;
+                break;
+            }
+
+            if(numRead == 0)
+            {
+                atEndOfFile = true;
+            }
+            else
+            {
+                compressedBytesRead += numRead;
+
+                inBuffer = {input.constData(), size_t(numRead), 0};
+            }
+
+            continue;
+        }
+
+        // The last frame is complete
+        if(atEndOfFile && remaining == 0)
+            break;
+
+        const auto inPosBefore = inBuffer.pos;
+        const auto outPosBefore = outBuffer.pos;
+
+        remaining = ZSTD_decompressStream(stream, &outBuffer, &inBuffer);
+
+        if(ZSTD_isError(remaining))
+        {
+            err = "Error decompressing the file " + filePath + ": " + QString(ZSTD_getErrorName(remaining));
+            ok = false;
+            break;
+        }
+
+        // After the end of the file, the decoder keeps flushing the output that it still holds, e.g., when the output block filled up
+        // The data is only cut short if the frame is not done and the decoder cannot make any more progress
+        if(atEndOfFile && remaining != 0 && inBuffer.pos == inPosBefore && outBuffer.pos == outPosBefore)
+        {
+            err = "The file " + filePath + " ended before the end of the compressed data";
+            ok = false;
+            break;
+        }
+
+        if(outBuffer.pos == outBuffer.size)
+        {
+            // The device was closed before the end of the file
+            if(!this->pushBlock(std::move(output)))
+            {
+                ok = false;
+                break;
+            }
+
+            output = QByteArray(blockSize, Qt::Uninitialized);
+            outBuffer = {output.data(), size_t(blockSize), 0};
+        }
+    }
+
+    if(ok && outBuffer.pos != 0)
+    {
+        output.resize(static_cast<int>(outBuffer.pos));
+        this->pushBlock(std::move(output));
+    }
+
+    ZSTD_freeDStream(stream);
+
+    return ok;
+#else
+    Q_UNUSED(file);
+    err = "This build does not support zstd compressed files";
+    return false;
+#endif
+}
@@ -0,0 +1,140 @@
+#ifndef DECOMPRESSIONDEVICE_H
+#define DECOMPRESSIONDEVICE_H
+/* *****************************************************************************
+Copyright (c) 2016-2021, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+// Written by: Stevan Gavrilovic
+
+// Reads a gzip or zstd compressed file as if it were the uncompressed file. The format is detected from the magic bytes at the start of the
+// file, not from the extension. The file is read and decompressed on a background thread into a small queue of blocks, so that the
+// decompression overlaps with whatever is parsing the output
+
+#include <QIODevice>
+#include <QMutex>
+#include <QQueue>
+#include <QWaitCondition>
+
+#include <atomic>
+#include <memory>
+
+class QFile;
+class QThread;
+
+class DecompressionDevice : public QIODevice
+{
+public:
+
+    enum class Format { None, Gzip, Zstd };
+
+    DecompressionDevice(const QString& pathToFile, const Format format);
+    ~DecompressionDevice() override;
+
+    // Returns the compression format of the file from its first bytes, or None if the file is not compressed or cannot be read
+    static Format detectFormat(const QString& pathToFile);
+
+    // Opens the file for reading. Returns a QFile if the file is not compressed, otherwise a device that decompresses it on the fly
+    // Returns nullptr and sets err if the file cannot be opened
+    static std::unique_ptr<QIODevice> openFile(const QString& pathToFile, QString& err);
+
+    // Reads the whole file into data, decompressing it if needed. Returns 0 on success
+    static int readFile(const QString& pathToFile, QByteArray& data, QString& err);
+
+    // Starts the decompression thread, only ReadOnly is supported
+    bool open(OpenMode mode) override;
+    void close(void) override;
+
+    bool isSequential(void) const override;
+    bool atEnd(void) const override;
+    qint64 bytesAvailable(void) const override;
+
+    // Returns true if the decompression failed, the error is given by errorString() once the output has been read
+    bool hasFailed(void) const;
+
+    // The number of bytes of the compressed file read so far and its total size, for progress reporting
+    qint64 getCompressedBytesRead(void) const;
+    qint64 getCompressedSize(void) const;
+
+protected:
+
+    qint64 readData(char* data, qint64 maxSize) override;
+    qint64 writeData(const char* data, qint64 maxSize) override;
+
+private:
+
+    // Runs on the background thread, reads the file and pushes the decompressed blocks onto the queue
+    void decompress(void);
+    bool decompressGzip(QFile& file, QString& err);
+    bool decompressZstd(QFile& file, QString& err);
+
+    // Adds a block to the queue, waiting if the queue is full. Returns false if the device was closed in the meantime
+    bool pushBlock(QByteArray&& block);
+
+    // Stops the background thread and waits for it to finish
+    void stopThread(void);
+
+    QString filePath;
+    Format fileFormat;
+
+    std::unique_ptr<QThread> theThread;
+
+    mutable QMutex queueMutex;
+    QWaitCondition blockAdded;
+    QWaitCondition blockRemoved;
+
+    // Decompressed blocks waiting to be read, and the block being read from
+    QQueue<QByteArray> blockQueue;
+    QByteArray currentBlock;
+    int currentPos = 0;
+
+    // Set by the background thread when it is done, with the error if it failed
+    bool isFinished = false;
+    QString decompressError;
+
+    // Set when the device is closed before the background thread is done
+    bool isCancelled = false;
+
+    std::atomic<qint64> compressedBytesRead{0};
+    qint64 compressedSize = 0;
+
+    // The size of the reads from the compressed file and of the decompressed blocks
+    static constexpr int readSize = 1 << 18;
+    static constexpr int blockSize = 1 << 20;
+
+    // The number of decompressed blocks that can be waiting before the background thread pauses
+    static constexpr int maxQueuedBlocks = 8;
+};
+
+#endif // DECOMPRESSIONDEVICE_H
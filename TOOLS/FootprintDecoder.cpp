@@ -0,0 +1,552 @@
+/* *****************************************************************************
+Copyright (c) 2016-2021, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+// Written by: Stevan Gavrilovic
+
+#include "FootprintDecoder.h"
+#include "CSVTable.h"
+#include "GeoJsonReader.h"
+
+#include <QtEndian>
+
+#include <cstring>
+
+namespace
+{
+
+// The deepest coordinate array of a footprint, i.e., that of a multipolygon
+const int maxCoordinateDepth = 4;
+
+// The well-known binary geometry types, and the flags that some writers add to them
+const quint32 wkbPolygon = 3;
+const quint32 wkbMultiPolygon = 6;
+const quint32 ewkbZFlag = 0x80000000;
+const quint32 ewkbMFlag = 0x40000000;
+const quint32 ewkbSRIDFlag = 0x20000000;
+
+
+// Parses a nested array of coordinates from the characters of a footprint
+class CoordinateArrayParser
+{
+public:
+    CoordinateArrayParser(const QChar* data, const int size, std::vector<char>& numberBytes, GeoJsonFeature& polygon)
+        : data(data), size(size), numberBytes(numberBytes), polygon(polygon) {}
+
+    // Returns the next character that is not white space without taking it, or 0 at the end of the input
+    ushort peek(void)
+    {
+        while(pos < size && data[pos].isSpace())
+            ++pos;
+
+        return pos < size ? data[pos].unicode() : 0;
+    }
+
+    bool expect(const ushort c)
+    {
+        if(this->peek() != c)
+            return false;
+
+        ++pos;
+        return true;
+    }
+
+    // Reads an array at the given nesting level and sets depth to the depth of the array, i.e., 1 for a position, 2 for a ring and so on
+    // The first point of each ring is recorded as the start of a part
+    int readArray(const int level, int& depth, QString& err)
+    {
+        if(level > maxCoordinateDepth)
+        {
+            err = "the coordinate arrays are nested too deeply";
+            return -1;
+        }
+
+        if(!this->expect('['))
+        {
+            err = this->errorAt("expected '['");
+            return -1;
+        }
+
+        if(this->peek() != '[')
+        {
+            depth = 1;
+            return this->readPosition(err);
+        }
+
+        const int firstPoint = int(polygon.coordinates.size()/2);
+
+        depth = 0;
+
+        while(true)
+        {
+            int childDepth = 0;
+
+            if(this->readArray(level + 1, childDepth, err) != 0)
+                return -1;
+
+            if(depth == 0)
+            {
+                depth = childDepth + 1;
+
+                if(childDepth == 1)
+                    polygon.partStarts.push_back(firstPoint);
+            }
+            else if(childDepth + 1 != depth)
+            {
+                err = this->errorAt("the coordinate arrays are not nested evenly");
+                return -1;
+            }
+
+            if(this->expect(','))
+                continue;
+
+            if(this->expect(']'))
+                return 0;
+
+            err = this->errorAt("expected ',' or ']'");
+            return -1;
+        }
+    }
+
+    QString errorAt(const QString& msg) const
+    {
+        return msg + " at character " + QString::number(pos);
+    }
+
+    int pos = 0;
+
+private:
+
+    // Reads the numbers of a position after its opening bracket, only the x and y are kept
+    int readPosition(QString& err)
+    {
+        int numValues = 0;
+
+        while(true)
+        {
+            double val = 0.0;
+
+            if(this->readNumber(val, err) != 0)
+                return -1;
+
+            if(numValues < 2)
+                polygon.coordinates.push_back(val);
+
+            ++numValues;
+
+            if(this->expect(','))
+                continue;
+
+            if(this->expect(']'))
+                break;
+
+            err = this->errorAt("expected ',' or ']'");
+            return -1;
+        }
+
+        if(numValues < 2)
+        {
+            err = this->errorAt("a position needs at least two values");
+            return -1;
+        }
+
+        return 0;
+    }
+
+    int readNumber(double& val, QString& err)
+    {
+        this->peek();
+
+        numberBytes.clear();
+
+        while(pos < size)
+        {
+            const ushort c = data[pos].unicode();
+
+            if((c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E')
+            {
+                numberBytes.push_back(char(c));
+                ++pos;
+            }
+            else
+            {
+                break;
+            }
+        }
+
+        bool OK = false;
+
+        // Use the fast conversion of the CSV reader
+        val = CSVField(numberBytes.data(), int(numberBytes.size()), false).toDouble(&OK);
+
+        if(!OK)
+        {
+            err = this->errorAt("expected a number");
+            return -1;
+        }
+
+        return 0;
+    }
+
+    const QChar* data;
+    const int size;
+
+    std::vector<char>& numberBytes;
+    GeoJsonFeature& polygon;
+};
+
+
+// Reads the values of a well-known binary geometry, with bounds checks on every read
+class WKBReader
+{
+public:
+    WKBReader(const char* data, const int size, GeoJsonFeature& polygon) : data(data), size(size), polygon(polygon) {}
+
+    // Reads a polygon or a multipolygon, the polygons of a multipolygon must not themselves be multipolygons
+    int readGeometry(const bool isMember, QString& err)
+    {
+        quint32 type = 0;
+        int numDims = 2;
+
+        if(this->readHeader(type, numDims, err) != 0)
+            return -1;
+
+        if(type == wkbPolygon)
+            return this->readPolygon(numDims, err);
+
+        if(type == wkbMultiPolygon && !isMember)
+        {
+            isMulti = true;
+
+            quint32 numPolygons = 0;
+
+            if(this->readUInt32(numPolygons, err) != 0)
+                return -1;
+
+            for(quint32 i = 0; i<numPolygons; ++i)
+            {
+                if(this->readGeometry(true, err) != 0)
+                    return -1;
+            }
+
+            return 0;
+        }
+
+        err = "unsupported geometry type " + QString::number(type) + " in the well-known binary, only polygons and multipolygons are supported";
+        return -1;
+    }
+
+    bool atEnd(void) const
+    {
+        return pos == size;
+    }
+
+    bool isMultiPolygon(void) const
+    {
+        return isMulti;
+    }
+
+private:
+
+    // Reads the byte order and the type, the type is returned without its dimension flags
+    int readHeader(quint32& type, int& numDims, QString& err)
+    {
+        if(pos >= size)
+        {
+            err = "the well-known binary ends early";
+            return -1;
+        }
+
+        const char byteOrder = data[pos++];
+
+        if(byteOrder != 0 && byteOrder != 1)
+        {
+            err = "invalid byte order in the well-known binary";
+            return -1;
+        }
+
+        littleEndian = byteOrder == 1;
+
+        quint32 rawType = 0;
+
+        if(this->readUInt32(rawType, err) != 0)
+            return -1;
+
+        // Extended well-known binary puts the dimensions and SRID in flags, ISO well-known binary adds 1000, 2000 or 3000 to the type
+        bool hasZ = rawType & ewkbZFlag;
+        bool hasM = rawType & ewkbMFlag;
+
+        if(rawType & ewkbSRIDFlag)
+        {
+            quint32 SRID = 0;
+
+            if(this->readUInt32(SRID, err) != 0)
+                return -1;
+        }
+
+        rawType &= ~(ewkbZFlag | ewkbMFlag | ewkbSRIDFlag);
+
+        const quint32 isoDims = rawType / 1000;
+
+        hasZ = hasZ || isoDims == 1 || isoDims == 3;
+        hasM = hasM || isoDims == 2 || isoDims == 3;
+
+        type = rawType % 1000;
+        numDims = 2 + (hasZ ? 1 : 0) + (hasM ? 1 : 0);
+
+        return 0;
+    }
+
+    int readPolygon(const int numDims, QString& err)
+    {
+        quint32 numRings = 0;
+
+        if(this->readUInt32(numRings, err) != 0)
+            return -1;
+
+        for(quint32 i = 0; i<numRings; ++i)
+        {
+            quint32 numPoints = 0;
+
+            if(this->readUInt32(numPoints, err) != 0)
+                return -1;
+
+            // Check the size up front so that a corrupt count does not make a huge allocation
+            if(qint64(numPoints)*numDims*8 > qint64(size - pos))
+            {
+                err = "the well-known binary ends early";
+                return -1;
+            }
+
+            polygon.partStarts.push_back(int(polygon.coordinates.size()/2));
+            polygon.coordinates.reserve(polygon.coordinates.size() + 2*numPoints);
+
+            for(quint32 j = 0; j<numPoints; ++j)
+            {
+                polygon.coordinates.push_back(this->readDouble());
+                polygon.coordinates.push_back(this->readDouble());
+
+                // Skip the Z and M values
+                pos += 8*(numDims - 2);
+            }
+        }
+
+        return 0;
+    }
+
+    int readUInt32(quint32& val, QString& err)
+    {
+        if(size - pos < 4)
+        {
+            err = "the well-known binary ends early";
+            return -1;
+        }
+
+        val = littleEndian ? qFromLittleEndian<quint32>(data + pos) : qFromBigEndian<quint32>(data + pos);
+        pos += 4;
+
+        return 0;
+    }
+
+    // The caller checks that there are enough bytes
+    double readDouble(void)
+    {
+        const quint64 bits = littleEndian ? qFromLittleEndian<quint64>(data + pos) : qFromBigEndian<quint64>(data + pos);
+        pos += 8;
+
+        double val;
+        std::memcpy(&val, &bits, sizeof(val));
+
+        return val;
+    }
+
+    const char* data;
+    const int size;
+    int pos = 0;
+
+    bool littleEndian = true;
+    bool isMulti = false;
+
+    GeoJsonFeature& polygon;
+};
+
+
+int hexValue(const ushort c)
+{
+    if(c >= '0' && c <= '9')
+        return c - '0';
+
+    if(c >= 'a' && c <= 'f')
+        return c - 'a' + 10;
+
+    if(c >= 'A' && c <= 'F')
+        return c - 'A' + 10;
+
+    return -1;
+}
+
+}
+
+
+FootprintDecoder::FootprintDecoder()
+{
+
+}
+
+
+int FootprintDecoder::decode(const QString& footprint, GeoJsonFeature& polygon, QString& err)
+{
+    polygon.clear();
+
+    const QChar* data = footprint.constData();
+    int size = footprint.size();
+
+    // Trim the white space and any quotes around the footprint
+    while(size > 0 && (data->isSpace() || *data == '"'))
+    {
+        ++data;
+        --size;
+    }
+
+    while(size > 0 && (data[size-1].isSpace() || data[size-1] == '"'))
+        --size;
+
+    if(size == 0)
+    {
+        err = "The footprint is empty";
+        return -1;
+    }
+
+    if(*data == '[')
+        return this->decodeCoordinateArray(data, size, polygon, err);
+
+    return this->decodeHexWKB(data, size, polygon, err);
+}
+
+
+int FootprintDecoder::decodeWKB(const char* data, const int size, GeoJsonFeature& polygon, QString& err)
+{
+    polygon.clear();
+
+    WKBReader reader(data, size, polygon);
+
+    if(reader.readGeometry(false, err) != 0)
+    {
+        err = "Error decoding the footprint, " + err;
+        return -1;
+    }
+
+    if(!reader.atEnd())
+    {
+        err = "Error decoding the footprint, there are extra bytes after the geometry in the well-known binary";
+        return -1;
+    }
+
+    if(polygon.partStarts.empty())
+    {
+        err = "The footprint is empty";
+        return -1;
+    }
+
+    // Match the type and depth of the same footprint as a coordinate array, a polygon with holes is still a polygon
+    polygon.geometryType = reader.isMultiPolygon() ? "MultiPolygon" : "Polygon";
+    polygon.coordinateDepth = reader.isMultiPolygon() ? maxCoordinateDepth : 3;
+    polygon.partStarts.push_back(int(polygon.coordinates.size()/2));
+
+    return 0;
+}
+
+
+int FootprintDecoder::decodeCoordinateArray(const QChar* data, const int size, GeoJsonFeature& polygon, QString& err)
+{
+    CoordinateArrayParser parser(data, size, numberBytes, polygon);
+
+    int depth = 0;
+
+    if(parser.readArray(1, depth, err) != 0)
+    {
+        err = "Error decoding the footprint, " + err;
+        return -1;
+    }
+
+    if(parser.peek() != 0)
+    {
+        err = "Error decoding the footprint, " + parser.errorAt("unexpected characters after the coordinates");
+        return -1;
+    }
+
+    // A bare ring is treated as a polygon with one ring
+    if(depth < 2)
+    {
+        err = "Error decoding the footprint, expected an array of points";
+        return -1;
+    }
+
+    polygon.geometryType = depth == maxCoordinateDepth ? "MultiPolygon" : "Polygon";
+    polygon.coordinateDepth = depth;
+    polygon.partStarts.push_back(int(polygon.coordinates.size()/2));
+
+    return 0;
+}
+
+
+int FootprintDecoder::decodeHexWKB(const QChar* data, const int size, GeoJsonFeature& polygon, QString& err)
+{
+    if(size % 2 != 0)
+    {
+        err = "Error decoding the footprint, it is neither a coordinate array nor well-known binary in hex";
+        return -1;
+    }
+
+    wkbBytes.resize(size/2);
+
+    char* bytes = wkbBytes.data();
+
+    for(int i = 0; i<size; i += 2)
+    {
+        const int high = hexValue(data[i].unicode());
+        const int low = hexValue(data[i+1].unicode());
+
+        if(high == -1 || low == -1)
+        {
+            err = "Error decoding the footprint, it is neither a coordinate array nor well-known binary in hex";
+            return -1;
+        }
+
+        bytes[i/2] = char(high*16 + low);
+    }
+
+    return this->decodeWKB(wkbBytes.constData(), wkbBytes.size(), polygon, err);
+}
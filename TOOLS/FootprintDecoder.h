@@ -0,0 +1,77 @@
+#ifndef FOOTPRINTDECODER_H
+#define FOOTPRINTDECODER_H
+/* *****************************************************************************
+Copyright (c) 2016-2021, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+// Written by: Stevan Gavrilovic
+
+// Decodes the footprints of buildings straight into flat coordinates, without going through a json document. A footprint is either a
+// geojson coordinate array, i.e., a ring [[x,y],...], the rings of a polygon [[[x,y],...],...] or the polygons of a multipolygon, or a
+// polygon or multipolygon in the well-known binary format, given as hex text in the footprint column
+// The decoder keeps its buffers between calls, so use one decoder per thread and reuse it for the footprints of a batch
+
+#include <QByteArray>
+#include <QString>
+
+#include <vector>
+
+struct GeoJsonFeature;
+
+class FootprintDecoder
+{
+public:
+    FootprintDecoder();
+
+    // Decodes the footprint into the polygon, each ring becomes a part. The polygon is cleared first. Returns 0 on success
+    int decode(const QString& footprint, GeoJsonFeature& polygon, QString& err);
+
+    // Decodes a polygon or multipolygon in the well-known binary format, in either byte order. The Z and M values are dropped
+    int decodeWKB(const char* data, const int size, GeoJsonFeature& polygon, QString& err);
+
+private:
+
+    int decodeCoordinateArray(const QChar* data, const int size, GeoJsonFeature& polygon, QString& err);
+
+    int decodeHexWKB(const QChar* data, const int size, GeoJsonFeature& polygon, QString& err);
+
+    // The bytes of the number being read
+    std::vector<char> numberBytes;
+
+    // The binary of a hex footprint
+    QByteArray wkbBytes;
+};
+
+#endif // FOOTPRINTDECODER_H
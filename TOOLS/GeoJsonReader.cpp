@@ -0,0 +1,632 @@
+/* *****************************************************************************
+Copyright (c) 2016-2021, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+// Written by: Stevan Gavrilovic
+
+#include "GeoJsonReader.h"
+#include "CSVTable.h"
+#include "DecompressionDevice.h"
+
+#include <QIODevice>
+#include <QVariantList>
+
+#include <string>
+
+namespace
+{
+
+// Parses json from a device that is read in blocks
+class JsonStream
+{
+public:
+    JsonStream(QIODevice& device) : device(device) {}
+
+    // Returns the next character that is not white space without taking it, or 0 at the end of the input
+    char peek(void)
+    {
+        while(this->ensure())
+        {
+            const char c = data[pos];
+
+            if(c != ' ' && c != '\n' && c != '\r' && c != '\t')
+                return c;
+
+            ++pos;
+        }
+
+        return 0;
+    }
+
+    // Takes the next character that is not white space, it must be the given character
+    int expect(const char c, QString& err)
+    {
+        if(this->peek() != c)
+        {
+            err = this->errorAt(QString("expected a '") + c + "'");
+            return -1;
+        }
+
+        ++pos;
+
+        return 0;
+    }
+
+    // Takes the ',' between the items of an array or object, or the closing bracket. Sets isEnd if it was the closing bracket
+    int nextItem(const char closing, bool& isEnd, QString& err)
+    {
+        auto c = this->peek();
+
+        if(c == ',')
+        {
+            ++pos;
+            isEnd = false;
+            return 0;
+        }
+
+        if(c == closing)
+        {
+            ++pos;
+            isEnd = true;
+            return 0;
+        }
+
+        err = this->errorAt(QString("expected a ',' or a '") + closing + "'");
+        return -1;
+    }
+
+    // Reads the members of an object, readMember is called with the key of each member and must read its value
+    int readObject(const std::function<int(const QString& key)>& readMember, QString& err)
+    {
+        if(this->expect('{', err) != 0)
+            return -1;
+
+        if(this->peek() == '}')
+        {
+            ++pos;
+            return 0;
+        }
+
+        bool isEnd = false;
+        while(!isEnd)
+        {
+            QString key;
+            if(this->readString(key, err) != 0 || this->expect(':', err) != 0)
+                return -1;
+
+            if(readMember(key) != 0)
+                return -1;
+
+            if(this->nextItem('}', isEnd, err) != 0)
+                return -1;
+        }
+
+        return 0;
+    }
+
+    int readString(QString& str, QString& err)
+    {
+        if(this->expect('"', err) != 0)
+            return -1;
+
+        stringBytes.clear();
+
+        while(true)
+        {
+            if(!this->ensure())
+            {
+                err = this->errorAt("the string is not closed");
+                return -1;
+            }
+
+            // Take the characters up to the next quote or escape in one go
+            int runEnd = pos;
+            while(runEnd < size && data[runEnd] != '"' && data[runEnd] != '\\')
+                ++runEnd;
+
+            stringBytes.append(data + pos, runEnd - pos);
+            pos = runEnd;
+
+            if(pos == size)
+                continue;
+
+            if(data[pos++] == '"')
+                break;
+
+            if(this->readEscape(err) != 0)
+                return -1;
+        }
+
+        str = QString::fromUtf8(stringBytes.data(), int(stringBytes.size()));
+
+        return 0;
+    }
+
+    int readNumber(double& val, QString& err)
+    {
+        this->peek();
+
+        numberBytes.clear();
+
+        while(this->ensure())
+        {
+            const char c = data[pos];
+
+            if((c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E')
+            {
+                numberBytes.push_back(c);
+                ++pos;
+            }
+            else
+            {
+                break;
+            }
+        }
+
+        bool OK = false;
+
+        // Use the fast conversion of the CSV reader
+        val = CSVField(numberBytes.data(), int(numberBytes.size()), false).toDouble(&OK);
+
+        if(!OK)
+        {
+            err = this->errorAt("expected a number");
+            return -1;
+        }
+
+        return 0;
+    }
+
+    // Reads any json value, objects become maps and arrays become lists
+    int readValue(QVariant& val, QString& err)
+    {
+        auto c = this->peek();
+
+        if(c == '{')
+        {
+            QVariantMap map;
+
+            auto res = this->readObject([&](const QString& key)
+            {
+                QVariant member;
+                if(this->readValue(member, err) != 0)
+                    return -1;
+
+                map.insert(key, member);
+
+                return 0;
+            }, err);
+
+            val = map;
+
+            return res;
+        }
+
+        if(c == '[')
+        {
+            ++pos;
+
+            QVariantList list;
+
+            if(this->peek() == ']')
+            {
+                ++pos;
+                val = list;
+                return 0;
+            }
+
+            bool isEnd = false;
+            while(!isEnd)
+            {
+                QVariant item;
+                if(this->readValue(item, err) != 0)
+                    return -1;
+
+                list.append(item);
+
+                if(this->nextItem(']', isEnd, err) != 0)
+                    return -1;
+            }
+
+            val = list;
+
+            return 0;
+        }
+
+        if(c == '"')
+        {
+            QString str;
+            if(this->readString(str, err) != 0)
+                return -1;
+
+            val = str;
+
+            return 0;
+        }
+
+        if(c == 't' || c == 'f' || c == 'n')
+        {
+            std::string word;
+            while(this->ensure() && data[pos] >= 'a' && data[pos] <= 'z')
+                word.push_back(data[pos++]);
+
+            if(word == "true")
+                val = true;
+            else if(word == "false")
+                val = false;
+            else if(word == "null")
+                val = QVariant();
+            else
+            {
+                err = this->errorAt("unexpected word " + QString::fromStdString(word));
+                return -1;
+            }
+
+            return 0;
+        }
+
+        double number = 0.0;
+        if(this->readNumber(number, err) != 0)
+            return -1;
+
+        val = number;
+
+        return 0;
+    }
+
+    QString errorAt(const QString& msg) const
+    {
+        return "Error reading the geojson at byte " + QString::number(offset + pos) + ", " + msg;
+    }
+
+private:
+
+    // Makes sure that there is a character to read, reading the next block if needed. Returns false at the end of the input
+    bool ensure(void)
+    {
+        if(pos < size)
+            return true;
+
+        offset += size;
+
+        buffer = device.read(blockSize);
+        data = buffer.constData();
+        size = buffer.size();
+        pos = 0;
+
+        return size > 0;
+    }
+
+    int readEscape(QString& err)
+    {
+        if(!this->ensure())
+        {
+            err = this->errorAt("the string is not closed");
+            return -1;
+        }
+
+        const char c = data[pos++];
+
+        switch(c)
+        {
+        case '"': stringBytes.push_back('"'); return 0;
+        case '\\': stringBytes.push_back('\\'); return 0;
+        case '/': stringBytes.push_back('/'); return 0;
+        case 'b': stringBytes.push_back('\b'); return 0;
+        case 'f': stringBytes.push_back('\f'); return 0;
+        case 'n': stringBytes.push_back('\n'); return 0;
+        case 'r': stringBytes.push_back('\r'); return 0;
+        case 't': stringBytes.push_back('\t'); return 0;
+        case 'u': break;
+        default:
+            err = this->errorAt("unknown escape in a string");
+            return -1;
+        }
+
+        ushort units[2];
+        if(this->readHex(units[0], err) != 0)
+            return -1;
+
+        int numUnits = 1;
+
+        // A character outside of the basic plane is given as a pair of escapes
+        if(units[0] >= 0xD800 && units[0] < 0xDC00)
+        {
+            if(this->expect('\\', err) != 0 || this->expect('u', err) != 0 || this->readHex(units[1], err) != 0)
+                return -1;
+
+            numUnits = 2;
+        }
+
+        stringBytes.append(QString::fromUtf16(units, numUnits).toUtf8().constData());
+
+        return 0;
+    }
+
+    int readHex(ushort& unit, QString& err)
+    {
+        unit = 0;
+
+        for(int i = 0; i<4; ++i)
+        {
+            if(!this->ensure())
+            {
+                err = this->errorAt("the string is not closed");
+                return -1;
+            }
+
+            const char c = data[pos++];
+
+            int digit = -1;
+            if(c >= '0' && c <= '9')
+                digit = c - '0';
+            else if(c >= 'a' && c <= 'f')
+                digit = c - 'a' + 10;
+            else if(c >= 'A' && c <= 'F')
+                digit = c - 'A' + 10;
+
+            if(digit == -1)
+            {
+                err = this->errorAt("invalid unicode escape in a string");
+                return -1;
+            }
+
+            unit = ushort(unit*16 + digit);
+        }
+
+        return 0;
+    }
+
+    QIODevice& device;
+
+    QByteArray buffer;
+    const char* data = nullptr;
+    int size = 0;
+    int pos = 0;
+
+    // The position in the input of the start of the buffer
+    qint64 offset = 0;
+
+    // Kept between calls so that their memory is reused
+    std::string stringBytes;
+    std::string numberBytes;
+
+    static constexpr int blockSize = 1 << 20;
+};
+
+
+// Reads a coordinates array of any depth into the flat arrays of the feature, depth is set to the nesting depth of the array
+int readCoordinates(JsonStream& stream, GeoJsonFeature& feature, int& depth, QString& err)
+{
+    if(stream.expect('[', err) != 0)
+        return -1;
+
+    depth = 1;
+
+    if(stream.peek() == ']')
+    {
+        stream.expect(']', err);
+        return 0;
+    }
+
+    bool isEnd = false;
+
+    // A position, i.e., an array of numbers
+    if(stream.peek() != '[')
+    {
+        double position[2] = {0.0, 0.0};
+        int numValues = 0;
+
+        while(!isEnd)
+        {
+            double val = 0.0;
+            if(stream.readNumber(val, err) != 0)
+                return -1;
+
+            if(numValues < 2)
+                position[numValues] = val;
+
+            ++numValues;
+
+            if(stream.nextItem(']', isEnd, err) != 0)
+                return -1;
+        }
+
+        if(numValues < 2)
+        {
+            err = stream.errorAt("a position needs at least two coordinates");
+            return -1;
+        }
+
+        feature.coordinates.push_back(position[0]);
+        feature.coordinates.push_back(position[1]);
+
+        return 0;
+    }
+
+    // Otherwise an array of arrays, if those are positions then this array is a line or a ring
+    bool isFirst = true;
+    int childDepth = 0;
+
+    while(!isEnd)
+    {
+        auto numPoints = int(feature.coordinates.size()/2);
+
+        int itemDepth = 0;
+        if(readCoordinates(stream, feature, itemDepth, err) != 0)
+            return -1;
+
+        if(isFirst && itemDepth == 1)
+            feature.partStarts.push_back(numPoints);
+
+        isFirst = false;
+        childDepth = qMax(childDepth, itemDepth);
+
+        if(stream.nextItem(']', isEnd, err) != 0)
+            return -1;
+    }
+
+    depth = childDepth + 1;
+
+    return 0;
+}
+
+
+int readGeometry(JsonStream& stream, GeoJsonFeature& feature, QString& err)
+{
+    // The geometry can be null
+    if(stream.peek() == 'n')
+    {
+        QVariant null;
+        return stream.readValue(null, err);
+    }
+
+    auto res = stream.readObject([&](const QString& key)
+    {
+        if(key == "type")
+            return stream.readString(feature.geometryType, err);
+
+        if(key == "coordinates")
+            return readCoordinates(stream, feature, feature.coordinateDepth, err);
+
+        QVariant skipped;
+        return stream.readValue(skipped, err);
+    }, err);
+
+    if(res != 0)
+        return -1;
+
+    // A point is a single part
+    if(feature.coordinateDepth == 1 && !feature.coordinates.empty())
+        feature.partStarts.push_back(0);
+
+    if(!feature.partStarts.empty())
+        feature.partStarts.push_back(int(feature.coordinates.size()/2));
+
+    return 0;
+}
+
+
+int readFeature(JsonStream& stream, GeoJsonFeature& feature, QString& err)
+{
+    return stream.readObject([&](const QString& key)
+    {
+        if(key == "geometry")
+            return readGeometry(stream, feature, err);
+
+        if(key == "properties")
+        {
+            QVariant properties;
+            if(stream.readValue(properties, err) != 0)
+                return -1;
+
+            feature.properties = properties.toMap();
+
+            return 0;
+        }
+
+        QVariant skipped;
+        return stream.readValue(skipped, err);
+    }, err);
+}
+
+}
+
+
+void GeoJsonFeature::clear(void)
+{
+    geometryType.clear();
+    coordinates.clear();
+    partStarts.clear();
+    coordinateDepth = 0;
+    properties.clear();
+}
+
+
+int GeoJsonReader::readFile(const QString& pathToFile, const FeatureHandler& handler, QString& err)
+{
+    auto device = DecompressionDevice::openFile(pathToFile, err);
+
+    if(device == nullptr)
+        return -1;
+
+    return GeoJsonReader::readDevice(*device, handler, err);
+}
+
+
+int GeoJsonReader::readDevice(QIODevice& device, const FeatureHandler& handler, QString& err)
+{
+    JsonStream stream(device);
+
+    if(stream.peek() != '{')
+    {
+        err = stream.errorAt("the file is not a geojson object");
+        return -1;
+    }
+
+    GeoJsonFeature feature;
+
+    return stream.readObject([&](const QString& key)
+    {
+        if(key != "features")
+        {
+            QVariant skipped;
+            return stream.readValue(skipped, err);
+        }
+
+        if(stream.expect('[', err) != 0)
+            return -1;
+
+        if(stream.peek() == ']')
+            return stream.expect(']', err);
+
+        bool isEnd = false;
+        while(!isEnd)
+        {
+            feature.clear();
+
+            if(readFeature(stream, feature, err) != 0)
+                return -1;
+
+            if(handler(feature, err) != 0)
+                return -1;
+
+            if(stream.nextItem(']', isEnd, err) != 0)
+                return -1;
+        }
+
+        return 0;
+    }, err);
+}
@@ -0,0 +1,91 @@
+#ifndef GEOJSONREADER_H
+#define GEOJSONREADER_H
+/* *****************************************************************************
+Copyright (c) 2016-2021, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+// Written by: Stevan Gavrilovic
+
+// Streaming reader for geojson feature collections. The file is read in blocks and parsed as it is read, without building a document of
+// the whole file. Each feature is handed to a callback as soon as it is parsed, with the coordinates of its geometry in a flat array of
+// doubles, so that the memory used is that of one feature plus whatever the callback keeps
+
+#include <QString>
+#include <QVariantMap>
+
+#include <functional>
+#include <vector>
+
+class QIODevice;
+
+struct GeoJsonFeature
+{
+    // The geometry type, e.g., Polygon or MultiLineString, empty if the geometry is null
+    QString geometryType;
+
+    // The x and y of each point of the geometry one after the other, any z values are dropped
+    std::vector<double> coordinates;
+
+    // The index of the first point of each line or ring, with an extra entry at the end for the number of points
+    // The polygons of a MultiPolygon are not kept apart, i.e., the rings of all of the polygons are listed one after the other
+    std::vector<int> partStarts;
+
+    // The nesting depth of the coordinates array, e.g., 1 for a Point, 2 for a LineString and 3 for a Polygon
+    int coordinateDepth = 0;
+
+    QVariantMap properties;
+
+    void clear(void);
+
+    int numberOfParts(void) const { return partStarts.empty() ? 0 : int(partStarts.size()) - 1; }
+};
+
+
+class GeoJsonReader
+{
+public:
+
+    // Called for each feature, return 0 to carry on or anything else to stop the reading, in which case err is passed on to the caller
+    // The feature is reused for the next feature, so move out anything that needs to be kept
+    using FeatureHandler = std::function<int(GeoJsonFeature& feature, QString& err)>;
+
+    // Reads the features of the file, which may be compressed, see DecompressionDevice. Returns 0 on success
+    static int readFile(const QString& pathToFile, const FeatureHandler& handler, QString& err);
+
+    // Reads the features from an open device
+    static int readDevice(QIODevice& device, const FeatureHandler& handler, QString& err);
+};
+
+#endif // GEOJSONREADER_H
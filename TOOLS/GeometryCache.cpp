@@ -0,0 +1,548 @@
+/* *****************************************************************************
+Copyright (c) 2016-2021, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+// Written by: Stevan Gavrilovic
+
+#include "GeometryCache.h"
+
+#include "ImmutablePart.h"
+#include "ImmutablePartCollection.h"
+#include "Part.h"
+#include "PartCollection.h"
+#include "Point.h"
+#include "Polygon.h"
+#include "PolygonBuilder.h"
+#include "Polyline.h"
+#include "PolylineBuilder.h"
+#include "SpatialReference.h"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QStandardPaths>
+
+#include <cstring>
+
+using namespace Esri::ArcGISRuntime;
+
+namespace
+{
+
+// The layout of the cache file. The header is followed by the x and y of the points, the first part of each row, the first point of each
+// part, and the type of each row, where each array but the last is aligned to 8 bytes
+struct CacheHeader
+{
+    char magic[8];
+    quint32 version;
+    quint32 headerSize;
+
+    // The state of the CSV file when the cache was made
+    qint64 sourceSize;
+    qint64 sourceModified;
+    char sourceHash[24];
+
+    qint64 numRows;
+    qint64 numParts;
+    qint64 numPoints;
+
+    qint64 coordinatesOffset;
+    qint64 rowPartsOffset;
+    qint64 partPointsOffset;
+    qint64 typesOffset;
+
+    qint64 cacheSize;
+};
+
+const char cacheMagic[8] = {'R','2','D','G','E','O','M','\0'};
+const quint32 cacheVersion = 1;
+
+// The types of the cached geometries
+enum CachedGeometryType : quint8
+{
+    CachedEmpty = 0,
+    CachedPoint = 1,
+    CachedPolyline = 2,
+    CachedPolygon = 3
+};
+
+inline qint64 alignTo8(const qint64 offset)
+{
+    return (offset + 7) & ~qint64(7);
+}
+
+// Builds a polyline or polygon from the parts from firstPart to lastPart - 1, the components are in WGS84
+template <typename Builder>
+Geometry getMultipartGeometry(const qint64 firstPart, const qint64 lastPart, const qint64* partPoints, const double* coordinates)
+{
+    // Owns the parts until the geometry is built
+    QObject partsOwner;
+
+    Builder theMultiPartBuilder(SpatialReference::wgs84());
+
+    PartCollection* pCollection = new PartCollection(theMultiPartBuilder.spatialReference(), &partsOwner);
+
+    for(qint64 i = firstPart; i<lastPart; ++i)
+    {
+        Part* newPart = new Part(theMultiPartBuilder.spatialReference(), &partsOwner);
+
+        for(qint64 j = partPoints[i]; j<partPoints[i+1]; ++j)
+            newPart->addPoint(coordinates[2*j], coordinates[2*j+1]);
+
+        pCollection->addPart(newPart);
+    }
+
+    theMultiPartBuilder.setParts(pCollection);
+
+    return theMultiPartBuilder.toGeometry();
+}
+
+}
+
+
+GeometryCache::GeometryCache()
+{
+
+}
+
+
+GeometryCache::~GeometryCache()
+{
+    this->cancelWrite();
+}
+
+
+int GeometryCache::flatten(const QVector<Esri::ArcGISRuntime::Geometry>& geometries, FlatGeometries& flat, QString& err)
+{
+    flat = FlatGeometries();
+
+    flat.types.reserve(geometries.size());
+    flat.rowParts.reserve(geometries.size() + 1);
+
+    flat.rowParts.push_back(0);
+    flat.partPoints.push_back(0);
+
+    auto addParts = [&](const ImmutablePartCollection& parts)
+    {
+        for(int i = 0; i<parts.size(); ++i)
+        {
+            auto part = parts.part(i);
+
+            for(qint64 j = 0; j<part.pointCount(); ++j)
+            {
+                auto point = part.point(j);
+
+                flat.coordinates.push_back(point.x());
+                flat.coordinates.push_back(point.y());
+            }
+
+            flat.partPoints.push_back(qint64(flat.coordinates.size()/2));
+        }
+    };
+
+    for(auto&& geom : geometries)
+    {
+        if(geom.isEmpty())
+        {
+            flat.types.push_back(CachedEmpty);
+        }
+        else if(geom.geometryType() == GeometryType::Point)
+        {
+            Point point(geom);
+
+            flat.coordinates.push_back(point.x());
+            flat.coordinates.push_back(point.y());
+            flat.partPoints.push_back(qint64(flat.coordinates.size()/2));
+
+            flat.types.push_back(CachedPoint);
+        }
+        else if(geom.geometryType() == GeometryType::Polyline)
+        {
+            addParts(Polyline(geom).parts());
+
+            flat.types.push_back(CachedPolyline);
+        }
+        else if(geom.geometryType() == GeometryType::Polygon)
+        {
+            addParts(Polygon(geom).parts());
+
+            flat.types.push_back(CachedPolygon);
+        }
+        else
+        {
+            err = "Only points, polylines, and polygons can be cached";
+            return -1;
+        }
+
+        flat.rowParts.push_back(qint64(flat.partPoints.size()) - 1);
+    }
+
+    return 0;
+}
+
+
+int GeometryCache::load(const QString& pathToFile, const QString& key, const QByteArray& sourceHash, const int numRows)
+{
+    cacheFile.reset();
+
+    types = nullptr;
+    rowParts = nullptr;
+    partPoints = nullptr;
+    coordinates = nullptr;
+    numCachedRows = 0;
+    numCachedParts = 0;
+    numCachedPoints = 0;
+
+    auto cache = std::make_unique<QFile>(getCachePath(pathToFile, key));
+
+    if(!cache->exists() || !cache->open(QIODevice::ReadOnly))
+        return -1;
+
+    const qint64 cacheSize = cache->size();
+
+    if(cacheSize < qint64(sizeof(CacheHeader)))
+        return -1;
+
+    auto mappedCache = cache->map(0, cacheSize);
+
+    if(mappedCache == nullptr)
+        return -1;
+
+    const char* cacheData = reinterpret_cast<const char*>(mappedCache);
+
+    CacheHeader header;
+    std::memcpy(&header, cacheData, sizeof(CacheHeader));
+
+    if(std::memcmp(header.magic, cacheMagic, sizeof(cacheMagic)) != 0 || header.version != cacheVersion ||
+            header.headerSize != sizeof(CacheHeader) || header.cacheSize != cacheSize)
+        return -1;
+
+    // Check that the file has not changed since the cache was made
+    QFileInfo sourceInfo(pathToFile);
+
+    if(header.sourceSize != sourceInfo.size() || header.sourceModified != sourceInfo.lastModified().toMSecsSinceEpoch())
+        return -1;
+
+    if(sourceHash.size() > int(sizeof(header.sourceHash)) || std::memcmp(header.sourceHash, sourceHash.constData(), sourceHash.size()) != 0)
+        return -1;
+
+    if(header.numRows != numRows || header.numParts < 0 || header.numPoints < 0)
+        return -1;
+
+    // Check that the arrays fit within the file
+    if(header.coordinatesOffset + 16*header.numPoints > cacheSize || header.rowPartsOffset + 8*(header.numRows + 1) > cacheSize ||
+            header.partPointsOffset + 8*(header.numParts + 1) > cacheSize || header.typesOffset + header.numRows > cacheSize)
+        return -1;
+
+    coordinates = reinterpret_cast<const double*>(cacheData + header.coordinatesOffset);
+    rowParts = reinterpret_cast<const qint64*>(cacheData + header.rowPartsOffset);
+    partPoints = reinterpret_cast<const qint64*>(cacheData + header.partPointsOffset);
+    types = reinterpret_cast<const quint8*>(cacheData + header.typesOffset);
+
+    numCachedRows = header.numRows;
+    numCachedParts = header.numParts;
+    numCachedPoints = header.numPoints;
+
+    cacheFile = std::move(cache);
+
+    return 0;
+}
+
+
+bool GeometryCache::isLoaded(void) const
+{
+    return cacheFile != nullptr;
+}
+
+
+int GeometryCache::getGeometries(const int firstRow, const int numRows, QVector<Esri::ArcGISRuntime::Geometry>& geometries, QString& err) const
+{
+    if(!this->isLoaded() || firstRow < 0 || qint64(firstRow) + numRows > numCachedRows)
+    {
+        err = "The rows are not in the geometry cache";
+        return -1;
+    }
+
+    geometries.reserve(geometries.size() + numRows);
+
+    for(int row = firstRow; row < firstRow + numRows; ++row)
+    {
+        const qint64 firstPart = rowParts[row];
+        const qint64 lastPart = rowParts[row+1];
+
+        // The indexes are checked as they are used so that a damaged cache cannot read past the arrays
+        if(firstPart < 0 || lastPart < firstPart || lastPart > numCachedParts || partPoints[firstPart] < 0 || partPoints[lastPart] > numCachedPoints)
+        {
+            err = "The geometry cache is damaged";
+            return -1;
+        }
+
+        for(qint64 i = firstPart; i<lastPart; ++i)
+        {
+            if(partPoints[i+1] < partPoints[i])
+            {
+                err = "The geometry cache is damaged";
+                return -1;
+            }
+        }
+
+        switch(types[row])
+        {
+        case CachedEmpty:
+            geometries.push_back(Geometry());
+            break;
+        case CachedPoint:
+        {
+            if(lastPart - firstPart != 1 || partPoints[lastPart] - partPoints[firstPart] != 1)
+            {
+                err = "The geometry cache is damaged";
+                return -1;
+            }
+
+            auto index = partPoints[firstPart];
+
+            geometries.push_back(Point(coordinates[2*index], coordinates[2*index+1], SpatialReference::wgs84()));
+            break;
+        }
+        case CachedPolyline:
+            geometries.push_back(getMultipartGeometry<PolylineBuilder>(firstPart, lastPart, partPoints, coordinates));
+            break;
+        case CachedPolygon:
+            geometries.push_back(getMultipartGeometry<PolygonBuilder>(firstPart, lastPart, partPoints, coordinates));
+            break;
+        default:
+            err = "The geometry cache is damaged";
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+
+int GeometryCache::beginWrite(const QString& pathToFile, const QString& key, const QByteArray& sourceHash, QString& err)
+{
+    this->cancelWrite();
+
+    writePath = getCachePath(pathToFile, key);
+
+    QFileInfo cacheInfo(writePath);
+
+    if(!QDir().mkpath(cacheInfo.absolutePath()))
+    {
+        err = "Could not create the folder for the cache " + cacheInfo.absolutePath();
+        return -1;
+    }
+
+    // Write to a temporary file first so that a cache that is only partly written is never picked up
+    writeFile = std::make_unique<QFile>(writePath + ".tmp");
+
+    if(!writeFile->open(QIODevice::WriteOnly))
+    {
+        err = "Could not create the cache file " + writePath;
+        writeFile.reset();
+        return -1;
+    }
+
+    // The header is written again once the sizes of the arrays are known
+    CacheHeader header;
+    std::memset(&header, 0, sizeof(CacheHeader));
+
+    const qint64 paddedHeaderSize = alignTo8(sizeof(CacheHeader));
+    QByteArray placeholder(int(paddedHeaderSize), '\0');
+
+    if(writeFile->write(placeholder) != paddedHeaderSize)
+    {
+        err = "Could not write the cache file " + writePath;
+        this->cancelWrite();
+        return -1;
+    }
+
+    writeSourcePath = pathToFile;
+    writeSourceHash = sourceHash;
+
+    writeTypes.clear();
+    writeRowParts.clear();
+    writePartPoints.clear();
+    numWrittenPoints = 0;
+
+    return 0;
+}
+
+
+int GeometryCache::write(const FlatGeometries& flat, QString& err)
+{
+    if(writeFile == nullptr)
+    {
+        err = "The geometry cache is not being written";
+        return -1;
+    }
+
+    const qint64 numBytes = qint64(flat.coordinates.size()*sizeof(double));
+
+    if(writeFile->write(reinterpret_cast<const char*>(flat.coordinates.data()), numBytes) != numBytes)
+    {
+        err = "Could not write the cache file " + writePath;
+        this->cancelWrite();
+        return -1;
+    }
+
+    // The indexes of the batch start at zero, they are offset by what was already written
+    const qint64 partOffset = qint64(writePartPoints.size());
+
+    for(size_t i = 0; i<flat.types.size(); ++i)
+    {
+        writeTypes.push_back(flat.types[i]);
+        writeRowParts.push_back(partOffset + flat.rowParts[i]);
+    }
+
+    for(size_t i = 0; i + 1<flat.partPoints.size(); ++i)
+        writePartPoints.push_back(numWrittenPoints + flat.partPoints[i]);
+
+    numWrittenPoints += qint64(flat.coordinates.size()/2);
+
+    return 0;
+}
+
+
+int GeometryCache::finishWrite(QString& err)
+{
+    if(writeFile == nullptr)
+    {
+        err = "The geometry cache is not being written";
+        return -1;
+    }
+
+    const qint64 numRows = qint64(writeTypes.size());
+    const qint64 numParts = qint64(writePartPoints.size());
+
+    writeRowParts.push_back(numParts);
+    writePartPoints.push_back(numWrittenPoints);
+
+    CacheHeader header;
+    std::memset(&header, 0, sizeof(CacheHeader));
+
+    std::memcpy(header.magic, cacheMagic, sizeof(cacheMagic));
+    header.version = cacheVersion;
+    header.headerSize = sizeof(CacheHeader);
+
+    QFileInfo sourceInfo(writeSourcePath);
+    header.sourceSize = sourceInfo.size();
+    header.sourceModified = sourceInfo.lastModified().toMSecsSinceEpoch();
+    std::memcpy(header.sourceHash, writeSourceHash.constData(), qMin(writeSourceHash.size(), int(sizeof(header.sourceHash))));
+
+    header.numRows = numRows;
+    header.numParts = numParts;
+    header.numPoints = numWrittenPoints;
+
+    header.coordinatesOffset = alignTo8(sizeof(CacheHeader));
+    header.rowPartsOffset = header.coordinatesOffset + 16*numWrittenPoints;
+    header.partPointsOffset = header.rowPartsOffset + 8*(numRows + 1);
+    header.typesOffset = header.partPointsOffset + 8*(numParts + 1);
+    header.cacheSize = header.typesOffset + numRows;
+
+    bool ok = true;
+
+    auto writeData = [&](const void* data, const qint64 numBytes)
+    {
+        if(ok && numBytes > 0)
+            ok = writeFile->write(reinterpret_cast<const char*>(data), numBytes) == numBytes;
+    };
+
+    writeData(writeRowParts.data(), 8*(numRows + 1));
+    writeData(writePartPoints.data(), 8*(numParts + 1));
+    writeData(writeTypes.data(), numRows);
+
+    ok = ok && writeFile->seek(0);
+
+    writeData(&header, sizeof(CacheHeader));
+
+    if(!ok)
+    {
+        err = "Could not write the cache file " + writePath;
+        this->cancelWrite();
+        return -1;
+    }
+
+    writeFile->close();
+
+    QFile::remove(writePath);
+
+    if(!writeFile->rename(writePath))
+    {
+        err = "Could not rename the cache file " + writePath;
+        this->cancelWrite();
+        return -1;
+    }
+
+    writeFile.reset();
+
+    writeTypes.clear();
+    writeRowParts.clear();
+    writePartPoints.clear();
+
+    return 0;
+}
+
+
+void GeometryCache::cancelWrite(void)
+{
+    if(writeFile == nullptr)
+        return;
+
+    writeFile->close();
+    writeFile->remove();
+    writeFile.reset();
+
+    writeTypes.clear();
+    writeRowParts.clear();
+    writePartPoints.clear();
+    numWrittenPoints = 0;
+}
+
+
+QString GeometryCache::getCachePath(const QString& pathToFile, const QString& key)
+{
+    // The cache is named after a hash of the absolute path and the key, in the same folder as the cache of the CSV file
+    auto absolutePath = QFileInfo(pathToFile).absoluteFilePath();
+
+    auto pathHash = QCryptographicHash::hash((absolutePath + "\n" + key).toUtf8(), QCryptographicHash::Sha1).toHex();
+
+    auto cacheDir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + QDir::separator() + "AssetCache";
+
+    return cacheDir + QDir::separator() + QString::fromLatin1(pathHash) + ".geom";
+}
@@ -0,0 +1,125 @@
+#ifndef GEOMETRYCACHE_H
+#define GEOMETRYCACHE_H
+/* *****************************************************************************
+Copyright (c) 2016-2021, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+// Written by: Stevan Gavrilovic
+
+// A binary cache of the geometries that were built for a component inventory, stored with the cache of the CSV file. The points of the
+// geometries are stored as flat arrays, so that reopening a project builds the geometries without decoding the footprints in the file again.
+// The cache is made for a given file and key, e.g., the type of component, since different components build different geometries from
+// the same file
+
+#include "Geometry.h"
+
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+
+#include <memory>
+#include <vector>
+
+class QFile;
+
+class GeometryCache
+{
+public:
+    GeometryCache();
+    ~GeometryCache();
+
+    GeometryCache(const GeometryCache&) = delete;
+    GeometryCache& operator=(const GeometryCache&) = delete;
+
+    // The geometries of consecutive rows as flat arrays, for writing to the cache
+    struct FlatGeometries
+    {
+        // The type of each geometry, and the index of its first part followed by an entry for the end of the last part
+        std::vector<quint8> types;
+        std::vector<qint64> rowParts;
+
+        // The index of the first point of each part followed by an entry for the end of the last part, and the x and y of each point
+        std::vector<qint64> partPoints;
+        std::vector<double> coordinates;
+    };
+
+    // Flattens the geometries, only points, polylines and polygons can be cached. Can be called from multiple threads, returns 0 on success
+    static int flatten(const QVector<Esri::ArcGISRuntime::Geometry>& geometries, FlatGeometries& flat, QString& err);
+
+    // Maps the cache, returns 0 if it exists and was made from the file as it is now, with the given content hash and number of rows
+    int load(const QString& pathToFile, const QString& key, const QByteArray& sourceHash, const int numRows);
+
+    bool isLoaded(void) const;
+
+    // Builds the geometries of the rows from firstRow to firstRow + numRows - 1 from the loaded cache and appends them to geometries
+    // Can be called from multiple threads, returns 0 on success
+    int getGeometries(const int firstRow, const int numRows, QVector<Esri::ArcGISRuntime::Geometry>& geometries, QString& err) const;
+
+    // Writes the cache, the geometries are added in the order of their rows. The cache is written to a temporary file until
+    // finishWrite() is called, and the temporary file is removed if the writing is cancelled or the cache is destroyed first
+    int beginWrite(const QString& pathToFile, const QString& key, const QByteArray& sourceHash, QString& err);
+    int write(const FlatGeometries& flat, QString& err);
+    int finishWrite(QString& err);
+    void cancelWrite(void);
+
+    // Returns the path to the cache of the given file and key
+    static QString getCachePath(const QString& pathToFile, const QString& key);
+
+private:
+
+    // The cache that is loaded and its arrays
+    std::unique_ptr<QFile> cacheFile;
+
+    const quint8* types = nullptr;
+    const qint64* rowParts = nullptr;
+    const qint64* partPoints = nullptr;
+    const double* coordinates = nullptr;
+    qint64 numCachedRows = 0;
+    qint64 numCachedParts = 0;
+    qint64 numCachedPoints = 0;
+
+    // The cache that is being written, the points are written as the geometries are added and the rest is kept until the end
+    std::unique_ptr<QFile> writeFile;
+    QString writePath;
+    QString writeSourcePath;
+    QByteArray writeSourceHash;
+
+    std::vector<quint8> writeTypes;
+    std::vector<qint64> writeRowParts;
+    std::vector<qint64> writePartPoints;
+    qint64 numWrittenPoints = 0;
+};
+
+#endif // GEOMETRYCACHE_H
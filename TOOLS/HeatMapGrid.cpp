@@ -0,0 +1,539 @@
+/* *****************************************************************************
+Copyright (c) 2016-2021, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+// Written by: Stevan Gavrilovic
+
+#include "HeatMapGrid.h"
+
+#include <QByteArray>
+#include <QFile>
+#include <QVector>
+#include <QtConcurrent/QtConcurrentMap>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <limits>
+
+namespace
+{
+
+// The TIFF field types that are used
+enum TiffType : quint16
+{
+    TiffAscii = 2,
+    TiffShort = 3,
+    TiffLong = 4,
+    TiffDouble = 12
+};
+
+// Appends a value to the file in little endian order
+template <typename T>
+void appendValue(QByteArray& data, const T value)
+{
+    char bytes[sizeof(T)];
+    std::memcpy(bytes, &value, sizeof(T));
+
+#if Q_BYTE_ORDER == Q_BIG_ENDIAN
+    std::reverse(bytes, bytes + sizeof(T));
+#endif
+
+    data.append(bytes, int(sizeof(T)));
+}
+
+// Writes a value into the file at the given offset in little endian order
+template <typename T>
+void setValue(QByteArray& data, const int offset, const T value)
+{
+    char bytes[sizeof(T)];
+    std::memcpy(bytes, &value, sizeof(T));
+
+#if Q_BYTE_ORDER == Q_BIG_ENDIAN
+    std::reverse(bytes, bytes + sizeof(T));
+#endif
+
+    std::memcpy(data.data() + offset, bytes, sizeof(T));
+}
+
+// Runs the function over the rows from 0 to numRows - 1 in parallel, a task at a time
+void forEachRowBlock(const int numRows, const int rowsPerTask, const std::function<void(int firstRow, int lastRow)>& function)
+{
+    QVector<int> taskStarts;
+    for(int i = 0; i<numRows; i += rowsPerTask)
+        taskStarts.push_back(i);
+
+    QtConcurrent::blockingMap(taskStarts, [&](const int& firstRow)
+    {
+        function(firstRow, qMin(firstRow + rowsPerTask, numRows));
+    });
+}
+
+}
+
+
+HeatMapGrid::HeatMapGrid()
+{
+
+}
+
+
+int HeatMapGrid::build(const std::vector<double>& coordinates, const std::vector<double>& values, const double cellSize, const Statistic statistic,
+                       const double smoothingSigma, QString& err)
+{
+    numColumns = 0;
+    numRows = 0;
+    std::vector<float>().swap(cellValues);
+
+    if(coordinates.size() != 2*values.size())
+    {
+        err = "The number of coordinates does not match the number of values";
+        return -1;
+    }
+
+    if(!(cellSize > 0.0))
+    {
+        err = "The cell size must be greater than zero";
+        return -1;
+    }
+
+    // The extent of the points that have values
+    double pointsXMin = std::numeric_limits<double>::max();
+    double pointsXMax = std::numeric_limits<double>::lowest();
+    double pointsYMin = std::numeric_limits<double>::max();
+    double pointsYMax = std::numeric_limits<double>::lowest();
+
+    const int numPoints = int(values.size());
+
+    auto isValidPoint = [&](const int i)
+    {
+        return std::isfinite(values[i]) && std::isfinite(coordinates[2*i]) && std::isfinite(coordinates[2*i+1]);
+    };
+
+    for(int i = 0; i<numPoints; ++i)
+    {
+        if(!isValidPoint(i))
+            continue;
+
+        pointsXMin = qMin(pointsXMin, coordinates[2*i]);
+        pointsXMax = qMax(pointsXMax, coordinates[2*i]);
+        pointsYMin = qMin(pointsYMin, coordinates[2*i+1]);
+        pointsYMax = qMax(pointsYMax, coordinates[2*i+1]);
+    }
+
+    if(pointsXMin > pointsXMax)
+    {
+        err = "There are no points with values to make the grid from";
+        return -1;
+    }
+
+    // The grid is padded so that the smoothing does not run off of its edges
+    const int kernelRadius = smoothingSigma > 0.0 ? int(std::ceil(3.0*smoothingSigma)) : 0;
+
+    const qint64 gridColumns = qint64(std::floor((pointsXMax - pointsXMin)/cellSize)) + 1 + 2*kernelRadius;
+    const qint64 gridRows = qint64(std::floor((pointsYMax - pointsYMin)/cellSize)) + 1 + 2*kernelRadius;
+
+    if(gridColumns*gridRows > maxNumberOfCells)
+    {
+        err = "The cell size of " + QString::number(cellSize) + " is too small for the extent of the points";
+        return -1;
+    }
+
+    this->cellSize = cellSize;
+    xMin = pointsXMin - kernelRadius*cellSize;
+    yMax = pointsYMax + kernelRadius*cellSize;
+    numColumns = int(gridColumns);
+    numRows = int(gridRows);
+
+    const qint64 numCells = gridColumns*gridRows;
+
+    // Find the cell of each point
+    std::vector<int> pointRows(numPoints, -1);
+    std::vector<int> pointColumns(numPoints, -1);
+
+    QVector<int> pointChunkStarts;
+    for(int i = 0; i<numPoints; i += pointsPerTask)
+        pointChunkStarts.push_back(i);
+
+    QtConcurrent::blockingMap(pointChunkStarts, [&](const int& firstPoint)
+    {
+        const int lastPoint = qMin(firstPoint + pointsPerTask, numPoints);
+
+        for(int i = firstPoint; i<lastPoint; ++i)
+        {
+            if(!isValidPoint(i))
+                continue;
+
+            pointColumns[i] = qBound(0, int((coordinates[2*i] - xMin)/cellSize), numColumns - 1);
+            pointRows[i] = qBound(0, int((yMax - coordinates[2*i+1])/cellSize), numRows - 1);
+        }
+    });
+
+    // Sort the points by row, so that each task can add up the points in its own rows without sharing any cells with the other tasks
+    std::vector<int> rowStarts(numRows + 1, 0);
+
+    for(auto&& row : pointRows)
+    {
+        if(row != -1)
+            ++rowStarts[row + 1];
+    }
+
+    for(int i = 0; i<numRows; ++i)
+        rowStarts[i + 1] += rowStarts[i];
+
+    std::vector<int> pointsByRow(rowStarts[numRows]);
+    std::vector<int> nextInRow(rowStarts.begin(), rowStarts.end() - 1);
+
+    for(int i = 0; i<numPoints; ++i)
+    {
+        if(pointRows[i] != -1)
+            pointsByRow[nextInRow[pointRows[i]]++] = i;
+    }
+
+    std::vector<double> sums(numCells, 0.0);
+    std::vector<double> counts(numCells, 0.0);
+
+    forEachRowBlock(numRows, rowsPerTask, [&](const int firstRow, const int lastRow)
+    {
+        for(int j = rowStarts[firstRow]; j<rowStarts[lastRow]; ++j)
+        {
+            const int i = pointsByRow[j];
+            const qint64 cell = qint64(pointRows[i])*numColumns + pointColumns[i];
+
+            sums[cell] += values[i];
+            counts[cell] += 1.0;
+        }
+    });
+
+    if(kernelRadius > 0)
+    {
+        // The kernel is normalized so that the smoothing keeps the sum of the values
+        std::vector<double> kernel(2*kernelRadius + 1);
+
+        double kernelSum = 0.0;
+        for(int k = -kernelRadius; k<=kernelRadius; ++k)
+        {
+            kernel[k + kernelRadius] = std::exp(-0.5*k*k/(smoothingSigma*smoothingSigma));
+            kernelSum += kernel[k + kernelRadius];
+        }
+
+        for(auto&& it : kernel)
+            it /= kernelSum;
+
+        this->smooth(sums, kernel);
+        this->smooth(counts, kernel);
+    }
+
+    // The cells that get less than this fraction of a point after smoothing are treated as empty
+    const double minCount = 1.0e-3;
+
+    cellValues.resize(numCells);
+
+    forEachRowBlock(numRows, rowsPerTask, [&](const int firstRow, const int lastRow)
+    {
+        for(qint64 cell = qint64(firstRow)*numColumns; cell<qint64(lastRow)*numColumns; ++cell)
+        {
+            if(counts[cell] < minCount)
+                cellValues[cell] = std::numeric_limits<float>::quiet_NaN();
+            else if(statistic == Statistic::Mean)
+                cellValues[cell] = float(sums[cell]/counts[cell]);
+            else
+                cellValues[cell] = float(sums[cell]);
+        }
+    });
+
+    return 0;
+}
+
+
+void HeatMapGrid::smooth(std::vector<double>& grid, const std::vector<double>& kernel) const
+{
+    const int kernelRadius = int(kernel.size()/2);
+
+    std::vector<double> rowSmoothed(grid.size(), 0.0);
+
+    // Smooth along the rows, then along the columns
+    forEachRowBlock(numRows, rowsPerTask, [&](const int firstRow, const int lastRow)
+    {
+        for(int row = firstRow; row<lastRow; ++row)
+        {
+            const double* gridRow = grid.data() + qint64(row)*numColumns;
+            double* smoothedRow = rowSmoothed.data() + qint64(row)*numColumns;
+
+            for(int col = 0; col<numColumns; ++col)
+            {
+                const int first = qMax(0, col - kernelRadius);
+                const int last = qMin(numColumns - 1, col + kernelRadius);
+
+                double sum = 0.0;
+                for(int k = first; k<=last; ++k)
+                    sum += kernel[k - col + kernelRadius]*gridRow[k];
+
+                smoothedRow[col] = sum;
+            }
+        }
+    });
+
+    forEachRowBlock(numRows, rowsPerTask, [&](const int firstRow, const int lastRow)
+    {
+        for(int row = firstRow; row<lastRow; ++row)
+        {
+            const int first = qMax(0, row - kernelRadius);
+            const int last = qMin(numRows - 1, row + kernelRadius);
+
+            double* gridRow = grid.data() + qint64(row)*numColumns;
+
+            for(int col = 0; col<numColumns; ++col)
+                gridRow[col] = 0.0;
+
+            for(int k = first; k<=last; ++k)
+            {
+                const double weight = kernel[k - row + kernelRadius];
+                const double* smoothedRow = rowSmoothed.data() + qint64(k)*numColumns;
+
+                for(int col = 0; col<numColumns; ++col)
+                    gridRow[col] += weight*smoothedRow[col];
+            }
+        }
+    });
+}
+
+
+int HeatMapGrid::writeGeoTIFF(const QString& filePath, QString& err) const
+{
+    if(cellValues.empty())
+    {
+        err = "The grid is empty";
+        return -1;
+    }
+
+    // The size of a classic TIFF file is limited to 4 GB
+    const qint64 imageSize = qint64(cellValues.size())*4;
+
+    if(imageSize > qint64(std::numeric_limits<qint32>::max()) - 4096)
+    {
+        err = "The grid is too large to write as a GeoTIFF";
+        return -1;
+    }
+
+    // The GeoTIFF keys for a geographic grid in WGS84 where each value covers the area of its cell, as the header of the key directory
+    // followed by the key id, location, count, and value of each key
+    const QVector<quint16> geoKeys = {1, 1, 0, 3,
+                                      1024, 0, 1, 2,     // GTModelTypeGeoKey = ModelTypeGeographic
+                                      1025, 0, 1, 1,     // GTRasterTypeGeoKey = RasterPixelIsArea
+                                      2048, 0, 1, 4326}; // GeographicTypeGeoKey = GCS_WGS_84
+
+    const QVector<double> pixelScale = {cellSize, cellSize, 0.0};
+    const QVector<double> tiePoint = {0.0, 0.0, 0.0, xMin, yMax, 0.0};
+
+    const QByteArray noData = QByteArray::number(double(noDataValue)) + '\0';
+
+    // A tag and its value, the values that do not fit into the four bytes of the tag are written after the tags
+    struct Tag
+    {
+        quint16 id;
+        quint16 type;
+        quint32 count;
+        QByteArray value;
+    };
+
+    auto shortTag = [](const quint16 id, const quint16 value)
+    {
+        Tag tag{id, TiffShort, 1, QByteArray()};
+        appendValue(tag.value, value);
+        return tag;
+    };
+
+    auto longTag = [](const quint16 id, const quint32 value)
+    {
+        Tag tag{id, TiffLong, 1, QByteArray()};
+        appendValue(tag.value, value);
+        return tag;
+    };
+
+    Tag geoKeyTag{34735, TiffShort, quint32(geoKeys.size()), QByteArray()};
+    for(auto&& it : geoKeys)
+        appendValue(geoKeyTag.value, it);
+
+    Tag pixelScaleTag{33550, TiffDouble, quint32(pixelScale.size()), QByteArray()};
+    for(auto&& it : pixelScale)
+        appendValue(pixelScaleTag.value, it);
+
+    Tag tiePointTag{33922, TiffDouble, quint32(tiePoint.size()), QByteArray()};
+    for(auto&& it : tiePoint)
+        appendValue(tiePointTag.value, it);
+
+    // The image is written as one strip after the tags, its offset is filled in once the size of the tags is known
+    const int imageOffsetTag = 5;
+
+    // The tags must be in increasing order of their ids
+    QVector<Tag> tags = {longTag(256, quint32(numColumns)),   // ImageWidth
+                         longTag(257, quint32(numRows)),      // ImageLength
+                         shortTag(258, 32),                   // BitsPerSample
+                         shortTag(259, 1),                    // Compression = none
+                         shortTag(262, 1),                    // PhotometricInterpretation = BlackIsZero
+                         longTag(273, 0),                     // StripOffsets
+                         shortTag(277, 1),                    // SamplesPerPixel
+                         longTag(278, quint32(numRows)),      // RowsPerStrip
+                         longTag(279, quint32(imageSize)),    // StripByteCounts
+                         shortTag(284, 1),                    // PlanarConfiguration = contiguous
+                         shortTag(339, 3),                    // SampleFormat = IEEE floating point
+                         pixelScaleTag,                       // ModelPixelScaleTag
+                         tiePointTag,                         // ModelTiepointTag
+                         geoKeyTag,                           // GeoKeyDirectoryTag
+                         Tag{42113, TiffAscii, quint32(noData.size()), noData}}; // GDAL_NODATA
+
+    QByteArray header;
+
+    // Little endian TIFF, with the tags starting right after the header
+    header.append("II", 2);
+    appendValue(header, quint16(42));
+    appendValue(header, quint32(8));
+
+    appendValue(header, quint16(tags.size()));
+
+    const int tagsEnd = header.size() + 12*tags.size() + 4;
+
+    // The offsets of the values that go after the tags
+    QByteArray extraValues;
+    QVector<int> valueOffsetPositions;
+
+    for(auto&& tag : tags)
+    {
+        appendValue(header, tag.id);
+        appendValue(header, tag.type);
+        appendValue(header, tag.count);
+
+        if(tag.value.size() <= 4)
+        {
+            QByteArray value = tag.value;
+            value.append(QByteArray(4 - value.size(), '\0'));
+            header.append(value);
+        }
+        else
+        {
+            // The values start on a word boundary
+            if(extraValues.size() % 2 != 0)
+                extraValues.append('\0');
+
+            appendValue(header, quint32(tagsEnd + extraValues.size()));
+            extraValues.append(tag.value);
+        }
+
+        valueOffsetPositions.push_back(header.size() - 4);
+    }
+
+    // There is only one image
+    appendValue(header, quint32(0));
+
+    header.append(extraValues);
+
+    // Start the image on an 8 byte boundary
+    header.append(QByteArray((8 - header.size() % 8) % 8, '\0'));
+
+    setValue(header, valueOffsetPositions.at(imageOffsetTag), quint32(header.size()));
+
+    QFile file(filePath);
+
+    if(!file.open(QIODevice::WriteOnly))
+    {
+        err = "Could not open the file " + filePath + " for writing";
+        return -1;
+    }
+
+    bool ok = file.write(header) == header.size();
+
+    // Write the image a row at a time with the empty cells set to the no data value
+    QByteArray rowData;
+    rowData.reserve(4*numColumns);
+
+    for(int row = 0; row<numRows && ok; ++row)
+    {
+        rowData.clear();
+
+        for(int col = 0; col<numColumns; ++col)
+        {
+            auto value = cellValues[qint64(row)*numColumns + col];
+            appendValue(rowData, std::isnan(value) ? noDataValue : value);
+        }
+
+        ok = file.write(rowData) == rowData.size();
+    }
+
+    if(!ok)
+    {
+        err = "Could not write the file " + filePath;
+        return -1;
+    }
+
+    return 0;
+}
+
+
+int HeatMapGrid::getNumberOfColumns(void) const
+{
+    return numColumns;
+}
+
+
+int HeatMapGrid::getNumberOfRows(void) const
+{
+    return numRows;
+}
+
+
+float HeatMapGrid::getValue(const int row, const int col) const
+{
+    return cellValues[qint64(row)*numColumns + col];
+}
+
+
+bool HeatMapGrid::getValueRange(double& minValue, double& maxValue) const
+{
+    minValue = std::numeric_limits<double>::max();
+    maxValue = std::numeric_limits<double>::lowest();
+
+    for(auto&& it : cellValues)
+    {
+        if(std::isnan(it))
+            continue;
+
+        minValue = qMin(minValue, double(it));
+        maxValue = qMax(maxValue, double(it));
+    }
+
+    return minValue <= maxValue;
+}
@@ -0,0 +1,107 @@
+#ifndef HEATMAPGRID_H
+#define HEATMAPGRID_H
+/* *****************************************************************************
+Copyright (c) 2016-2021, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+// Written by: Stevan Gavrilovic
+
+// Rasterizes values at points into a grid of square cells, e.g., the results of the components of a large region, so that they can be
+// shown as one raster rather than as a feature for each component. Each cell holds either the sum of the values at the points in the cell,
+// i.e., the density of the values, or their mean. The grid is written as a GeoTIFF for a raster layer
+
+#include <QString>
+
+#include <vector>
+
+class HeatMapGrid
+{
+public:
+    HeatMapGrid();
+
+    // How the values of the points in a cell are combined
+    enum class Statistic
+    {
+        Sum,
+        Mean
+    };
+
+    // Builds the grid from the points, given by the x and y of each point in WGS84, and their values. The grid covers the points with cells
+    // of the given size in degrees. The points are accumulated into the cells in parallel. If smoothingSigma is greater than zero, the
+    // values are smoothed with a Gaussian kernel whose standard deviation is smoothingSigma cells. The points with a value that is not a
+    // finite number are skipped. Returns 0 on success
+    int build(const std::vector<double>& coordinates, const std::vector<double>& values, const double cellSize, const Statistic statistic,
+              const double smoothingSigma, QString& err);
+
+    // Writes the grid as a GeoTIFF with one band of 32-bit floats in WGS84, with the cells that have no points set to noDataValue
+    int writeGeoTIFF(const QString& filePath, QString& err) const;
+
+    int getNumberOfColumns(void) const;
+    int getNumberOfRows(void) const;
+
+    // The value of a cell, where row 0 is the northernmost row, or NaN if there are no points in the cell
+    float getValue(const int row, const int col) const;
+
+    // The smallest and largest values of the cells that have points, returns false if no cell has a point
+    bool getValueRange(double& minValue, double& maxValue) const;
+
+    // The value that marks the cells without any points in the GeoTIFF
+    static constexpr float noDataValue = -9999.0f;
+
+    // The largest number of cells in a grid, to keep a small cell size over a large region from running out of memory
+    static const qint64 maxNumberOfCells = qint64(1) << 26;
+
+private:
+
+    // Smooths the grid with a separable Gaussian kernel, in place
+    void smooth(std::vector<double>& grid, const std::vector<double>& kernel) const;
+
+    // The west and north edges of the grid
+    double xMin = 0.0;
+    double yMax = 0.0;
+    double cellSize = 0.0;
+
+    int numColumns = 0;
+    int numRows = 0;
+
+    // The values of the cells by row, with NaN for the cells without any points
+    std::vector<float> cellValues;
+
+    // The number of rows and points that are processed in each task
+    static const int rowsPerTask = 64;
+    static const int pointsPerTask = 65536;
+};
+
+#endif // HEATMAPGRID_H
@@ -38,6 +38,7 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 
 #include "HurricanePreprocessor.h"
 #include "CSVReaderWriter.h"
+#include "CSVTable.h"
 #include "VisualizationWidget.h"
 
 #include <QProgressBar>
@@ -68,32 +69,27 @@ int HurricanePreprocessor::loadHurricaneTrackData(const QString &eventFile, QStr
 {
     CSVReaderWriter csvTool;
 
-    QVector<QStringList> data = csvTool.parseCSVFile(eventFile, err);
+    CSVTable data;
+    csvTool.parseCSVFile(eventFile, data, err, true);
 
     if(!err.isEmpty())
     {
         return -1;
     }
 
-    if(data.empty())
+    if(data.isEmpty())
     {
         err = "Hurricane data is empty";
         return -1;
     }
 
     // Get the header information to populate the fields
-    auto headerData = data.at(0);
+    auto headerData = data.getRow(0);
 
     auto numCol = headerData.size();
 
-    // Pop off the first two rows that contain the header and units information
-    data.pop_front();
-    data.pop_front();
-
-
-    // Split the hurricanes up as they come in one long list
-    QVectorIterator<QStringList> i(data);
-    QString SID;
+    // Skip the first two rows that contain the header and units information
+    auto numRows = data.rowCount();
 
     HurricaneObject hurricane;
     hurricane.parameterLabels = headerData;
@@ -109,33 +105,19 @@ int HurricanePreprocessor::loadHurricaneTrackData(const QString &eventFile, QStr
 
     // While iterating through the hurricane points, save the data at first landfall
     bool landfallFound = false;
-    while (i.hasNext())
+    CSVField currSID;
+    for(int i = 2; i<numRows; ++i)
     {
-        auto row = i.next();
-
-        if(row.size() != numCol)
+        if(data.columnCount(i) != numCol)
         {
             err = "Error, inconsistency in the data in the row and number of columns";
             return -1;
         }
 
-        // Not all hurricanes will make landfall
-        if(!landfallFound)
-        {
-            auto distToLand = row.at(indexLandfall);
-
-            // If the distance to land is 0, then this is the first landfall
-            if(distToLand.compare("0") == 0)
-            {
-                landfallFound = true;
-                hurricane.landfallData = row;
-                hurricane.indexLandfall = hurricane.size();
-            }
-        }
-
-        auto currSID = row.at(indexSID);
+        // The hurricane object keeps the rows as strings, compare the storm IDs in the mapped file before converting the row
+        auto rowSID = data.at(i,indexSID);
 
-        if(SID.compare(currSID) != 0)
+        if(rowSID != currSID)
         {
             if(!hurricane.empty())
             {
@@ -144,7 +126,21 @@ int HurricanePreprocessor::loadHurricaneTrackData(const QString &eventFile, QStr
                 landfallFound = false;
             }
 
-            SID = currSID;
+            currSID = rowSID;
+        }
+
+        auto row = data.getRow(i);
+
+        // Not all hurricanes will make landfall
+        if(!landfallFound)
+        {
+            // If the distance to land is 0, then this is the first landfall
+            if(data.at(i,indexLandfall) == "0")
+            {
+                landfallFound = true;
+                hurricane.landfallData = row;
+                hurricane.indexLandfall = hurricane.size();
+            }
         }
 
         hurricane.push_back(row);
@@ -215,6 +211,11 @@ int HurricanePreprocessor::loadHurricaneTrackData(const QString &eventFile, QStr
     trackFeatureCollectionTable->setRenderer(lineRenderer);
 
 
+    // The names and ids of the hurricanes for searching
+    QList<Feature*> trackFeatures;
+    QStringList trackNames;
+    QStringList trackSIDs;
+
     for(int i = 0; i<numHurricanes; ++i)
     {
         theProgressBar->setValue(i);
@@ -250,8 +251,15 @@ int HurricanePreprocessor::loadHurricaneTrackData(const QString &eventFile, QStr
 
         auto trackFeat = trackFeatureCollectionTable->createFeature(featureAttributes,polyline,theParent);
         trackFeatureCollectionTable->addFeature(trackFeat);
+
+        trackFeatures.append(trackFeat);
+        trackNames.append(name);
+        trackSIDs.append(SID);
     }
 
+    theVisualizationWidget->addSearchIndex(allHurricanesLayer, "NAME", trackNames, trackFeatures);
+    theVisualizationWidget->addSearchIndex(allHurricanesLayer, "SID", trackSIDs, trackFeatures);
+
     theVisualizationWidget->zoomToLayer(allHurricanesLayer->layerId());
 
     return 0;
@@ -0,0 +1,335 @@
+/* *****************************************************************************
+Copyright (c) 2016-2021, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+// Written by: Stevan Gavrilovic
+
+#include "IntervalSet.h"
+
+#include <QStringList>
+
+#include <algorithm>
+
+IntervalSet::IntervalSet()
+{
+
+}
+
+
+int IntervalSet::parse(const QString& list, QString& err)
+{
+    auto text = list;
+
+    // Remove any white space from the string
+    text.remove(' ');
+
+    std::vector<Interval> newIntervals;
+
+    // Split the incoming text into the parts delimited by commas
+    auto parts = text.split(',', Qt::SkipEmptyParts);
+
+    newIntervals.reserve(parts.size());
+
+    for(auto&& part : parts)
+    {
+        // Handle the case where there is a range of IDs separated by a '-'
+        auto pos = part.indexOf('-');
+
+        bool startOK = false;
+        bool endOK = false;
+
+        int first = 0;
+        int last = 0;
+
+        if(pos != -1)
+        {
+            first = part.leftRef(pos).toInt(&startOK);
+            last = part.midRef(pos + 1).toInt(&endOK);
+        }
+        else
+        {
+            first = part.toInt(&startOK);
+            last = first;
+            endOK = startOK;
+        }
+
+        if(!startOK || !endOK)
+        {
+            err = "Error, could not read the ID or range of IDs '" + part + "'";
+            return -1;
+        }
+
+        // Make sure that the end of the range is not less than the start
+        if(first > last)
+        {
+            err = "Error in the range of IDs " + part + ", the end of the range is less than its start";
+            return -1;
+        }
+
+        newIntervals.push_back({first, last});
+    }
+
+    normalize(newIntervals);
+
+    intervals.swap(newIntervals);
+
+    return 0;
+}
+
+
+QString IntervalSet::toString(void) const
+{
+    QStringList parts;
+    parts.reserve(int(intervals.size()));
+
+    for(auto&& it : intervals)
+    {
+        if(it.first == it.last)
+            parts.append(QString::number(it.first));
+        else
+            parts.append(QString::number(it.first) + "-" + QString::number(it.last));
+    }
+
+    return parts.join(',');
+}
+
+
+void IntervalSet::insert(const int ID)
+{
+    this->insert(ID, ID);
+}
+
+
+void IntervalSet::insert(const int first, const int last)
+{
+    if(first > last)
+        return;
+
+    // The IDs usually come in increasing order, in which case they are appended to the last interval
+    if(intervals.empty() || qint64(first) > qint64(intervals.back().last) + 1)
+    {
+        intervals.push_back({first, last});
+        return;
+    }
+
+    if(first >= intervals.back().first)
+    {
+        intervals.back().last = std::max(intervals.back().last, last);
+        return;
+    }
+
+    // Find the intervals that overlap or touch the new interval and replace them with their union
+    auto begin = std::lower_bound(intervals.begin(), intervals.end(), first, [](const Interval& interval, const int ID)
+    {
+        return qint64(interval.last) + 1 < ID;
+    });
+
+    auto end = std::upper_bound(begin, intervals.end(), last, [](const int ID, const Interval& interval)
+    {
+        return qint64(ID) + 1 < interval.first;
+    });
+
+    if(begin == end)
+    {
+        intervals.insert(begin, {first, last});
+        return;
+    }
+
+    begin->first = std::min(begin->first, first);
+    begin->last = std::max((end - 1)->last, last);
+
+    intervals.erase(begin + 1, end);
+}
+
+
+bool IntervalSet::contains(const int ID) const
+{
+    // Find the first interval that ends at or after the ID
+    auto it = std::lower_bound(intervals.begin(), intervals.end(), ID, [](const Interval& interval, const int val)
+    {
+        return interval.last < val;
+    });
+
+    return it != intervals.end() && it->first <= ID;
+}
+
+
+IntervalSet IntervalSet::united(const IntervalSet& other) const
+{
+    IntervalSet result;
+    result.intervals.reserve(intervals.size() + other.intervals.size());
+
+    // Merge the two sorted lists, joining the intervals that overlap or touch
+    size_t i = 0;
+    size_t j = 0;
+
+    while(i < intervals.size() || j < other.intervals.size())
+    {
+        const Interval& next = (j == other.intervals.size() || (i < intervals.size() && intervals[i].first < other.intervals[j].first)) ? intervals[i++] : other.intervals[j++];
+
+        if(!result.intervals.empty() && qint64(next.first) <= qint64(result.intervals.back().last) + 1)
+            result.intervals.back().last = std::max(result.intervals.back().last, next.last);
+        else
+            result.intervals.push_back(next);
+    }
+
+    return result;
+}
+
+
+IntervalSet IntervalSet::intersected(const IntervalSet& other) const
+{
+    IntervalSet result;
+
+    size_t i = 0;
+    size_t j = 0;
+
+    while(i < intervals.size() && j < other.intervals.size())
+    {
+        auto first = std::max(intervals[i].first, other.intervals[j].first);
+        auto last = std::min(intervals[i].last, other.intervals[j].last);
+
+        if(first <= last)
+            result.intervals.push_back({first, last});
+
+        // Move past the interval that ends first
+        if(intervals[i].last < other.intervals[j].last)
+            ++i;
+        else
+            ++j;
+    }
+
+    return result;
+}
+
+
+void IntervalSet::clear(void)
+{
+    intervals.clear();
+}
+
+
+bool IntervalSet::isEmpty(void) const
+{
+    return intervals.empty();
+}
+
+
+qint64 IntervalSet::size(void) const
+{
+    qint64 numIDs = 0;
+
+    for(auto&& it : intervals)
+        numIDs += qint64(it.last) - it.first + 1;
+
+    return numIDs;
+}
+
+
+int IntervalSet::first(void) const
+{
+    return intervals.front().first;
+}
+
+
+int IntervalSet::last(void) const
+{
+    return intervals.back().last;
+}
+
+
+const std::vector<IntervalSet::Interval>& IntervalSet::getIntervals(void) const
+{
+    return intervals;
+}
+
+
+IntervalSet::const_iterator IntervalSet::begin(void) const
+{
+    return const_iterator(&intervals, 0);
+}
+
+
+IntervalSet::const_iterator IntervalSet::end(void) const
+{
+    return const_iterator(&intervals, intervals.size());
+}
+
+
+bool IntervalSet::operator==(const IntervalSet& other) const
+{
+    if(intervals.size() != other.intervals.size())
+        return false;
+
+    for(size_t i = 0; i<intervals.size(); ++i)
+    {
+        if(intervals[i].first != other.intervals[i].first || intervals[i].last != other.intervals[i].last)
+            return false;
+    }
+
+    return true;
+}
+
+
+bool IntervalSet::operator!=(const IntervalSet& other) const
+{
+    return !(*this == other);
+}
+
+
+void IntervalSet::normalize(std::vector<Interval>& intervals)
+{
+    if(intervals.empty())
+        return;
+
+    std::sort(intervals.begin(), intervals.end(), [](const Interval& a, const Interval& b)
+    {
+        return a.first < b.first;
+    });
+
+    size_t numMerged = 0;
+
+    for(size_t i = 1; i<intervals.size(); ++i)
+    {
+        auto& current = intervals[numMerged];
+
+        if(qint64(intervals[i].first) <= qint64(current.last) + 1)
+            current.last = std::max(current.last, intervals[i].last);
+        else
+            intervals[++numMerged] = intervals[i];
+    }
+
+    intervals.resize(numMerged + 1);
+}
@@ -0,0 +1,143 @@
+#ifndef INTERVALSET_H
+#define INTERVALSET_H
+/* *****************************************************************************
+Copyright (c) 2016-2021, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+// Written by: Stevan Gavrilovic
+
+// A set of integer IDs stored as sorted, disjoint and non-adjacent closed intervals, e.g., the IDs 1,2,3,7 are stored as [1,3] and [7,7]
+// A selection such as "1-1000000" is a single interval, so the operations on a set cost time and memory in the number of intervals rather
+// than in the number of IDs
+
+#include <QString>
+
+#include <iterator>
+#include <vector>
+
+class IntervalSet
+{
+public:
+    struct Interval
+    {
+        int first;
+        int last;
+    };
+
+    // Iterates over the IDs in the set in increasing order
+    class const_iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = int;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const int*;
+        using reference = int;
+
+        const_iterator(const std::vector<Interval>* intervals, size_t index) : intervals(intervals), index(index), ID(index < intervals->size() ? (*intervals)[index].first : 0) {}
+
+        int operator*() const { return ID; }
+
+        const_iterator& operator++()
+        {
+            if(ID == (*intervals)[index].last)
+            {
+                ++index;
+                ID = index < intervals->size() ? (*intervals)[index].first : 0;
+            }
+            else
+            {
+                ++ID;
+            }
+
+            return *this;
+        }
+
+        bool operator==(const const_iterator& other) const { return index == other.index && ID == other.ID; }
+        bool operator!=(const const_iterator& other) const { return !(*this == other); }
+
+    private:
+        const std::vector<Interval>* intervals;
+        size_t index;
+        int ID;
+    };
+
+    IntervalSet();
+
+    // Parses a list of IDs and ranges of IDs in the form 1,3,5-10,12. The parts can be in any order and can overlap, whitespace is ignored
+    // The set is replaced with the IDs in the list. Returns 0 on success, otherwise the set is left unchanged
+    int parse(const QString& list, QString& err);
+
+    // Returns the set in the form 1,3,5-10,12, with the shortest list of parts
+    QString toString(void) const;
+
+    void insert(const int ID);
+
+    // Inserts the IDs from first to last inclusive
+    void insert(const int first, const int last);
+
+    bool contains(const int ID) const;
+
+    IntervalSet united(const IntervalSet& other) const;
+    IntervalSet intersected(const IntervalSet& other) const;
+
+    void clear(void);
+
+    bool isEmpty(void) const;
+
+    // The number of IDs in the set
+    qint64 size(void) const;
+
+    // The smallest and largest IDs in the set, the set must not be empty
+    int first(void) const;
+    int last(void) const;
+
+    const std::vector<Interval>& getIntervals(void) const;
+
+    const_iterator begin(void) const;
+    const_iterator end(void) const;
+
+    bool operator==(const IntervalSet& other) const;
+    bool operator!=(const IntervalSet& other) const;
+
+private:
+
+    // Sorts the intervals and merges the ones that overlap or touch
+    static void normalize(std::vector<Interval>& intervals);
+
+    std::vector<Interval> intervals;
+};
+
+#endif // INTERVALSET_H
@@ -37,8 +37,11 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 // Written by: Stevan Gavrilovic
 
 #include "CSVReaderWriter.h"
+#include "CSVTable.h"
 #include "ComponentInputWidget.h"
 #include "GeneralInformationWidget.h"
+#include "HeatMapGrid.h"
+#include "LayerTreeView.h"
 #include "MainWindowWorkflowApp.h"
 #include "PelicunPostProcessor.h"
 #include "REmpiricalProbabilityDistribution.h"
@@ -62,6 +65,7 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 #include <QGraphicsLayout>
 #include <QGridLayout>
 #include <QGroupBox>
+#include <QHash>
 #include <QHeaderView>
 #include <QLabel>
 #include <QLineSeries>
@@ -76,12 +80,19 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 #include <QTextTable>
 #include <QValueAxis>
 
+#include <cmath>
+#include <limits>
+
 // GIS headers
 #include "Basemap.h"
+#include "ColorRamp.h"
 #include "FeatureTable.h"
 #include "FeatureCollectionLayer.h"
 #include "Map.h"
 #include "MapGraphicsView.h"
+#include "MinMaxStretchParameters.h"
+#include "RasterLayer.h"
+#include "StretchRenderer.h"
 
 using namespace QtCharts;
 
@@ -294,44 +305,148 @@ void PelicunPostProcessor::importResults(const QString& pathToResults)
 
     CSVReaderWriter csvTool;
 
-    DMdata = csvTool.parseCSVFile(pathToResults + QDir::separator() + DMResultsSheet,errMsg);
+    csvTool.parseCSVFile(pathToResults + QDir::separator() + DMResultsSheet,DMdata,errMsg,true);
     if(!errMsg.isEmpty())
         throw errMsg;
 
-    DVdata = csvTool.parseCSVFile(pathToResults + QDir::separator() + DVResultsSheet,errMsg);
+    csvTool.parseCSVFile(pathToResults + QDir::separator() + DVResultsSheet,DVdata,errMsg,true);
     if(!errMsg.isEmpty())
         throw errMsg;
 
-    EDPdata = csvTool.parseCSVFile(pathToResults + QDir::separator() + EDPreultsSheet,errMsg);
+    csvTool.parseCSVFile(pathToResults + QDir::separator() + EDPreultsSheet,EDPdata,errMsg,true);
     if(!errMsg.isEmpty())
         throw errMsg;
 
-    if(!DVdata.empty())
-        this->processDVResults(DVdata);
+    if(!DVdata.isEmpty())
+    {
+        // Process all of the rows after the header rows
+        QVector<int> resultRows;
+        resultRows.reserve(DVdata.rowCount());
+
+        for(int i = numHeaderRows; i<DVdata.rowCount(); ++i)
+            resultRows.push_back(i);
+
+        this->processDVResults(DVdata, resultRows);
+    }
     else
     {
         errMsg = "The DV results are empty";
         throw errMsg;
     }
 
+    resultsFolder = pathToResults;
+
+    this->createHeatMaps(resultsFolder);
+
 }
 
 
-int PelicunPostProcessor::processDVResults(const QVector<QStringList>& DVResults)
+void PelicunPostProcessor::createHeatMaps(const QString& folder, const QString& fileSuffix)
 {
-    if(DVResults.size() < numHeaderRows)
+    // Remove the heat maps of the previous results
+    for(auto&& it : heatMapLayerIDs)
+        theVisualizationWidget->removeLayerFromMapAndTree(it);
+
+    heatMapLayerIDs.clear();
+
+    // A small region is easier to read from the building footprints themselves
+    if(heatMapLossRatios.size() < size_t(minBuildingsForHeatMap))
+        return;
+
+    double xMin = std::numeric_limits<double>::max();
+    double xMax = std::numeric_limits<double>::lowest();
+    double yMin = std::numeric_limits<double>::max();
+    double yMax = std::numeric_limits<double>::lowest();
+
+    for(size_t i = 0; i<heatMapLossRatios.size(); ++i)
+    {
+        auto x = heatMapCoordinates[2*i];
+        auto y = heatMapCoordinates[2*i+1];
+
+        if(!std::isfinite(x) || !std::isfinite(y))
+            continue;
+
+        xMin = qMin(xMin, x);
+        xMax = qMax(xMax, x);
+        yMin = qMin(yMin, y);
+        yMax = qMax(yMax, y);
+    }
+
+    if(xMin > xMax)
+        return;
+
+    // Fall back to cells of about 100 m if the buildings are all at one location
+    auto cellSize = qMax(xMax - xMin, yMax - yMin)/heatMapCellsAcross;
+
+    if(cellSize <= 0.0)
+        cellSize = 0.001;
+
+    LayerTreeView *layersTreeView = theVisualizationWidget->getLayersTree();
+
+    auto heatMapsItem = layersTreeView->getTreeItem("Loss Heat Maps", nullptr);
+
+    if(heatMapsItem == nullptr)
+    {
+        auto heatMapsID = theVisualizationWidget->createUniqueID();
+        heatMapsItem = layersTreeView->addItemToTree("Loss Heat Maps", heatMapsID);
+    }
+
+    auto addHeatMap = [&](const std::vector<double>& values, const HeatMapGrid::Statistic statistic, const QString& baseName, const QString& layerName)
+    {
+        HeatMapGrid grid;
+
+        QString err;
+        if(grid.build(heatMapCoordinates, values, cellSize, statistic, heatMapSmoothing, err) != 0)
+            throw QString("Error creating the heat map " + layerName + ": " + err);
+
+        // Skip the layer if none of the buildings has a value, e.g., if they have no repair costs
+        double minValue = 0.0;
+        double maxValue = 0.0;
+        if(!grid.getValueRange(minValue, maxValue))
+            return;
+
+        auto filePath = folder + QDir::separator() + baseName + fileSuffix + ".tif";
+
+        if(grid.writeGeoTIFF(filePath, err) != 0)
+            throw QString("Error writing the heat map " + layerName + ": " + err);
+
+        auto layer = theVisualizationWidget->createAndAddRasterLayer(filePath, layerName, heatMapsItem);
+
+        if(layer == nullptr)
+            throw QString("Error adding the heat map " + layerName + " to the map");
+
+        // Stretch the colors over the range of the cells
+        using namespace Esri::ArcGISRuntime;
+
+        auto stretchParams = new MinMaxStretchParameters(QList<double>{minValue}, QList<double>{maxValue}, layer);
+        auto colorRamp = ColorRamp::create(PresetColorRampType::Elevation, 256, layer);
+
+        layer->setRenderer(new StretchRenderer(stretchParams, QList<double>(), false, colorRamp, layer));
+        layer->setOpacity(0.7);
+
+        heatMapLayerIDs.append(layer->layerId());
+    };
+
+    addHeatMap(heatMapLossRatios, HeatMapGrid::Statistic::Mean, "LossRatioHeatMap", "Mean Loss Ratio");
+    addHeatMap(heatMapRepairCosts, HeatMapGrid::Statistic::Sum, "RepairCostHeatMap", "Total Repair Cost");
+}
+
+
+int PelicunPostProcessor::processDVResults(const CSVTable& DVResults, const QVector<int>& resultRows)
+{
+    if(DVResults.rowCount() < numHeaderRows)
     {
         QString msg = "No results to import!";
         throw msg;
     }
 
-    auto numHeaderColumns = DVResults.at(0).size();
+    auto numHeaderColumns = DVResults.columnCount(0);
 
     QStringList headerStrings;
 
     for(int i = 0; i<numHeaderColumns; ++i)
     {
-        QString headerStr = DVResults.at(0).at(i) +"-"+ DVResults.at(1).at(i) +"-"+ DVResults.at(2).at(i) +"-"+ DVResults.at(3).at(i);
+        QString headerStr = DVResults.at(0,i).toString() +"-"+ DVResults.at(1,i).toString() +"-"+ DVResults.at(2,i).toString() +"-"+ DVResults.at(3,i).toString();
 
         headerStrings.append(headerStr);
     }
@@ -382,7 +497,7 @@ int PelicunPostProcessor::processDVResults(const QVector<QStringList>& DVResults
 
     pelicunResultsTableWidget->setColumnCount(tableHeadings.size());
     pelicunResultsTableWidget->setHorizontalHeaderLabels(tableHeadings);
-    pelicunResultsTableWidget->setRowCount(DVResults.size()-numHeaderRows);
+    pelicunResultsTableWidget->setRowCount(resultRows.size());
 
     auto cumulativeSagg = 0.0;
     auto cumulativeNSagg = 0.0;
@@ -429,36 +544,66 @@ int PelicunPostProcessor::processDVResults(const QVector<QStringList>& DVResults
         throw msg;
     }
 
-    // 4 rows of headers in the results file
-    for(int i = numHeaderRows, count = 0; i<DVResults.size(); ++i, ++count)
+    // The loss ratios are set on the building features in one batch after the loop
+    QVector<int> lossRatioIDs;
+    QVector<QVariant> lossRatioValues;
+    lossRatioIDs.reserve(resultRows.size());
+    lossRatioValues.reserve(resultRows.size());
+
+    // The locations of the buildings are read in place from the database for the heat maps
+    auto latitudeCol = theBuildingDB->getAttributeIndex("Latitude");
+    auto longitudeCol = theBuildingDB->getAttributeIndex("Longitude");
+
+    auto latitudes = latitudeCol == -1 ? nullptr : theBuildingDB->getNumberColumn(latitudeCol);
+    auto longitudes = longitudeCol == -1 ? nullptr : theBuildingDB->getNumberColumn(longitudeCol);
+
+    heatMapCoordinates.clear();
+    heatMapLossRatios.clear();
+    heatMapRepairCosts.clear();
+
+    if(latitudes != nullptr && longitudes != nullptr)
+    {
+        heatMapCoordinates.reserve(2*resultRows.size());
+        heatMapLossRatios.reserve(resultRows.size());
+        heatMapRepairCosts.reserve(resultRows.size());
+    }
+
+    // The rows are accessed in place in the mapped results file
+    for(int count = 0; count<resultRows.size(); ++count)
     {
-        auto inputRow = DVResults.at(i);
+        auto rowIndex = resultRows.at(count);
 
-        auto buildingID = objectToInt(inputRow.at(0));
+        if(DVResults.columnCount(rowIndex) != numHeaderColumns)
+            throw QString("Inconsistency between the number of columns in row " + QString::number(rowIndex+1) + " and the header of the DV results file");
+
+        auto inputRow = [&DVResults, rowIndex](const int col)
+        {
+            return DVResults.at(rowIndex,col);
+        };
+
+        auto buildingID = objectToInt(inputRow(0));
 
         auto building = theBuildingDB->getComponent(buildingID);
 
-        if(building.ID == -1)
+        if(!building.exists())
             throw QString("Could not find the building ID " + QString::number(buildingID) + " in the database");
 
         for(int j = 1; j<numHeaderColumns; ++j)
         {
-            building.ResultsValues.insert(headerStrings.at(j),inputRow.at(j).toDouble());
+            building.addResult(headerStrings.at(j),inputRow(j).toDouble());
         }
 
         // Defaults to 1.0 if no replacement cost is given, i.e., it assumes the repair cost is the loss ratio
-        auto replacementCostVar = building.ComponentAttributes.value("ReplacementCost",QVariant(1.0));
+        auto replacementCostVar = building.getAttributeValue("ReplacementCost",QVariant(1.0));
 
         auto replacementCost = objectToDouble(replacementCostVar);
 
-        building.ID = buildingID;
-
         buildingsVec.push_back(building);
 
         // This assumes that the output from pelicun will not change
-        auto IDStr = inputRow.at(0);                                // ID
-        auto totalRepairCost = inputRow.at(indexRCagg);             // Aggregate repair cost (mean)
-        auto replaceMentProb = inputRow.at(indexRepairImpracProb);  // Replacement probability, i.e., repair impractical probability
+        auto IDStr = inputRow(0).toString();                                // ID
+        auto totalRepairCost = inputRow(indexRCagg).toString();             // Aggregate repair cost (mean)
+        auto replaceMentProb = inputRow(indexRepairImpracProb).toString();  // Replacement probability, i.e., repair impractical probability
 
         auto repairTime = 0.0;
 
@@ -469,17 +614,17 @@ int PelicunPostProcessor::processDVResults(const QVector<QStringList>& DVResults
 
         // Aggregate repair time (mean)
         if(indexRepairTime != -1)
-            repairTime = objectToDouble(inputRow.at(indexRepairTime));
+            repairTime = objectToDouble(inputRow(indexRepairTime));
 
         cumulativeRepairTime += repairTime;
 
         if(indexSRC1_1 != -1)
         {
-            auto StructDS1 = objectToDouble(inputRow.at(indexSRC1_1));    // Structural losses damage state 1 (mean)
-            auto StructDS2 = objectToDouble(inputRow.at(indexSRC1_1+1));  // Structural losses damage state 2 (mean)
-            auto StructDS3 = objectToDouble(inputRow.at(indexSRC1_1+2));  // Structural losses damage state 3 (mean)
-            auto StructDS4 = objectToDouble(inputRow.at(indexSRC1_1+3));  // Structural losses damage state 4 (mean)
-            StructDS4 += objectToDouble(inputRow.at(indexSRC1_1+4));      // Structural losses damage state 4_2 (mean)
+            auto StructDS1 = objectToDouble(inputRow(indexSRC1_1));    // Structural losses damage state 1 (mean)
+            auto StructDS2 = objectToDouble(inputRow(indexSRC1_1+1));  // Structural losses damage state 2 (mean)
+            auto StructDS3 = objectToDouble(inputRow(indexSRC1_1+2));  // Structural losses damage state 3 (mean)
+            auto StructDS4 = objectToDouble(inputRow(indexSRC1_1+3));  // Structural losses damage state 4 (mean)
+            StructDS4 += objectToDouble(inputRow(indexSRC1_1+4));      // Structural losses damage state 4_2 (mean)
 
             cumulativeStructDS1 += StructDS1;
             cumulativeStructDS2 += StructDS2;
@@ -490,10 +635,10 @@ int PelicunPostProcessor::processDVResults(const QVector<QStringList>& DVResults
 
         if(indexNSARC1_1 != -1)
         {
-            auto NSAccDS1 = objectToDouble(inputRow.at(indexNSARC1_1));    // Non-structural acceleration sensitive losses damage state 1 (mean)
-            auto NSAccDS2 = objectToDouble(inputRow.at(indexNSARC1_1+1));  // Non-structural acceleration sensitive losses damage state 2 (mean)
-            auto NSAccDS3 = objectToDouble(inputRow.at(indexNSARC1_1+2));  // Non-structural acceleration sensitive losses damage state 3 (mean)
-            auto NSAccDS4 = objectToDouble(inputRow.at(indexNSARC1_1+3));  // Non-structural acceleration sensitive losses damage state 4 (mean)
+            auto NSAccDS1 = objectToDouble(inputRow(indexNSARC1_1));    // Non-structural acceleration sensitive losses damage state 1 (mean)
+            auto NSAccDS2 = objectToDouble(inputRow(indexNSARC1_1+1));  // Non-structural acceleration sensitive losses damage state 2 (mean)
+            auto NSAccDS3 = objectToDouble(inputRow(indexNSARC1_1+2));  // Non-structural acceleration sensitive losses damage state 3 (mean)
+            auto NSAccDS4 = objectToDouble(inputRow(indexNSARC1_1+3));  // Non-structural acceleration sensitive losses damage state 4 (mean)
 
             cumulativeNSAccDS1 += NSAccDS1;
             cumulativeNSAccDS2 += NSAccDS2;
@@ -504,10 +649,10 @@ int PelicunPostProcessor::processDVResults(const QVector<QStringList>& DVResults
 
         if(indexNSDRC1_1 != -1)
         {
-            auto NSDriftDS1 = objectToDouble(inputRow.at(24));  // Non-structural drift sensitive losses damage state 1 (mean)
-            auto NSDriftDS2 = objectToDouble(inputRow.at(25));  // Non-structural drift sensitive losses damage state 2 (mean)
-            auto NSDriftDS3 = objectToDouble(inputRow.at(26));  // Non-structural drift sensitive losses damage state 3 (mean)
-            auto NSDriftDS4 = objectToDouble(inputRow.at(27));  // Non-structural drift sensitive losses damage state 4 (mean)
+            auto NSDriftDS1 = objectToDouble(inputRow(24));  // Non-structural drift sensitive losses damage state 1 (mean)
+            auto NSDriftDS2 = objectToDouble(inputRow(25));  // Non-structural drift sensitive losses damage state 2 (mean)
+            auto NSDriftDS3 = objectToDouble(inputRow(26));  // Non-structural drift sensitive losses damage state 3 (mean)
+            auto NSDriftDS4 = objectToDouble(inputRow(27));  // Non-structural drift sensitive losses damage state 4 (mean)
 
             cumulativeNSDriftDS1 += NSDriftDS1;
             cumulativeNSDriftDS2 += NSDriftDS2;
@@ -518,10 +663,10 @@ int PelicunPostProcessor::processDVResults(const QVector<QStringList>& DVResults
 
         if(indexInjuriesSev1 != -1)
         {
-            injSevLvl1 = objectToDouble(inputRow.at(indexInjuriesSev1));    // Injuries severity level 1 (mean)
-            injSevLvl2 = objectToDouble(inputRow.at(indexInjuriesSev1+1));  // Injuries severity level 2 (mean)
-            injSevLvl3 = objectToDouble(inputRow.at(indexInjuriesSev1+2));  // Injuries severity level 3 (mean)
-            fatalities = objectToDouble(inputRow.at(indexInjuriesSev1+3));  // Injuries severity level 4 (mean)
+            injSevLvl1 = objectToDouble(inputRow(indexInjuriesSev1));    // Injuries severity level 1 (mean)
+            injSevLvl2 = objectToDouble(inputRow(indexInjuriesSev1+1));  // Injuries severity level 2 (mean)
+            injSevLvl3 = objectToDouble(inputRow(indexInjuriesSev1+2));  // Injuries severity level 3 (mean)
+            fatalities = objectToDouble(inputRow(indexInjuriesSev1+3));  // Injuries severity level 4 (mean)
 
             cumulativeinjSevLvl1 += injSevLvl1;
             cumulativeinjSevLvl2 += injSevLvl2;
@@ -530,10 +675,10 @@ int PelicunPostProcessor::processDVResults(const QVector<QStringList>& DVResults
         }
 
         if(indexSRCagg != -1)
-            cumulativeSagg += objectToDouble(inputRow.at(indexSRCagg));
+            cumulativeSagg += objectToDouble(inputRow(indexSRCagg));
 
         if(indexNSRCagg != -1)
-            cumulativeNSagg += objectToDouble(inputRow.at(indexNSRCagg));
+            cumulativeNSagg += objectToDouble(inputRow(indexNSRCagg));
 
         auto repairCost = objectToDouble(totalRepairCost);
         auto lossRatio = repairCost/replacementCost;
@@ -556,19 +701,30 @@ int PelicunPostProcessor::processDVResults(const QVector<QStringList>& DVResults
         pelicunResultsTableWidget->setItem(count,4, fatalitiesItem);
         pelicunResultsTableWidget->setItem(count,5, lossRatioItem);
 
-        auto buildingFeature = building.ComponentFeature;
-
         auto atrb = "LossRatio";
         auto atrbVal = QVariant(lossRatio);
 
-        buildingFeature->attributes()->replaceAttribute("LossRatio",lossRatio);
-        buildingFeature->featureTable()->updateFeature(buildingFeature);
+        lossRatioIDs.push_back(buildingID);
+        lossRatioValues.push_back(atrbVal);
+
+        if(latitudes != nullptr && longitudes != nullptr)
+        {
+            auto row = theBuildingDB->getRow(buildingID);
+
+            heatMapCoordinates.push_back(longitudes->at(row));
+            heatMapCoordinates.push_back(latitudes->at(row));
+            heatMapLossRatios.push_back(lossRatio);
+            heatMapRepairCosts.push_back(repairCost);
+        }
 
         // Get the feature UID
-        auto uid = building.UID;
+        auto uid = building.getUID();
         theVisualizationWidget->updateSelectedComponent("BUILDINGS",uid,atrb,atrbVal);
     }
 
+    if(theBuildingDB->updateComponentAttributes("LossRatio",lossRatioIDs,lossRatioValues) != 0)
+        throw QString("Error setting the loss ratios of the buildings");
+
     //  CASUALTIES
     QBarSet *casualtiesSet = new QBarSet("Casualties");
 
@@ -792,62 +948,86 @@ int PelicunPostProcessor::printToPDF(const QString& outputPath)
 }
 
 
-void PelicunPostProcessor::processResultsSubset(const std::set<int>& selectedComponentIDs)
+void PelicunPostProcessor::processResultsSubset(const IntervalSet& selectedComponentIDs)
 {
 
-    if(selectedComponentIDs.empty())
+    if(selectedComponentIDs.isEmpty())
         return;
 
-    if(DVdata.size() < numHeaderRows)
+    if(DVdata.rowCount() <= numHeaderRows)
     {
         QString msg = "No results to import!";
         throw msg;
     }
 
-    if(DVdata.at(numHeaderRows).isEmpty() || DVdata.last().isEmpty())
+    // Get the IDs of all of the results in one pass over the mapped file
+    QString errMsg;
+    auto resultIDs = DVdata.getInt64Column(0, numHeaderRows, errMsg);
+
+    if(!errMsg.isEmpty())
+        throw errMsg;
+
+    if(resultIDs.empty())
     {
         QString msg = "No values in the cells";
         throw msg;
     }
 
-    auto firstID = objectToInt(DVdata.at(numHeaderRows).at(0));
+    auto firstID = resultIDs.first();
 
-    auto lastID = objectToInt(DVdata.last().at(0));
+    auto lastID = resultIDs.last();
 
-    QVector<QStringList> DVsubset(&DVdata[0],&DVdata[numHeaderRows]);
+    // Check that the selected IDs fall within the bounds of the data, the selection is sorted so only its ends need to be checked
+    if(selectedComponentIDs.first()<firstID || selectedComponentIDs.last()>lastID)
+    {
+        auto id = selectedComponentIDs.first()<firstID ? selectedComponentIDs.first() : selectedComponentIDs.last();
+
+        QString msg = "ID " + QString::number(id) + " is out of bounds of the results";
+        throw msg;
+    }
+
+    // Pick out the rows of the selected IDs in one pass over the results, keeping the first row of any ID that is repeated
+    IntervalSet foundIDs;
+
+    QVector<int> subsetRows;
+    subsetRows.reserve(static_cast<int>(qMin(selectedComponentIDs.size(), qint64(resultIDs.size()))));
 
-    for(auto&& id : selectedComponentIDs)
+    for(int i = 0; i<resultIDs.size(); ++i)
     {
-        // Check that the ID falls within the bounds of the data
-        if(id<firstID || id>lastID)
-        {
-            QString msg = "ID " + QString::number(id) + " is out of bounds of the results";
-            throw msg;
-        }
+        auto id = resultIDs.at(i);
 
-        auto found = false;
-        for(int i = numHeaderRows; i<DVdata.size(); ++i)
-        {
-            auto inputRow = DVdata.at(i);
+        if(id<selectedComponentIDs.first() || id>selectedComponentIDs.last())
+            continue;
 
-            auto buildingID = objectToInt(inputRow.at(0));
+        if(!selectedComponentIDs.contains(int(id)) || foundIDs.contains(int(id)))
+            continue;
 
-            if(id == buildingID)
-            {
-                DVsubset << inputRow;
-                found = true;
-                break;
-            }
-        }
+        foundIDs.insert(int(id));
+        subsetRows.push_back(i + numHeaderRows);
+    }
 
-        if(!found)
+    if(subsetRows.size() != selectedComponentIDs.size())
+    {
+        for(auto&& id : selectedComponentIDs)
         {
-            QString msg = "ID " + QString::number(id) + " cannot be found in the results";
-            throw msg;
+            if(!foundIDs.contains(id))
+            {
+                QString msg = "ID " + QString::number(id) + " cannot be found in the results";
+                throw msg;
+            }
         }
     }
 
-    this->processDVResults(DVsubset);
+    this->processDVResults(DVdata, subsetRows);
+
+    // Rebuild the heat maps from the selected buildings, which removes them if there are too few. The heat maps of the full results are kept
+    if(subsetHeatMapsDir == nullptr)
+        subsetHeatMapsDir = std::make_unique<QTemporaryDir>();
+
+    if(!subsetHeatMapsDir->isValid())
+        throw QString("Error creating a temporary folder for the heat maps: " + subsetHeatMapsDir->errorString());
+
+    this->createHeatMaps(subsetHeatMapsDir->path(), "Subset" + QString::number(++numSubsetHeatMaps));
 }
 
 
@@ -1189,7 +1369,16 @@ void PelicunPostProcessor::clear(void)
     EDPdata.clear();
     buildingsVec.clear();
 
+    for(auto&& it : heatMapLayerIDs)
+        theVisualizationWidget->removeLayerFromMapAndTree(it);
+
+    heatMapLayerIDs.clear();
+    heatMapCoordinates.clear();
+    heatMapLossRatios.clear();
+    heatMapRepairCosts.clear();
+
     outputFilePath.clear();
+    resultsFolder.clear();
 
     totalCasValueLabel->clear();
     totalLossValueLabel->clear();
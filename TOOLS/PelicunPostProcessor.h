@@ -39,13 +39,17 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 // Written by: Stevan Gavrilovic
 
 #include "ComponentDatabase.h"
+#include "CSVTable.h"
 #include "EmbeddedMapViewWidget.h"
+#include "IntervalSet.h"
 
 #include <QString>
+#include <QStringList>
 #include <QMainWindow>
+#include <QTemporaryDir>
 
 #include <memory>
-#include <set>
+#include <vector>
 
 class REmpiricalProbabilityDistribution;
 class EmbeddedMapViewWidget;
@@ -121,7 +125,7 @@ public:
         return val;
     }
 
-    void processResultsSubset(const std::set<int>& selectedComponentIDs);
+    void processResultsSubset(const IntervalSet& selectedComponentIDs);
 
     void setCurrentlyViewable(bool status);
 
@@ -139,14 +143,23 @@ private slots:
 
 private:
 
-    int processDVResults(const QVector<QStringList>& DVResults);
+    // Processes the given rows of the DV results, the first rows of the table are expected to contain the header information
+    int processDVResults(const CSVTable& DVResults, const QVector<int>& resultRows);
 
-    QVector<QStringList> DMdata;
-    QVector<QStringList> DVdata;
-    QVector<QStringList> EDPdata;
+    // Rasterizes the loss ratios and the repair costs of the buildings from the last call to processDVResults into GeoTIFFs in the
+    // given folder, with the suffix at the end of the file names, and shows them as raster layers in place of the building footprints
+    // of a large region
+    void createHeatMaps(const QString& folder, const QString& fileSuffix = QString());
+
+    CSVTable DMdata;
+    CSVTable DVdata;
+    CSVTable EDPdata;
 
     QString outputFilePath;
 
+    // The folder of the imported results, where the heat maps are written
+    QString resultsFolder;
+
     QMenu* viewMenu;
 
     QLabel* totalCasLabel;
@@ -193,6 +206,25 @@ private:
 
     QVector<Component> buildingsVec;
 
+    // The locations of the buildings as x and y in WGS84, and their results, for the heat maps
+    std::vector<double> heatMapCoordinates;
+    std::vector<double> heatMapLossRatios;
+    std::vector<double> heatMapRepairCosts;
+
+    // The layers of the heat maps, which are replaced when new results are imported
+    QStringList heatMapLayerIDs;
+
+    // The heat maps of a subset of the buildings are written here rather than over those of the full results. Each subset gets new
+    // file names, since the layers that were removed may still have the files of the previous one open
+    std::unique_ptr<QTemporaryDir> subsetHeatMapsDir;
+    int numSubsetHeatMaps = 0;
+
+    // The heat maps are made when there are at least this many buildings, with this many cells across the longer side of the region and
+    // smoothed with a Gaussian kernel with a standard deviation of heatMapSmoothing cells
+    static const int minBuildingsForHeatMap = 10000;
+    static const int heatMapCellsAcross = 512;
+    static constexpr double heatMapSmoothing = 1.5;
+
     QByteArray uiState;
 
     // The number of header rows in the Pelicun results file
@@ -0,0 +1,307 @@
+/* *****************************************************************************
+Copyright (c) 2016-2021, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+// Written by: Stevan Gavrilovic
+
+#include "PointPyramid.h"
+
+#include "FeatureCollection.h"
+#include "FeatureCollectionLayer.h"
+#include "FeatureCollectionTable.h"
+#include "GroupLayer.h"
+
+#include <QVector>
+#include <QtConcurrent/QtConcurrentMap>
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+
+using namespace Esri::ArcGISRuntime;
+
+namespace
+{
+
+// The depths of the quadtree that are made into levels, the coarsest level has a grid of 16 by 16 cells
+const int firstDepth = 4;
+const int maxDepth = 16;
+
+// The spacing in pixels of the points of a level when it is first shown
+const double pixelsPerCell = 10.0;
+
+// The size of a degree in meters at the equator and of a pixel in meters at a scale of one, at 96 dpi
+const double metersPerDegree = 111320.0;
+const double metersPerPixel = 0.0254/96.0;
+
+// Returns the scale at which the cells of the given size are pixelsPerCell pixels across
+double getScaleForCellSize(const double cellSize)
+{
+    return cellSize*metersPerDegree/(pixelsPerCell*metersPerPixel);
+}
+
+// Interleaves the bits of the cell coordinates, so that the points in each cell at any depth are next to each other when sorted by the code
+quint32 getMortonCode(const quint32 ix, const quint32 iy)
+{
+    auto spread = [](quint32 v)
+    {
+        v = (v | (v << 8)) & 0x00FF00FF;
+        v = (v | (v << 4)) & 0x0F0F0F0F;
+        v = (v | (v << 2)) & 0x33333333;
+        v = (v | (v << 1)) & 0x55555555;
+        return v;
+    };
+
+    return spread(ix) | (spread(iy) << 1);
+}
+
+struct CodedPoint
+{
+    quint32 code;
+    int index;
+};
+
+}
+
+
+PointPyramid::PointPyramid()
+{
+
+}
+
+
+void PointPyramid::build(const std::vector<double>& coordinates, const int maxPointsPerLevel, const bool keepAllPoints)
+{
+    levels.clear();
+
+    const int numPoints = int(coordinates.size()/2);
+
+    if(numPoints == 0 || maxPointsPerLevel <= 0)
+        return;
+
+    double xMin = std::numeric_limits<double>::max();
+    double yMin = std::numeric_limits<double>::max();
+    double xMax = std::numeric_limits<double>::lowest();
+    double yMax = std::numeric_limits<double>::lowest();
+
+    for(int i = 0; i<numPoints; ++i)
+    {
+        xMin = qMin(xMin, coordinates[2*i]);
+        xMax = qMax(xMax, coordinates[2*i]);
+        yMin = qMin(yMin, coordinates[2*i+1]);
+        yMax = qMax(yMax, coordinates[2*i+1]);
+    }
+
+    const double extent = qMax(xMax - xMin, yMax - yMin);
+
+    // If the points are all in one place one of them stands for all of them
+    if(!(extent > 0.0))
+    {
+        Level level;
+
+        if(keepAllPoints || numPoints <= maxPointsPerLevel)
+        {
+            level.points.resize(numPoints);
+            std::iota(level.points.begin(), level.points.end(), 0);
+        }
+        else
+        {
+            level.points.push_back(0);
+        }
+
+        levels.push_back(std::move(level));
+
+        return;
+    }
+
+    // Sort the points by the cells that they are in at the deepest level, the cells of the other levels are runs of points in this order
+    const int numCells = 1 << maxDepth;
+
+    std::vector<CodedPoint> sortedPoints(numPoints);
+
+    for(int i = 0; i<numPoints; ++i)
+    {
+        auto ix = qMin(numCells - 1, int((coordinates[2*i] - xMin)/extent*numCells));
+        auto iy = qMin(numCells - 1, int((coordinates[2*i+1] - yMin)/extent*numCells));
+
+        sortedPoints[i] = {getMortonCode(quint32(ix), quint32(iy)), i};
+    }
+
+    std::sort(sortedPoints.begin(), sortedPoints.end(), [](const CodedPoint& a, const CodedPoint& b)
+    {
+        return a.code < b.code || (a.code == b.code && a.index < b.index);
+    });
+
+    // Each depth of the quadtree is independent of the others so they are built in parallel
+    std::vector<Level> candidates(maxDepth - firstDepth + 1);
+
+    QVector<int> depths;
+    for(int depth = firstDepth; depth <= maxDepth; ++depth)
+        depths.push_back(depth);
+
+    QtConcurrent::blockingMap(depths, [&](const int depth)
+    {
+        auto& level = candidates[depth - firstDepth];
+
+        level.cellSize = extent/double(1 << depth);
+
+        const int shift = 2*(maxDepth - depth);
+        const int cellShift = maxDepth - depth;
+
+        size_t first = 0;
+        while(first < sortedPoints.size())
+        {
+            const quint32 cellCode = sortedPoints[first].code >> shift;
+
+            // The center of the cell, from the cell coordinates of the first point, which all of the points in the cell share
+            const auto& firstIndex = sortedPoints[first].index;
+            const int ix = qMin(numCells - 1, int((coordinates[2*firstIndex] - xMin)/extent*numCells)) >> cellShift;
+            const int iy = qMin(numCells - 1, int((coordinates[2*firstIndex+1] - yMin)/extent*numCells)) >> cellShift;
+
+            const double xCenter = xMin + (ix + 0.5)*level.cellSize;
+            const double yCenter = yMin + (iy + 0.5)*level.cellSize;
+
+            int nearest = -1;
+            double nearestDistance = std::numeric_limits<double>::max();
+
+            size_t last = first;
+            for(; last < sortedPoints.size() && (sortedPoints[last].code >> shift) == cellCode; ++last)
+            {
+                const int index = sortedPoints[last].index;
+
+                const double dx = coordinates[2*index] - xCenter;
+                const double dy = coordinates[2*index+1] - yCenter;
+                const double distance = dx*dx + dy*dy;
+
+                if(distance < nearestDistance)
+                {
+                    nearestDistance = distance;
+                    nearest = index;
+                }
+            }
+
+            level.points.push_back(nearest);
+
+            first = last;
+        }
+
+        std::sort(level.points.begin(), level.points.end());
+    });
+
+    // The full resolution level is shown from the scale at which the points are no longer thinned out, i.e., are all in their own cells
+    // except for any that are in the same place
+    const size_t numSeparatePoints = candidates.back().points.size();
+    double fullResolutionCellSize = candidates.back().cellSize;
+
+    for(auto&& level : candidates)
+    {
+        if(level.points.size() == numSeparatePoints)
+        {
+            fullResolutionCellSize = level.cellSize;
+            break;
+        }
+    }
+
+    // Keep the levels that thin out the points and are below the cap, a level that does not thin out its coarser neighbour is dropped
+    for(auto&& level : candidates)
+    {
+        const int numLevelPoints = int(level.points.size());
+
+        if(size_t(numLevelPoints) == numSeparatePoints || numLevelPoints > maxPointsPerLevel)
+            break;
+
+        if(!levels.empty() && int(levels.back().points.size()) == numLevelPoints)
+            continue;
+
+        levels.push_back(std::move(level));
+    }
+
+    // If no level was kept, e.g., the coarsest level has too many points, it is shown when zoomed out anyway rather than all of the points
+    if(levels.empty() && int(candidates.front().points.size()) < numPoints)
+        levels.push_back(std::move(candidates.front()));
+
+    // Past the cap the full resolution level is only shown zoomed in, where few of its points are in view at a time
+    if(keepAllPoints || numPoints <= maxPointsPerLevel || levels.empty())
+    {
+        Level fullLevel;
+        fullLevel.cellSize = fullResolutionCellSize;
+        fullLevel.points.resize(numPoints);
+        std::iota(fullLevel.points.begin(), fullLevel.points.end(), 0);
+
+        levels.push_back(std::move(fullLevel));
+    }
+
+    // Each level is shown from the scale at which its cells are pixelsPerCell pixels across until the next level takes over
+    // The coarsest level is shown at any scale above that and the finest at any scale below
+    for(size_t i = 0; i<levels.size(); ++i)
+    {
+        levels[i].minScale = i == 0 ? 0.0 : getScaleForCellSize(levels[i].cellSize);
+        levels[i].maxScale = i + 1 == levels.size() ? 0.0 : getScaleForCellSize(levels[i+1].cellSize);
+    }
+}
+
+
+const std::vector<PointPyramid::Level>& PointPyramid::getLevels(void) const
+{
+    return levels;
+}
+
+
+GroupLayer* PointPyramid::createLayer(const QString& name, const LevelTableBuilder& tableBuilder, QObject* parent) const
+{
+    auto groupLayer = new GroupLayer(QList<Layer*>{}, parent);
+    groupLayer->setName(name);
+
+    for(auto&& level : levels)
+    {
+        auto levelTable = tableBuilder(level);
+
+        if(levelTable == nullptr)
+            continue;
+
+        auto levelCollection = new FeatureCollection(parent);
+        levelCollection->tables()->append(levelTable);
+
+        auto levelLayer = new FeatureCollectionLayer(levelCollection, parent);
+        levelLayer->setName(name);
+        levelLayer->setAutoFetchLegendInfos(true);
+        levelLayer->setMinScale(level.minScale);
+        levelLayer->setMaxScale(level.maxScale);
+
+        groupLayer->layers()->append(levelLayer);
+    }
+
+    return groupLayer;
+}
@@ -0,0 +1,101 @@
+#ifndef POINTPYRAMID_H
+#define POINTPYRAMID_H
+/* *****************************************************************************
+Copyright (c) 2016-2021, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+// Written by: Stevan Gavrilovic
+
+// A level-of-detail pyramid for dense point layers, e.g., ground motion and wind field grids. Each level divides the extent of the points
+// into square cells, half the size of those of the level above, and keeps the point nearest to the center of each cell to represent it.
+// Every level is drawn as its own layer in a group layer and is only shown in the range of scales where its cells are a few pixels across,
+// so that the map draws about the same number of points at any zoom. The last level has all of the points, so that each of them can be
+// shown and identified when zoomed in. The points themselves are not changed, so the full resolution data is still there for queries
+
+#include <QString>
+
+#include <functional>
+#include <vector>
+
+class QObject;
+
+namespace Esri
+{
+namespace ArcGISRuntime
+{
+class FeatureCollectionTable;
+class GroupLayer;
+}
+}
+
+class PointPyramid
+{
+public:
+    PointPyramid();
+
+    struct Level
+    {
+        // The size of the cells in degrees, or 0 for the full resolution level of points that are all in one place
+        double cellSize = 0.0;
+
+        // The range of scales in which the level is shown, as in Esri::ArcGISRuntime::Layer, 0 means no limit
+        double minScale = 0.0;
+        double maxScale = 0.0;
+
+        // The indexes of the points in the level in increasing order
+        std::vector<int> points;
+    };
+
+    // Builds the levels from the longitude and latitude of each point one after the other. No level that thins out the points has more than
+    // maxPointsPerLevel points, the default is below the number of points at which the GIS library has crashed in the past. A full resolution
+    // level is added after them, shown only at the scales where its points are apart, unless keepAllPoints is false and there are more than
+    // maxPointsPerLevel points, which is enough where a thinned out view of the points is all that is needed
+    void build(const std::vector<double>& coordinates, const int maxPointsPerLevel = 40000, const bool keepAllPoints = true);
+
+    // The levels from the coarsest to the finest
+    const std::vector<Level>& getLevels(void) const;
+
+    // Creates the table of features for the points of a level
+    using LevelTableBuilder = std::function<Esri::ArcGISRuntime::FeatureCollectionTable*(const Level& level)>;
+
+    // Creates a group layer with a layer for each level, shown only in the range of scales of that level. The tables are created from the
+    // coarsest level to the finest
+    Esri::ArcGISRuntime::GroupLayer* createLayer(const QString& name, const LevelTableBuilder& tableBuilder, QObject* parent) const;
+
+private:
+    std::vector<Level> levels;
+};
+
+#endif // POINTPYRAMID_H
@@ -0,0 +1,187 @@
+/* *****************************************************************************
+Copyright (c) 2016-2021, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+// Written by: Stevan Gavrilovic
+
+#include "RTree.h"
+
+#include <QtGlobal>
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+
+double getCenterX(const RTree::Box& box)
+{
+    return 0.5*(box.xMin + box.xMax);
+}
+
+double getCenterY(const RTree::Box& box)
+{
+    return 0.5*(box.yMin + box.yMax);
+}
+
+}
+
+
+void RTree::Box::expand(const Box& other)
+{
+    xMin = qMin(xMin, other.xMin);
+    yMin = qMin(yMin, other.yMin);
+    xMax = qMax(xMax, other.xMax);
+    yMax = qMax(yMax, other.yMax);
+}
+
+
+RTree::RTree()
+{
+
+}
+
+
+void RTree::build(const std::vector<Box>& boxes)
+{
+    levels.clear();
+
+    std::vector<Entry> entries;
+    entries.reserve(boxes.size());
+
+    for(size_t i = 0; i<boxes.size(); ++i)
+    {
+        if(boxes[i].isValid())
+            entries.push_back({boxes[i], int(i), 0});
+    }
+
+    if(entries.empty())
+        return;
+
+    // Pack each level into the nodes of the level above until there is only the root
+    while(true)
+    {
+        sortTileRecursive(entries);
+
+        levels.push_back(std::move(entries));
+
+        const auto& level = levels.back();
+
+        if(level.size() == 1)
+            break;
+
+        entries.clear();
+        entries.reserve((level.size() + nodeCapacity - 1)/nodeCapacity);
+
+        for(int first = 0; first < int(level.size()); first += nodeCapacity)
+        {
+            const int count = qMin(nodeCapacity, int(level.size()) - first);
+
+            Entry node = {level[first].box, first, count};
+
+            for(int i = first + 1; i < first + count; ++i)
+                node.box.expand(level[i].box);
+
+            entries.push_back(node);
+        }
+    }
+}
+
+
+void RTree::clear(void)
+{
+    levels.clear();
+}
+
+
+bool RTree::isEmpty(void) const
+{
+    return levels.empty();
+}
+
+
+void RTree::search(const Box& box, const std::function<void(int item, const Box& itemBox)>& visitor) const
+{
+    if(levels.empty())
+        return;
+
+    // The entries to visit as their level and index
+    std::vector<std::pair<int, int>> stack;
+    stack.emplace_back(int(levels.size()) - 1, 0);
+
+    while(!stack.empty())
+    {
+        auto level = stack.back().first;
+        auto index = stack.back().second;
+        stack.pop_back();
+
+        const auto& entry = levels[level][index];
+
+        if(!entry.box.intersects(box))
+            continue;
+
+        if(level == 0)
+        {
+            visitor(entry.first, entry.box);
+            continue;
+        }
+
+        for(int i = entry.first; i < entry.first + entry.count; ++i)
+            stack.emplace_back(level - 1, i);
+    }
+}
+
+
+void RTree::sortTileRecursive(std::vector<Entry>& entries)
+{
+    const size_t numNodes = (entries.size() + nodeCapacity - 1)/nodeCapacity;
+    const size_t numSlices = size_t(std::ceil(std::sqrt(double(numNodes))));
+    const size_t sliceSize = numSlices*nodeCapacity;
+
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b)
+    {
+        return getCenterX(a.box) < getCenterX(b.box);
+    });
+
+    for(size_t first = 0; first < entries.size(); first += sliceSize)
+    {
+        auto last = qMin(first + sliceSize, entries.size());
+
+        std::sort(entries.begin() + first, entries.begin() + last, [](const Entry& a, const Entry& b)
+        {
+            return getCenterY(a.box) < getCenterY(b.box);
+        });
+    }
+}
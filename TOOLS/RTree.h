@@ -0,0 +1,101 @@
+#ifndef RTREE_H
+#define RTREE_H
+/* *****************************************************************************
+Copyright (c) 2016-2021, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+// Written by: Stevan Gavrilovic
+
+// An R-tree of bounding boxes that is bulk loaded with the sort-tile-recursive method, i.e., the boxes are sorted into vertical slices by the
+// x of their centers and each slice is sorted by the y of their centers, so that each node of the tree covers a compact patch. The tree is
+// built once from all of the boxes and does not support adding or removing boxes afterwards, rebuild it when the boxes change
+
+#include <functional>
+#include <vector>
+
+class RTree
+{
+public:
+    RTree();
+
+    struct Box
+    {
+        double xMin;
+        double yMin;
+        double xMax;
+        double yMax;
+
+        // A box with any NaN values is invalid, e.g., a component without a geometry
+        bool isValid(void) const { return xMin <= xMax && yMin <= yMax; }
+
+        bool intersects(const Box& other) const { return xMin <= other.xMax && other.xMin <= xMax && yMin <= other.yMax && other.yMin <= yMax; }
+
+        bool contains(const Box& other) const { return xMin <= other.xMin && other.xMax <= xMax && yMin <= other.yMin && other.yMax <= yMax; }
+
+        void expand(const Box& other);
+    };
+
+    // Builds the tree, the item of each box is its index in the vector. The invalid boxes are left out
+    void build(const std::vector<Box>& boxes);
+
+    void clear(void);
+
+    bool isEmpty(void) const;
+
+    // Calls the visitor with the item and the box of each box that intersects the given box, in no particular order
+    void search(const Box& box, const std::function<void(int item, const Box& itemBox)>& visitor) const;
+
+private:
+
+    // The number of entries in each node
+    static const int nodeCapacity = 16;
+
+    // An entry of a level of the tree, the entries of the first level are the boxes themselves and first is the item. In the other levels the
+    // entry is a node that covers the entries from first to first + count - 1 of the level below
+    struct Entry
+    {
+        Box box;
+        int first;
+        int count;
+    };
+
+    // Sorts the entries into the order in which they are packed into nodes
+    static void sortTileRecursive(std::vector<Entry>& entries);
+
+    // The levels from the leaves to the root, the last level has one entry
+    std::vector<std::vector<Entry>> levels;
+};
+
+#endif // RTREE_H
@@ -37,6 +37,8 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 // Written by: Stevan Gavrilovic
 
 #include "XMLAdaptor.h"
+#include "DecompressionDevice.h"
+#include "PointPyramid.h"
 #include "VisualizationWidget.h"
 
 // GIS headers
@@ -65,25 +67,25 @@ XMLAdaptor::XMLAdaptor()
 }
 
 
-FeatureCollectionLayer* XMLAdaptor::parseXMLFile(const QString& filePath, QString& errMessage, QObject* parent)
+GroupLayer* XMLAdaptor::parseXMLFile(const QString& filePath, QString& errMessage, QObject* parent)
 {
     // QDomDocument used to import XML data
     QDomDocument xmlGMs;
 
-    // Load xml file
-    QFile file(filePath);
-    if (!file.open(QIODevice::ReadOnly ))
+    // Load xml file, a compressed file is decompressed on a background thread while it is being parsed
+    auto file = DecompressionDevice::openFile(filePath, errMessage);
+    if (file == nullptr)
     {
         // Error while loading file
-        errMessage = "Error while loading file";
+        errMessage = "Error while loading file\n" + errMessage;
         return nullptr;
     }
 
     // Set raw XML content into the QDomDocument
-    xmlGMs.setContent(&file);
+    xmlGMs.setContent(file.get());
 
     // Close the file now that we are done with it
-    file.close();
+    file->close();
 
     // Extract the root element
     QDomElement root=xmlGMs.documentElement();
@@ -161,30 +163,18 @@ FeatureCollectionLayer* XMLAdaptor::parseXMLFile(const QString& filePath, QStrin
         return nullptr;
     }
 
-    MultipointBuilder* multiPointBuilder = new MultipointBuilder(SpatialReference::wgs84(), parent);
-
-    PointCollection* pc = new PointCollection(SpatialReference::wgs84(), parent);
-
-    // Over 50000 points causes arc gis library to crash... even though, too many points makes the visualization too cluttered
-    int decim = gridPoints.size()/40000;
-
-    if(decim == 0)
-        decim = 1;
+    // The coordinates of all of the grid points, the layer shows them at a level of detail that depends on the zoom
+    std::vector<double> gridPointsCoordinates;
+    gridPointsCoordinates.reserve(2*gridPoints.size());
 
     // Iterate through the grid points to get the data at each point
-
-    auto count = 0;
     for(auto&& gp : gridPoints)
     {
-        ++count;
-
         auto pointData = gp.split(" ");
 
         if(pointData.size() != numFields)
         {
             errMessage = "Error the number of columns in a point does not equal the number of fields";
-            delete multiPointBuilder;
-            delete pc;
             return nullptr;
         }
 
@@ -204,8 +194,6 @@ FeatureCollectionLayer* XMLAdaptor::parseXMLFile(const QString& filePath, QStrin
         if(!OK)
         {
             errMessage = "Error converting longitude to double";
-            delete multiPointBuilder;
-            delete pc;
             return nullptr;
         }
 
@@ -214,16 +202,12 @@ FeatureCollectionLayer* XMLAdaptor::parseXMLFile(const QString& filePath, QStrin
         if(!OK)
         {
             errMessage = "Error converting latitude to double";
-            delete multiPointBuilder;
-            delete pc;
             return nullptr;
         }
 
         if(longitude == 0.0 || latitude == 0.0)
         {
             errMessage = "Error, zero lat lon values";
-            delete multiPointBuilder;
-            delete pc;
             return nullptr;
         }
 
@@ -233,133 +217,81 @@ FeatureCollectionLayer* XMLAdaptor::parseXMLFile(const QString& filePath, QStrin
 
         stationList.push_back(station);
 
-
-        if(count%decim != 0)
-            continue;
-
-        auto res = pc->addPoint(longitude,latitude);
-
-        if(res == -1)
-        {
-            errMessage = "Error, adding point to the point collection";
-            delete multiPointBuilder;
-            delete pc;
-            return nullptr;
-        }
+        gridPointsCoordinates.push_back(longitude);
+        gridPointsCoordinates.push_back(latitude);
     }
 
-
-//    pc->addPoint(-122.2609607382,37.8717450069);
-//    pc->addPoint(-122.3609607382,37.9717450069);
-//    pc->addPoint(-122.1609607382,37.7717450069);
-
-
-    multiPointBuilder->setPoints(pc);
-
-    Multipoint mPoint(multiPointBuilder->toGeometry());
-
-    if(!mPoint.isValid() || mPoint.isEmpty())
-    {
-        errMessage = "Error creating the multipoint geometry in XMLAdaptor";
-        delete multiPointBuilder;
-        delete pc;
-        return nullptr;
-    }
-
-
-    auto gridFeatureCollection = new FeatureCollection(parent);
-
-    // Create red cross SimpleMarkerSymbol
-    SimpleMarkerSymbol* crossSymbol = new SimpleMarkerSymbol(SimpleMarkerSymbolStyle::Cross, QColor("black"), 7, parent);
-
-    // Create renderer and set symbol to crossSymbol
-    SimpleRenderer* renderer = new SimpleRenderer(crossSymbol, parent);
-    renderer->setLabel("ShakeMap Grid Point");
-
+    // Too many points in one layer has crashed the GIS library, and makes the visualization too cluttered, so the points are shown from a
+    // pyramid with a limited number of points in each level. The grid is only there to show the extent of the points, so no level has them all
+    PointPyramid gridPyramid;
+    gridPyramid.build(gridPointsCoordinates, 40000, false);
 
     QList<Field> tableFields;
     tableFields.append(Field::createText("AssetType", "NULL",4));
     tableFields.append(Field::createText("TabName", "NULL",4));
 
-    // Option 1 start
-    // Create the feature collection table/layers
-//    auto gridFeatureCollectionTable = new FeatureCollectionTable(tableFields, GeometryType::Point, SpatialReference::wgs84(), parent);
-//    gridFeatureCollection->tables()->append(gridFeatureCollectionTable);
-
-//    // Set the renderer for the feature layer
-//    gridFeatureCollectionTable->setRenderer(renderer);
-
-//    for(int i =0; i<pc->size(); ++i)
-//    {
-
-//        // Create the point and add it to the feature table
-//        // create the feature attributes
-//        QMap<QString, QVariant> featureAttributes;
-//        featureAttributes.insert("AssetType", "SHAKEMAP_GRID");
-//        featureAttributes.insert("TabName", "ShakeMapGrid");
-
-//        auto pnt =pc->point(i);
-
-//        Feature* feature = gridFeatureCollectionTable->createFeature(featureAttributes, pnt, parent);
-
-//        gridFeatureCollectionTable->addFeature(feature);
-//    }
-    // Option 1 end
-
-
-
-    // Option 2 start
-
-    // Create the feature collection table/layers
-    auto gridFeatureCollectionTable = new FeatureCollectionTable(tableFields, GeometryType::Multipoint, SpatialReference::wgs84(), parent);
-    gridFeatureCollection->tables()->append(gridFeatureCollectionTable);
+    QString levelErr;
 
+    // Each level is a single multipoint feature
+    auto gridLayer = gridPyramid.createLayer("Grid", [&](const PointPyramid::Level& level) -> FeatureCollectionTable*
+    {
+        MultipointBuilder multiPointBuilder(SpatialReference::wgs84());
 
-    // Set the renderer for the feature layer
-    gridFeatureCollectionTable->setRenderer(renderer);
+        PointCollection* pc = new PointCollection(SpatialReference::wgs84(), parent);
 
-    // Set the scale at which the layer will become visible - if scale is too high, then the entire view will be filled with symbols
+        for(auto&& index : level.points)
+        {
+            auto res = pc->addPoint(gridPointsCoordinates[2*index],gridPointsCoordinates[2*index+1]);
+
+            if(res == -1)
+            {
+                levelErr = "Error, adding point to the point collection";
+                delete pc;
+                return nullptr;
+            }
+        }
 
-    // Create the point and add it to the feature table
-    // create the feature attributes
-    QMap<QString, QVariant> featureAttributes;
-    featureAttributes.insert("AssetType", "SHAKEMAP_GRID");
-    featureAttributes.insert("TabName", "ShakeMapGrid");
+        multiPointBuilder.setPoints(pc);
 
-    Feature* feature = gridFeatureCollectionTable->createFeature(featureAttributes, mPoint, parent);
+        Multipoint mPoint(multiPointBuilder.toGeometry());
 
-    gridFeatureCollectionTable->addFeature(feature);
+        if(!mPoint.isValid() || mPoint.isEmpty())
+        {
+            levelErr = "Error creating the multipoint geometry in XMLAdaptor";
+            return nullptr;
+        }
 
-    // Option 2 end
+        // Create the feature collection table
+        auto gridFeatureCollectionTable = new FeatureCollectionTable(tableFields, GeometryType::Multipoint, SpatialReference::wgs84(), parent);
 
+        // Create red cross SimpleMarkerSymbol
+        SimpleMarkerSymbol* crossSymbol = new SimpleMarkerSymbol(SimpleMarkerSymbolStyle::Cross, QColor("black"), 7, parent);
 
-    // Option 3 start
-//    QMap<QString, QVariant> featureAttributes;
-//    featureAttributes.insert("AssetType", "SHAKEMAP_GRID");
-//    featureAttributes.insert("TabName", "ShakeMapGrid");
-//    Point point1(-122.2609607382,37.8717450069);
-//    Point point2(-122.3609607382,37.9717450069);
-//    Feature* feature1 = gridFeatureCollectionTable->createFeature(featureAttributes, point1, parent);
-//    gridFeatureCollectionTable->addFeature(feature1);
-//    Feature* feature2 = gridFeatureCollectionTable->createFeature(featureAttributes, point2, parent);
-//    gridFeatureCollectionTable->addFeature(feature2);
-    // Option 3 end
+        // Create renderer and set symbol to crossSymbol
+        SimpleRenderer* renderer = new SimpleRenderer(crossSymbol, parent);
+        renderer->setLabel("ShakeMap Grid Point");
 
+        // Set the renderer for the feature layer
+        gridFeatureCollectionTable->setRenderer(renderer);
 
-    auto gridLayer = new FeatureCollectionLayer(gridFeatureCollection, parent);
+        // create the feature attributes
+        QMap<QString, QVariant> featureAttributes;
+        featureAttributes.insert("AssetType", "SHAKEMAP_GRID");
+        featureAttributes.insert("TabName", "ShakeMapGrid");
 
-    gridLayer->setMinScale(1000000);
+        Feature* feature = gridFeatureCollectionTable->createFeature(featureAttributes, mPoint, parent);
 
-//    // Test start
-//    auto vizWidget = dynamic_cast<VisualizationWidget*>(parent);
+        gridFeatureCollectionTable->addFeature(feature);
 
-//    auto m_originalMultipointGraphic = new Graphic(mPoint, crossSymbol, parent);
-//    m_originalMultipointGraphic->setZIndex(0);
+        return gridFeatureCollectionTable;
+    }, parent);
 
-//    auto m_graphicsOverlay = new GraphicsOverlay(parent);
-//    vizWidget->getMapViewWidget()->graphicsOverlays()->append(m_graphicsOverlay);
-//    m_graphicsOverlay->graphics()->append(m_originalMultipointGraphic);
-    // Test end
+    if(!levelErr.isEmpty())
+    {
+        errMessage = levelErr;
+        delete gridLayer;
+        return nullptr;
+    }
 
     return gridLayer;
 }
@@ -38,7 +38,7 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 
 // Written by: Stevan Gavrilovic
 
-// This class imports a XML ShakeMap grid into a ArcGIS feature collection layer
+// This class imports a XML ShakeMap grid into a ArcGIS layer
 
 #include "GroundMotionStation.h"
 
@@ -50,7 +50,7 @@ namespace Esri
 {
 namespace ArcGISRuntime
 {
-class FeatureCollectionLayer;
+class GroupLayer;
 }
 }
 
@@ -59,7 +59,8 @@ class XMLAdaptor
 public:
     XMLAdaptor();
 
-    Esri::ArcGISRuntime::FeatureCollectionLayer* parseXMLFile(const QString& filePath, QString& errMessage, QObject* parent = nullptr);
+    // Returns a group layer that shows the grid points at a level of detail that depends on the zoom, see PointPyramid
+    Esri::ArcGISRuntime::GroupLayer* parseXMLFile(const QString& filePath, QString& errMessage, QObject* parent = nullptr);
 
     QString getEventName() const;
 
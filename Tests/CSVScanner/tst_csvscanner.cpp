@@ -0,0 +1,325 @@
+/* *****************************************************************************
+Copyright (c) 2016-2021, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+// Written by: Stevan Gavrilovic
+
+// Checks that the scalar, SSE2 and AVX2 paths of the CSV scanner find the same commas and newlines as a loop over the characters, and
+// benchmarks them against the loop that split the rows of a CSV file before the scanner. Run only the benchmarks with, e.g.,
+// ./tst_csvscanner scanBenchmark
+
+#include "CSVScanner.h"
+
+#include <QRandomGenerator>
+#include <QStringList>
+#include <QtTest>
+
+#include <vector>
+
+namespace
+{
+
+// The commas and newlines outside of quotes, found one character at a time
+std::vector<qint64> findStructuralCharacters(const QByteArray& data, const int begin, bool& inQuotes)
+{
+    std::vector<qint64> positions;
+
+    for(int i = begin; i<data.size(); ++i)
+    {
+        const char c = data.at(i);
+
+        if(c == '"')
+            inQuotes = !inQuotes;
+        else if(!inQuotes && (c == ',' || c == '\n'))
+            positions.push_back(i);
+    }
+
+    return positions;
+}
+
+
+std::vector<qint64> scan(const QByteArray& data, const int begin, bool& inQuotes)
+{
+    std::vector<qint64> positions;
+
+    CSVScanner scanner(data.constData(), begin, data.size(), inQuotes);
+
+    for(auto pos = scanner.next(); pos != -1; pos = scanner.next())
+        positions.push_back(pos);
+
+    inQuotes = scanner.isInQuotes();
+
+    return positions;
+}
+
+
+// The loop over each character that split a row of a CSV file into its cells before the scanner
+QStringList parseLineCSV(const QString& csvString)
+{
+    QStringList fields;
+    QString value;
+
+    bool hasQuote = false;
+
+    for(int i = 0; i < csvString.size(); ++i)
+    {
+        const QChar current = csvString.at(i);
+
+        if(hasQuote == false)
+        {
+            if(current == ',')
+            {
+                fields.append(value.trimmed());
+                value.clear();
+            }
+            else if(current == '"')
+            {
+                hasQuote = true;
+                value += current;
+            }
+            else
+                value += current;
+        }
+        else
+        {
+            if(current == '"')
+            {
+                // A double double-quote
+                if(i+1 < csvString.size() && csvString.at(i+1) == '"')
+                {
+                    value += '"';
+                    i++;
+                }
+                else
+                {
+                    hasQuote = false;
+                    value += '"';
+                }
+            }
+            else
+                value += current;
+        }
+    }
+
+    if(!value.isEmpty())
+        fields.append(value.trimmed());
+
+    // Remove the quotes around the cells
+    for(int i = 0; i<fields.size(); ++i)
+    {
+        if(fields[i].startsWith('"'))
+        {
+            fields[i] = fields[i].mid(1);
+
+            if(fields[i].endsWith('"'))
+                fields[i].chop(1);
+        }
+    }
+
+    return fields;
+}
+
+
+// A building inventory with a quoted footprint in each row, or Pelicun results with the four header rows and numbers in the cells
+QByteArray makeCSVFile(const QString& type, const int numRows)
+{
+    QRandomGenerator random(1);
+
+    QByteArray data;
+
+    if(type == "Inventory")
+    {
+        data += "ID,Latitude,Longitude,OccupancyClass,StructureType,YearBuilt,NumberOfStories,PlanArea,ReplacementCost,Footprint\n";
+
+        for(int i = 1; i<=numRows; ++i)
+        {
+            const auto lat = QByteArray::number(37.8 + 0.1*random.generateDouble(), 'f', 6);
+            const auto lon = QByteArray::number(-122.3 - 0.1*random.generateDouble(), 'f', 6);
+
+            data += QByteArray::number(i) + "," + lat + "," + lon + ",RES1,W1," + QByteArray::number(1900 + random.bounded(120)) + ","
+                    + QByteArray::number(1 + random.bounded(4)) + "," + QByteArray::number(500.0 + 3000.0*random.generateDouble(), 'f', 2) + ","
+                    + QByteArray::number(1.0e5 + 1.0e6*random.generateDouble(), 'f', 2) + ",\"[[[" + lon + "," + lat + "],[" + lon + "," + lat
+                    + "],[" + lon + "," + lat + "],[" + lon + "," + lat + "]]]\"\n";
+        }
+    }
+    else
+    {
+        data += "#Num,Repair Cost,Repair Cost,Repair Time,Repair Time,Injuries,Injuries,Collapse Probability\n";
+        data += ",,,,,,,\n";
+        data += ",mean,std,mean,std,mean,std,\n";
+        data += ",,,,,,,\n";
+
+        for(int i = 1; i<=numRows; ++i)
+        {
+            data += QByteArray::number(i);
+
+            for(int j = 0; j<7; ++j)
+                data += "," + QByteArray::number(1.0e4*random.generateDouble(), 'g', 8);
+
+            data += "\n";
+        }
+    }
+
+    return data;
+}
+
+}
+
+
+class CSVScannerTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+
+    void compareInstructionSets_data(void);
+    void compareInstructionSets(void);
+
+    void scanBenchmark_data(void);
+    void scanBenchmark(void);
+};
+
+
+void CSVScannerTest::compareInstructionSets_data(void)
+{
+    QTest::addColumn<int>("instructionSet");
+
+    QTest::newRow("Scalar") << int(CSVScanner::Scalar);
+    QTest::newRow("SSE2") << int(CSVScanner::SSE2);
+    QTest::newRow("AVX2") << int(CSVScanner::AVX2);
+}
+
+
+void CSVScannerTest::compareInstructionSets(void)
+{
+    QFETCH(int, instructionSet);
+
+    if(!CSVScanner::setInstructionSet(CSVScanner::InstructionSet(instructionSet)))
+        QSKIP("This processor does not support the instruction set");
+
+    // Mostly quotes, commas and newlines, so that they fall on and across the edges of the blocks of 64 bytes
+    const QByteArray characters = ",\"\n,a\" 1";
+
+    QRandomGenerator random(42);
+
+    for(int size = 0; size<300; ++size)
+    {
+        QByteArray data(size, ' ');
+
+        for(int i = 0; i<size; ++i)
+            data[i] = characters.at(random.bounded(characters.size()));
+
+        for(int begin = 0; begin<=qMin(size, 70); ++begin)
+        {
+            for(auto startInQuotes : {false, true})
+            {
+                auto expectedInQuotes = startInQuotes;
+                const auto expected = findStructuralCharacters(data, begin, expectedInQuotes);
+
+                auto inQuotes = startInQuotes;
+                const auto positions = scan(data, begin, inQuotes);
+
+                const auto msg = QString("Size %1, begin %2, starting in quotes %3").arg(size).arg(begin).arg(startInQuotes);
+
+                QVERIFY2(positions == expected, qPrintable(msg));
+                QVERIFY2(inQuotes == expectedInQuotes, qPrintable(msg));
+            }
+        }
+    }
+}
+
+
+void CSVScannerTest::scanBenchmark_data(void)
+{
+    QTest::addColumn<QString>("fileType");
+    QTest::addColumn<int>("instructionSet");
+
+    // An instruction set of -1 splits the rows with the loop over each character instead of the scanner
+    for(auto&& fileType : {QString("Inventory"), QString("Results")})
+    {
+        QTest::newRow(qPrintable(fileType + " Scalar")) << fileType << int(CSVScanner::Scalar);
+        QTest::newRow(qPrintable(fileType + " SSE2")) << fileType << int(CSVScanner::SSE2);
+        QTest::newRow(qPrintable(fileType + " AVX2")) << fileType << int(CSVScanner::AVX2);
+        QTest::newRow(qPrintable(fileType + " parseLineCSV")) << fileType << -1;
+    }
+}
+
+
+void CSVScannerTest::scanBenchmark(void)
+{
+    QFETCH(QString, fileType);
+    QFETCH(int, instructionSet);
+
+    const auto data = makeCSVFile(fileType, 100000);
+
+    qint64 numCells = 0;
+
+    if(instructionSet == -1)
+    {
+        const auto lines = QString::fromUtf8(data).split('\n', Qt::SkipEmptyParts);
+
+        QBENCHMARK
+        {
+            numCells = 0;
+
+            for(auto&& it : lines)
+                numCells += parseLineCSV(it).size();
+        }
+
+        QVERIFY(numCells > lines.size());
+
+        return;
+    }
+
+    if(!CSVScanner::setInstructionSet(CSVScanner::InstructionSet(instructionSet)))
+        QSKIP("This processor does not support the instruction set");
+
+    QBENCHMARK
+    {
+        numCells = 0;
+
+        CSVScanner scanner(data.constData(), 0, data.size());
+
+        while(scanner.next() != -1)
+            ++numCells;
+    }
+
+    auto inQuotes = false;
+    QCOMPARE(numCells, qint64(findStructuralCharacters(data, 0, inQuotes).size()));
+}
+
+QTEST_APPLESS_MAIN(CSVScannerTest)
+
+#include "tst_csvscanner.moc"
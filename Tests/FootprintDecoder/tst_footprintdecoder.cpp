@@ -0,0 +1,415 @@
+/* *****************************************************************************
+Copyright (c) 2016-2021, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+// Written by: Stevan Gavrilovic
+
+// Checks that the footprint decoder gives the same rings for a coordinate array and for well-known binary in hex in either byte order,
+// and benchmarks it against the regular expression that split the footprints into points before the decoder. Run only the benchmarks
+// with, e.g., ./tst_footprintdecoder decodeBenchmark
+
+#include "FootprintDecoder.h"
+#include "GeoJsonReader.h"
+
+#include <QRandomGenerator>
+#include <QRegularExpression>
+#include <QtEndian>
+#include <QtMath>
+#include <QtTest>
+
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+
+// The rings of a polygon, each with the x and y of its points one after the other
+typedef QVector<QVector<double>> Rings;
+
+
+void appendUInt32(const quint32 val, const bool littleEndian, QByteArray& wkb)
+{
+    char bytes[4];
+
+    if(littleEndian)
+        qToLittleEndian(val, bytes);
+    else
+        qToBigEndian(val, bytes);
+
+    wkb.append(bytes, 4);
+}
+
+
+void appendDouble(const double val, const bool littleEndian, QByteArray& wkb)
+{
+    quint64 bits;
+    std::memcpy(&bits, &val, sizeof(bits));
+
+    char bytes[8];
+
+    if(littleEndian)
+        qToLittleEndian(bits, bytes);
+    else
+        qToBigEndian(bits, bytes);
+
+    wkb.append(bytes, 8);
+}
+
+
+void appendWKBPolygon(const Rings& rings, const bool littleEndian, QByteArray& wkb)
+{
+    wkb.append(char(littleEndian ? 1 : 0));
+
+    appendUInt32(3, littleEndian, wkb);
+    appendUInt32(rings.size(), littleEndian, wkb);
+
+    for(auto&& ring : rings)
+    {
+        appendUInt32(ring.size()/2, littleEndian, wkb);
+
+        for(auto&& val : ring)
+            appendDouble(val, littleEndian, wkb);
+    }
+}
+
+
+// A polygon, or a multipolygon if there is more than one polygon, as well-known binary in hex
+QString makeHexWKB(const QVector<Rings>& polygons, const bool littleEndian)
+{
+    QByteArray wkb;
+
+    if(polygons.size() == 1)
+    {
+        appendWKBPolygon(polygons.first(), littleEndian, wkb);
+    }
+    else
+    {
+        wkb.append(char(littleEndian ? 1 : 0));
+
+        appendUInt32(6, littleEndian, wkb);
+        appendUInt32(polygons.size(), littleEndian, wkb);
+
+        for(auto&& it : polygons)
+            appendWKBPolygon(it, littleEndian, wkb);
+    }
+
+    return QString::fromLatin1(wkb.toHex());
+}
+
+
+// The same polygon, or multipolygon, as a geojson coordinate array
+QString makeCoordinateArray(const QVector<Rings>& polygons)
+{
+    QStringList polygonStrings;
+
+    for(auto&& rings : polygons)
+    {
+        QStringList ringStrings;
+
+        for(auto&& ring : rings)
+        {
+            QStringList points;
+
+            for(int i = 0; i<ring.size(); i += 2)
+                points.append("[" + QString::number(ring[i], 'f', 6) + "," + QString::number(ring[i+1], 'f', 6) + "]");
+
+            ringStrings.append("[" + points.join(",") + "]");
+        }
+
+        polygonStrings.append("[" + ringStrings.join(",") + "]");
+    }
+
+    return polygons.size() == 1 ? polygonStrings.first() : "[" + polygonStrings.join(",") + "]";
+}
+
+
+// A ring around the point, with coordinates of six decimals so that the text and the binary hold the same values
+QVector<double> makeRing(const double x, const double y, const double size, const int numPoints)
+{
+    QVector<double> ring;
+
+    for(int i = 0; i<numPoints; ++i)
+    {
+        const auto angle = qDegreesToRadians(360.0*i/numPoints);
+
+        ring.append(std::round((x + size*std::cos(angle))*1.0e6)/1.0e6);
+        ring.append(std::round((y + size*std::sin(angle))*1.0e6)/1.0e6);
+    }
+
+    // Close the ring
+    ring.append(ring[0]);
+    ring.append(ring[1]);
+
+    return ring;
+}
+
+
+// The points of a footprint found with the regular expression that was used before the decoder
+int parseWithRegularExpression(const QString& footprint, std::vector<double>& coordinates)
+{
+    static const QRegularExpression rx("[^\\[\\]]+(?=\\])");
+
+    coordinates.clear();
+
+    auto it = rx.globalMatch(footprint);
+
+    while(it.hasNext())
+    {
+        auto match = it.next();
+
+        auto points = match.captured(0).split(",");
+
+        if(points.size() != 2)
+            return -1;
+
+        bool OK = false;
+        auto x = points.at(0).toDouble(&OK);
+
+        if(!OK)
+            return -1;
+
+        auto y = points.at(1).toDouble(&OK);
+
+        if(!OK)
+            return -1;
+
+        coordinates.push_back(x);
+        coordinates.push_back(y);
+    }
+
+    return coordinates.empty() ? -1 : 0;
+}
+
+}
+
+
+class FootprintDecoderTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+
+    void decodeCoordinateArray(void);
+
+    void compareWKB_data(void);
+    void compareWKB(void);
+
+    void decodeErrors_data(void);
+    void decodeErrors(void);
+
+    void decodeBenchmark_data(void);
+    void decodeBenchmark(void);
+};
+
+
+void FootprintDecoderTest::decodeCoordinateArray(void)
+{
+    FootprintDecoder decoder;
+    GeoJsonFeature polygon;
+    QString err;
+
+    // A polygon with a hole, in quotes as it is in a CSV file
+    QCOMPARE(decoder.decode(" \"[[[0,0],[1,0],[1,1],[0,0]], [[0.25,0.25],[0.5,0.25],[0.5,0.5],[0.25,0.25]]]\" ", polygon, err), 0);
+    QCOMPARE(polygon.geometryType, QString("Polygon"));
+    QCOMPARE(polygon.coordinateDepth, 3);
+    QCOMPARE(polygon.partStarts, std::vector<int>({0, 4, 8}));
+    QCOMPARE(polygon.coordinates, std::vector<double>({0,0, 1,0, 1,1, 0,0, 0.25,0.25, 0.5,0.25, 0.5,0.5, 0.25,0.25}));
+
+    // A bare ring is a polygon with one ring
+    QCOMPARE(decoder.decode("[[-122.5,37.5],[-122.25,37.5],[-122.25,37.75],[-122.5,37.5]]", polygon, err), 0);
+    QCOMPARE(polygon.geometryType, QString("Polygon"));
+    QCOMPARE(polygon.coordinateDepth, 2);
+    QCOMPARE(polygon.partStarts, std::vector<int>({0, 4}));
+    QCOMPARE(polygon.coordinates, std::vector<double>({-122.5,37.5, -122.25,37.5, -122.25,37.75, -122.5,37.5}));
+
+    // The rings of the polygons of a multipolygon are listed one after the other
+    QCOMPARE(decoder.decode("[[[[0,0],[1,0],[1,1],[0,0]]],[[[2,2],[3,2],[3,3],[2,2]]]]", polygon, err), 0);
+    QCOMPARE(polygon.geometryType, QString("MultiPolygon"));
+    QCOMPARE(polygon.coordinateDepth, 4);
+    QCOMPARE(polygon.partStarts, std::vector<int>({0, 4, 8}));
+    QCOMPARE(polygon.coordinates, std::vector<double>({0,0, 1,0, 1,1, 0,0, 2,2, 3,2, 3,3, 2,2}));
+}
+
+
+void FootprintDecoderTest::compareWKB_data(void)
+{
+    QTest::addColumn<QVector<Rings>>("polygons");
+
+    const auto outer = makeRing(-122.3, 37.8, 0.001, 6);
+    const auto hole = makeRing(-122.3, 37.8, 0.0005, 4);
+
+    QTest::newRow("Polygon") << QVector<Rings>{Rings{outer}};
+    QTest::newRow("Polygon with a hole") << QVector<Rings>{Rings{outer, hole}};
+    QTest::newRow("MultiPolygon") << QVector<Rings>{Rings{outer, hole}, Rings{makeRing(-122.2, 37.9, 0.002, 12)}};
+}
+
+
+void FootprintDecoderTest::compareWKB(void)
+{
+    QFETCH(QVector<Rings>, polygons);
+
+    FootprintDecoder decoder;
+    GeoJsonFeature expected;
+    QString err;
+
+    QVERIFY2(decoder.decode(makeCoordinateArray(polygons), expected, err) == 0, qPrintable(err));
+
+    for(auto littleEndian : {true, false})
+    {
+        // The case of the hex digits does not matter
+        for(auto upperCase : {false, true})
+        {
+            auto hex = makeHexWKB(polygons, littleEndian);
+
+            if(upperCase)
+                hex = hex.toUpper();
+
+            GeoJsonFeature polygon;
+
+            QVERIFY2(decoder.decode(hex, polygon, err) == 0, qPrintable(err));
+
+            QCOMPARE(polygon.geometryType, expected.geometryType);
+            QCOMPARE(polygon.coordinateDepth, expected.coordinateDepth);
+            QCOMPARE(polygon.partStarts, expected.partStarts);
+            QCOMPARE(polygon.coordinates, expected.coordinates);
+        }
+    }
+}
+
+
+void FootprintDecoderTest::decodeErrors_data(void)
+{
+    QTest::addColumn<QString>("footprint");
+
+    const auto hex = makeHexWKB(QVector<Rings>{Rings{makeRing(-122.3, 37.8, 0.001, 6)}}, true);
+
+    QTest::newRow("Empty") << QString("\"\"");
+    QTest::newRow("Unclosed array") << QString("[[[0,0],[1,0],[1,1]");
+    QTest::newRow("Not a number") << QString("[[[0,0],[1,a],[1,1],[0,0]]]");
+    QTest::newRow("Extra characters") << QString("[[[0,0],[1,0],[1,1],[0,0]]] x");
+    QTest::newRow("Not hex") << QString("0103000000zz");
+    QTest::newRow("Odd number of hex digits") << hex.left(hex.size() - 1);
+    QTest::newRow("Truncated binary") << hex.left(hex.size() - 16);
+    QTest::newRow("Extra bytes") << hex + "00";
+    QTest::newRow("Point") << QString("0101000000") + QString::fromLatin1(QByteArray(16, '\0').toHex());
+}
+
+
+void FootprintDecoderTest::decodeErrors(void)
+{
+    QFETCH(QString, footprint);
+
+    FootprintDecoder decoder;
+    GeoJsonFeature polygon;
+    QString err;
+
+    QVERIFY(decoder.decode(footprint, polygon, err) != 0);
+    QVERIFY(!err.isEmpty());
+}
+
+
+void FootprintDecoderTest::decodeBenchmark_data(void)
+{
+    QTest::addColumn<QString>("format");
+    QTest::addColumn<bool>("useDecoder");
+
+    QTest::newRow("Coordinate array, regular expression") << QString("Coordinate array") << false;
+    QTest::newRow("Coordinate array, decoder") << QString("Coordinate array") << true;
+    QTest::newRow("Hex WKB, decoder") << QString("Hex WKB") << true;
+}
+
+
+void FootprintDecoderTest::decodeBenchmark(void)
+{
+    QFETCH(QString, format);
+    QFETCH(bool, useDecoder);
+
+    // Buildings with footprints of 5 to 12 points
+    QRandomGenerator random(1);
+
+    QStringList footprints;
+
+    for(int i = 0; i<20000; ++i)
+    {
+        const auto ring = makeRing(-122.3 - 0.1*random.generateDouble(), 37.8 + 0.1*random.generateDouble(), 0.0002, 4 + random.bounded(8));
+
+        if(format == "Hex WKB")
+            footprints.append(makeHexWKB(QVector<Rings>{Rings{ring}}, true));
+        else
+            footprints.append(makeCoordinateArray(QVector<Rings>{Rings{ring}}));
+    }
+
+    qint64 numPoints = 0;
+
+    if(useDecoder)
+    {
+        FootprintDecoder decoder;
+        GeoJsonFeature polygon;
+        QString err;
+
+        QBENCHMARK
+        {
+            numPoints = 0;
+
+            for(auto&& it : footprints)
+            {
+                QVERIFY2(decoder.decode(it, polygon, err) == 0, qPrintable(err));
+                numPoints += polygon.coordinates.size()/2;
+            }
+        }
+    }
+    else
+    {
+        std::vector<double> coordinates;
+
+        QBENCHMARK
+        {
+            numPoints = 0;
+
+            for(auto&& it : footprints)
+            {
+                QVERIFY(parseWithRegularExpression(it, coordinates) == 0);
+                numPoints += coordinates.size()/2;
+            }
+        }
+    }
+
+    QVERIFY(numPoints >= 5*footprints.size());
+}
+
+
+QTEST_APPLESS_MAIN(FootprintDecoderTest)
+
+#include "tst_footprintdecoder.moc"
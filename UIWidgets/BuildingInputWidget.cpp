@@ -10,7 +10,9 @@
 #include "SimpleFillSymbol.h"
 #include "SimpleLineSymbol.h"
 
-#include <QTableWidget>
+#include "ComponentLoader.h"
+#include "FootprintDecoder.h"
+#include "GeoJsonReader.h"
 
 using namespace Esri::ArcGISRuntime;
 
@@ -22,37 +24,36 @@ BuildingInputWidget::BuildingInputWidget(QWidget *parent, QString componentType,
 
 int BuildingInputWidget::loadComponentVisualization()
 {
-
-    QList<Field> fields;
-    fields.append(Field::createDouble("LossRatio", "0.0"));
-    fields.append(Field::createText("ID", "NULL",4));
-    fields.append(Field::createText("AssetType", "NULL",4));
-    fields.append(Field::createText("TabName", "NULL",4));
-    fields.append(Field::createText("UID", "NULL",4));
+    buildingFields.clear();
+    buildingFields.append(Field::createDouble("LossRatio", "0.0"));
+    buildingFields.append(Field::createText("ID", "NULL",4));
+    buildingFields.append(Field::createText("AssetType", "NULL",4));
+    buildingFields.append(Field::createText("TabName", "NULL",4));
+    buildingFields.append(Field::createText("UID", "NULL",4));
 
     // Select a column that will define the building layers
-    int columnToMapLayers = 0;
+    columnToMapLayers = 0;
 
     QString columnFilter = "OccupancyClass";
 
+    auto headers = this->getTableHorizontalHeadings();
+
     // Set the table headers as fields in the table
-    for(int i = 1; i<componentTableWidget->columnCount(); ++i)
+    for(int i = 1; i<headers.size(); ++i)
     {
-        auto headerItem = componentTableWidget->horizontalHeaderItem(i);
-
-        auto fieldText = headerItem->text();
+        auto fieldText = headers.at(i);
 
         if(fieldText.compare(columnFilter) == 0)
             columnToMapLayers = i;
 
-        fields.append(Field::createText(fieldText, fieldText,fieldText.size()));
+        buildingFields.append(Field::createText(fieldText, fieldText,fieldText.size()));
     }
 
     // Create the buildings group layer that will hold the sublayers
-    auto buildingLayer = new GroupLayer(QList<Layer*>{},this);
+    buildingLayer = new GroupLayer(QList<Layer*>{},this);
     buildingLayer->setName("Buildings");
 
-    auto buildingsItem = theVisualizationWidget->addLayerToMap(buildingLayer);
+    buildingsItem = theVisualizationWidget->addLayerToMap(buildingLayer);
 
     if(buildingsItem == nullptr)
     {
@@ -60,52 +61,25 @@ int BuildingInputWidget::loadComponentVisualization()
         return -1;
     }
 
-    auto nRows = componentTableWidget->rowCount();
-
-    std::vector<std::string> vecLayerItems;
-    for(int i = 0; i<nRows; ++i)
-    {
-        // Organize the layers according to occupancy type
-        auto occupancyType = componentTableWidget->item(i,columnToMapLayers)->data(0).toString().toStdString();
-
-        vecLayerItems.push_back(occupancyType);
-    }
-
-    this->uniqueVec<std::string>(vecLayerItems);
-
     auto selectedBuildingsFeatureCollection = new FeatureCollection(this);
-    selectedBuildingsTable = new FeatureCollectionTable(fields, GeometryType::Polygon, SpatialReference::wgs84(),this);
+    selectedBuildingsTable = new FeatureCollectionTable(buildingFields, GeometryType::Polygon, SpatialReference::wgs84(),this);
     selectedBuildingsFeatureCollection->tables()->append(selectedBuildingsTable);
     selectedBuildingsLayer = new FeatureCollectionLayer(selectedBuildingsFeatureCollection,this);
     selectedBuildingsLayer->setName("Selected Buildings");
     selectedBuildingsLayer->setAutoFetchLegendInfos(true);
     selectedBuildingsTable->setRenderer(this->createSelectedBuildingRenderer(1.5));
 
-    // Map to hold the feature tables
-    std::map<std::string, FeatureCollectionTable*> tablesMap;
-    for(auto&& it : vecLayerItems)
-    {
-        auto featureCollection = new FeatureCollection(this);
-
-        auto featureCollectionTable = new FeatureCollectionTable(fields, GeometryType::Polygon, SpatialReference::wgs84(),this);
-
-        featureCollection->tables()->append(featureCollectionTable);
-
-        auto newBuildingLayer = new FeatureCollectionLayer(featureCollection,this);
-
-        newBuildingLayer->setName(QString::fromStdString(it));
-
-        newBuildingLayer->setAutoFetchLegendInfos(true);
-
-        featureCollectionTable->setRenderer(this->createBuildingRenderer());
+    // The sublayers are created as the occupancy types show up in the batches
+    buildingTables.clear();
 
-        tablesMap.insert(std::make_pair(it,featureCollectionTable));
+    buildingLayer->load();
 
-        theVisualizationWidget->addLayerToMap(newBuildingLayer,buildingsItem,buildingLayer);
-    }
+    return 0;
+}
 
-    auto headers = this->getTableHorizontalHeadings();
 
+int BuildingInputWidget::createComponentGeometries(const QStringList& headers, ComponentBatch& batch, QString& err) const
+{
     // First check if a footprint was provided
     auto indexFootprint = headers.indexOf("Footprint");
     auto indexLatitude = headers.indexOf("Latitude");
@@ -113,119 +87,162 @@ int BuildingInputWidget::loadComponentVisualization()
 
     if(indexLongitude == -1 || indexLatitude == -1)
     {
-        this->errorMessage("Could not find latitude and longitude in the header columns");
+        err = "Could not find latitude and longitude in the header columns";
         return -1;
     }
 
-    for(int i = 0; i<nRows; ++i)
-    {
-        // create the feature attributes
-        QMap<QString, QVariant> featureAttributes;
+    batch.geometries.reserve(batch.numRows);
 
-        // Create a new building
-        Component building;
+    // The decoder and the decoded footprint are reused for all of the buildings in the batch
+    FootprintDecoder footprintDecoder;
+    GeoJsonFeature footprintPolygon;
 
-        QString buildingIDStr = componentTableWidget->item(i,0)->data(0).toString();
+    // The geometry functions of the visualization widget only build the geometry from their arguments, so they are safe to call from here
+    for(int i = 0; i<batch.numRows; ++i)
+    {
+        auto latitude = batch.cell(i,indexLatitude).toDouble();
+        auto longitude = batch.cell(i,indexLongitude).toDouble();
 
-        int buildingID = buildingIDStr.toInt();
+        Geometry geom;
 
-        building.ID = buildingID;
+        // If a footprint is given use that
+        if(indexFootprint != -1)
+        {
+            QString footprint = batch.cell(i,indexFootprint).toString();
 
-        QMap<QString, QVariant> buildingAttributeMap;
+            if(footprint.compare("NA") == 0)
+            {
+                Point point(longitude,latitude);
+                geom = theVisualizationWidget->getRectGeometryFromPoint(point, 0.0005,0.0005);
+            }
+            else
+            {
+                if(footprintDecoder.decode(footprint, footprintPolygon, err) != 0)
+                {
+                    err += " for the building " + batch.cell(i,0).toString();
+                    return -1;
+                }
+
+                geom = theVisualizationWidget->getPolygonGeometryFromGeoJson(footprintPolygon);
+            }
+        }
+        else
+        {
+            Point point(longitude,latitude);
+            geom = theVisualizationWidget->getRectGeometryFromPoint(point, 0.00015,0.00015);
+        }
 
-        // The feature attributes are the columns from the table
-        for(int j = 1; j<componentTableWidget->columnCount(); ++j)
+        if(geom.isEmpty())
         {
-            auto attrbText = componentTableWidget->horizontalHeaderItem(j)->text();
-            auto attrbVal = componentTableWidget->item(i,j)->data(0);
+            err = "Error getting the footprint geometry of the building " + batch.cell(i,0).toString();
+            return -1;
+        }
 
-            buildingAttributeMap.insert(attrbText,attrbVal);
+        batch.geometries.push_back(geom);
+    }
 
-            featureAttributes.insert(attrbText,attrbVal);
-        }
+    return 0;
+}
+
+
+QString BuildingInputWidget::getGeometryCacheKey(void) const
+{
+    // Change the key if the geometries are built differently, so that the geometries cached by older versions are not used
+    return "BuildingFootprints-1";
+}
+
+
+int BuildingInputWidget::addComponentBatchToVisualization(const ComponentBatch& batch)
+{
+    auto headers = this->getTableHorizontalHeadings();
+
+    auto nCols = headers.size();
+
+    // The features are added to each table in one call
+    QHash<FeatureCollectionTable*, QList<Feature*>> newFeatures;
+
+    for(int i = 0; i<batch.numRows; ++i)
+    {
+        // create the feature attributes
+        QMap<QString, QVariant> featureAttributes;
+
+        QString buildingIDStr = batch.cell(i,0).toString();
+
+        // The feature attributes are the columns from the file, the building attributes are already in the database
+        for(int j = 1; j<nCols; ++j)
+            featureAttributes.insert(headers.at(j),batch.cell(i,j).toString());
 
         // Create a unique ID for the building
         auto uid = theVisualizationWidget->createUniqueID();
 
-        building.ComponentAttributes = buildingAttributeMap;
-
         featureAttributes.insert("ID", buildingIDStr);
         featureAttributes.insert("LossRatio", 0.0);
         featureAttributes.insert("AssetType", "BUILDINGS");
         featureAttributes.insert("TabName", buildingIDStr);
         featureAttributes.insert("UID", uid);
 
-        auto latitude = componentTableWidget->item(i,indexLatitude)->data(0).toDouble();
-        auto longitude = componentTableWidget->item(i,indexLongitude)->data(0).toDouble();
-
         // Get the feature collection table for this layer
-        auto layerTag = componentTableWidget->item(i,columnToMapLayers)->data(0).toString().toStdString();
+        auto featureCollectionTable = this->getBuildingTable(batch.cell(i,columnToMapLayers).toString());
 
-        auto featureCollectionTable = tablesMap.at(layerTag);
+        if(featureCollectionTable == nullptr)
+            return -1;
 
-        Feature* feature = nullptr;
+        Feature* feature = featureCollectionTable->createFeature(featureAttributes, batch.geometries.at(i), this);
 
-        // If a footprint is given use that
-        if(indexFootprint != -1)
-        {
-            QString footprint = componentTableWidget->item(i,indexFootprint)->data(0).toString();
+        newFeatures[featureCollectionTable].append(feature);
 
-            if(footprint.compare("NA") == 0)
-            {
-                Point point(longitude,latitude);
-                auto geom = theVisualizationWidget->getRectGeometryFromPoint(point, 0.0005,0.0005);
-                if(geom.isEmpty())
-                {
-                    qDebug()<<"Error getting the building footprint geometry";
-                    return -1;
-                }
+        // Attach the feature to the building in the database
+        auto row = batch.firstRow + i;
+        theComponentDb.setUID(row, uid);
+        theComponentDb.setFeature(row, feature);
+    }
 
-                feature = featureCollectionTable->createFeature(featureAttributes, geom, this);
+    for(auto it = newFeatures.begin(); it != newFeatures.end(); ++it)
+        it.key()->addFeatures(it.value());
 
-                featureCollectionTable->addFeature(feature);
-            }
-            else
-            {
-                auto geom = theVisualizationWidget->getPolygonGeometryFromJson(footprint);
+    return 0;
+}
 
-                if(geom.isEmpty())
-                {
-                    qDebug()<<"Error getting the building footprint geometry";
-                    return -1;
-                }
 
-                feature = featureCollectionTable->createFeature(featureAttributes, geom, this);
+void BuildingInputWidget::finishComponentVisualization(void)
+{
+    if(buildingLayer == nullptr)
+        return;
 
-                featureCollectionTable->addFeature(feature);
-            }
+    theVisualizationWidget->zoomToLayer(buildingLayer->layerId());
+}
 
-        }
-        else
-        {
-            Point point(longitude,latitude);
-            auto geom = theVisualizationWidget->getRectGeometryFromPoint(point, 0.00015,0.00015);
-            if(geom.isEmpty())
-            {
-                qDebug()<<"Error getting the building footprint geometry";
-                return -1;
-            }
 
-            feature = featureCollectionTable->createFeature(featureAttributes, geom, this);
+FeatureCollectionTable* BuildingInputWidget::getBuildingTable(const QString& layerTag)
+{
+    auto it = buildingTables.constFind(layerTag);
 
-            featureCollectionTable->addFeature(feature);
-        }
+    if(it != buildingTables.constEnd())
+        return it.value();
 
-        building.UID = uid;
-        building.ComponentFeature = feature;
+    auto featureCollection = new FeatureCollection(this);
 
-        theComponentDb.addComponent(buildingID, building);
-    }
+    auto featureCollectionTable = new FeatureCollectionTable(buildingFields, GeometryType::Polygon, SpatialReference::wgs84(),this);
 
-    buildingLayer->load();
+    featureCollection->tables()->append(featureCollectionTable);
 
-    theVisualizationWidget->zoomToLayer(buildingLayer->layerId());
+    auto newBuildingLayer = new FeatureCollectionLayer(featureCollection,this);
 
-    return 0;
+    newBuildingLayer->setName(layerTag);
+
+    newBuildingLayer->setAutoFetchLegendInfos(true);
+
+    featureCollectionTable->setRenderer(this->createBuildingRenderer());
+
+    if(theVisualizationWidget->addLayerToMap(newBuildingLayer,buildingsItem,buildingLayer) == nullptr)
+    {
+        qDebug()<<"Error adding item to the map";
+        return nullptr;
+    }
+
+    buildingTables.insert(layerTag, featureCollectionTable);
+
+    return featureCollectionTable;
 }
 
 
@@ -246,6 +263,29 @@ int BuildingInputWidget::removeFeatureFromSelectedLayer(Esri::ArcGISRuntime::Fea
 }
 
 
+QList<Feature*> BuildingInputWidget::addFeaturesToSelectedLayer(const QList<QMap<QString, QVariant>>& featuresAttributes, const QList<Geometry>& geoms)
+{
+    QList<Feature*> features;
+    features.reserve(featuresAttributes.size());
+
+    for(int i = 0; i<featuresAttributes.size(); ++i)
+        features.append(selectedBuildingsTable->createFeature(featuresAttributes.at(i),geoms.at(i),this));
+
+    // Add all of the features to the table at once
+    selectedBuildingsTable->addFeatures(features);
+
+    return features;
+}
+
+
+int BuildingInputWidget::removeFeaturesFromSelectedLayer(const QList<Esri::ArcGISRuntime::Feature*>& feats)
+{
+    selectedBuildingsTable->deleteFeatures(feats);
+
+    return 0;
+}
+
+
 SimpleRenderer* BuildingInputWidget::createBuildingRenderer(void)
 {
     SimpleFillSymbol* fillSymbol = new SimpleFillSymbol(SimpleFillSymbolStyle::Solid, QColor(0, 0, 255, 125), this);
@@ -264,6 +304,12 @@ Esri::ArcGISRuntime::FeatureCollectionLayer* BuildingInputWidget::getSelectedFea
 }
 
 
+Esri::ArcGISRuntime::Layer* BuildingInputWidget::getComponentLayer(void)
+{
+    return buildingLayer;
+}
+
+
 void BuildingInputWidget::clear()
 {
     delete selectedBuildingsLayer;
@@ -272,6 +318,10 @@ void BuildingInputWidget::clear()
     selectedBuildingsLayer = nullptr;
     selectedBuildingsTable = nullptr;
 
+    buildingLayer = nullptr;
+    buildingsItem = nullptr;
+    buildingTables.clear();
+
     ComponentInputWidget::clear();
 }
 
@@ -3,6 +3,8 @@
 
 #include "ComponentInputWidget.h"
 
+#include "Field.h"
+
 namespace Esri
 {
 namespace ArcGISRuntime
@@ -10,30 +12,56 @@ namespace ArcGISRuntime
 class ClassBreaksRenderer;
 class SimpleRenderer;
 class Feature;
+class FeatureCollectionTable;
 class Geometry;
+class GroupLayer;
 }
 }
 
+class LayerTreeItem;
+
 class BuildingInputWidget : public ComponentInputWidget
 {
 public:
     BuildingInputWidget(QWidget *parent, QString componentType, QString appType = QString());
 
     int loadComponentVisualization();
+    int addComponentBatchToVisualization(const ComponentBatch& batch);
+    void finishComponentVisualization(void);
 
     Esri::ArcGISRuntime::Feature* addFeatureToSelectedLayer(QMap<QString, QVariant>& featureAttributes, Esri::ArcGISRuntime::Geometry& geom);
     int removeFeatureFromSelectedLayer(Esri::ArcGISRuntime::Feature* feat);
+    QList<Esri::ArcGISRuntime::Feature*> addFeaturesToSelectedLayer(const QList<QMap<QString, QVariant>>& featuresAttributes, const QList<Esri::ArcGISRuntime::Geometry>& geoms);
+    int removeFeaturesFromSelectedLayer(const QList<Esri::ArcGISRuntime::Feature*>& feats);
     Esri::ArcGISRuntime::FeatureCollectionLayer* getSelectedFeatureLayer(void);
+    Esri::ArcGISRuntime::Layer* getComponentLayer(void);
 
     void clear();
 
+protected:
+
+    int createComponentGeometries(const QStringList& headers, ComponentBatch& batch, QString& err) const;
+    QString getGeometryCacheKey(void) const;
+
 private:
 
+    // Returns the table of the building layer with the given tag, the layer is created the first time that the tag is seen
+    Esri::ArcGISRuntime::FeatureCollectionTable* getBuildingTable(const QString& layerTag);
+
     Esri::ArcGISRuntime::SimpleRenderer* createBuildingRenderer(void);
     Esri::ArcGISRuntime::ClassBreaksRenderer* createSelectedBuildingRenderer(double outlineWidth = 0.0);
 
     Esri::ArcGISRuntime::FeatureCollectionLayer* selectedBuildingsLayer = nullptr;
     Esri::ArcGISRuntime::FeatureCollectionTable* selectedBuildingsTable = nullptr;
+
+    QList<Esri::ArcGISRuntime::Field> buildingFields;
+
+    // The column that the building layers are organized by
+    int columnToMapLayers = 0;
+
+    Esri::ArcGISRuntime::GroupLayer* buildingLayer = nullptr;
+    LayerTreeItem* buildingsItem = nullptr;
+    QHash<QString, Esri::ArcGISRuntime::FeatureCollectionTable*> buildingTables;
 };
 
 #endif // BUILDINGINPUTWIDGET_H
@@ -38,22 +38,28 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 
 #include "AssetInputDelegate.h"
 #include "ComponentInputWidget.h"
+#include "ComponentQuery.h"
+#include "ComponentSelectionFilter.h"
+#include "ComponentTableModel.h"
 #include "VisualizationWidget.h"
 #include "CSVReaderWriter.h"
+#include "ComponentLoader.h"
 
 #include <QCoreApplication>
 #include <QApplication>
 #include <QFileDialog>
 #include <QLineEdit>
-#include <QTableWidget>
+#include <QTableView>
 #include <QLabel>
 #include <QGroupBox>
 #include <QGridLayout>
 #include <QPushButton>
+#include <QProgressBar>
 #include <QHeaderView>
 #include <QFileInfo>
 #include <QJsonObject>
 
+#include "Envelope.h"
 #include "FeatureCollectionLayer.h"
 
 // Std library headers
@@ -79,7 +85,7 @@ ComponentInputWidget::ComponentInputWidget(QWidget *parent, QString componentTyp
 
 ComponentInputWidget::~ComponentInputWidget()
 {
-
+    this->stopLoading();
 }
 
 
@@ -112,111 +118,217 @@ void ComponentInputWidget::loadComponentData(void)
         }
     }
 
-    CSVReaderWriter csvTool;
+    // Stop any load that is still running, its batches would be mixed in with these ones
+    this->stopLoading();
 
-    QString err;
-    QVector<QStringList> data = csvTool.parseCSVFile(pathToComponentInfoFile,err);
+    componentSelectionFilter->clearSelection();
+    componentTableModel->clear();
+    theComponentDb.clear();
+    tableHorizontalHeadings.clear();
 
-    if(!err.isEmpty())
+    // The file is parsed and the batches are built on a worker thread, the batches come back to this thread in order through queued signals
+    auto loader = new ComponentLoader(pathToComponentInfoFile);
+
+    loader->setGeometryBuilder([this](const QStringList& headings, ComponentBatch& batch, QString& err)
     {
-        this->errorMessage(err);
-        return;
-    }
+        return this->createComponentGeometries(headings, batch, err);
+    }, this->getGeometryCacheKey());
+
+    auto thread = new QThread();
+    loader->moveToThread(thread);
+
+    connect(thread, &QThread::started, loader, &ComponentLoader::load);
+
+    // Quit directly from the worker thread so that the destructor can wait on the thread without needing the event loop
+    connect(loader, &ComponentLoader::loadingFinished, thread, &QThread::quit, Qt::DirectConnection);
+    connect(thread, &QThread::finished, loader, &QObject::deleteLater);
+    connect(thread, &QThread::finished, thread, &QObject::deleteLater);
+
+    connect(loader, &ComponentLoader::headingsLoaded, this, &ComponentInputWidget::handleHeadingsLoaded);
+    connect(loader, &ComponentLoader::batchLoaded, this, &ComponentInputWidget::handleBatchLoaded);
+    connect(loader, &ComponentLoader::loadingFinished, this, &ComponentInputWidget::handleLoadingFinished);
+
+    componentLoader = loader;
+    loaderThread = thread;
+
+    // The number of rows is not known until the file is parsed
+    loadProgressBar->setRange(0,0);
+    loadProgressBar->show();
+    cancelLoadButton->show();
+
+    this->statusMessage("Loading the file " + pathToComponentInfoFile);
+
+    thread->start();
+}
+
+
+void ComponentInputWidget::handleHeadingsLoaded(QStringList headings, int numRows)
+{
+    tableHorizontalHeadings = headings;
+
+    // The first column is the ID, the other columns are attributes, which are added in the order of the file
+    for(int j = 1; j<headings.size(); ++j)
+        theComponentDb.addAttribute(headings.at(j));
+
+    // The table shows the components straight from the database, the rows are added as the batches come in
+    componentTableModel->setHeadings(headings);
+
+    componentInfoText->show();
+    componentTableView->show();
+
+    loadProgressBar->setRange(0,numRows);
+    loadProgressBar->setValue(0);
+
+    this->statusMessage("Loading " + QString::number(numRows)+ " assets");
 
-    if(data.empty())
+    if(this->loadComponentVisualization() != 0)
     {
-        this->errorMessage("Input file is empty");
-        return;
+        this->errorMessage("Error visualizing the " + componentType.toLower() + ", stopping the loading");
+        this->stopLoading();
     }
+}
 
-    // Get the header file
-    QStringList tableHeadings = data.first();
 
-    tableHorizontalHeadings = tableHeadings;
+void ComponentInputWidget::handleBatchLoaded(ComponentBatch batch)
+{
+    // The attribute columns were put together by the loader, so they are only appended here
+    QString err;
+    auto firstRow = batch.components ? theComponentDb.appendComponents(*batch.components, err) : -1;
 
-    // Pop off the row that contains the header information
-    data.pop_front();
+    if(firstRow != batch.firstRow)
+    {
+        if(err.isEmpty())
+            err = "The batches of the " + componentType.toLower() + " are out of order";
 
-    auto numRows = data.size();
-    auto numCols = tableHeadings.size();
+        this->errorMessage("Error loading the " + componentType.toLower() + ": " + err);
+        this->stopLoading();
+        this->discardLoadedComponents();
 
-    if(numRows == 0)
-    {
-        this->errorMessage("Input file is empty");
         return;
     }
-    else{
-        this->statusMessage("Loading " + QString::number(numRows)+ " assets");
-        QApplication::processEvents();
+
+    // The bounding boxes of the geometries go into the spatial index that the selection tools use
+    if(batch.geometries.size() == batch.numRows)
+    {
+        for(int i = 0; i<batch.numRows; ++i)
+        {
+            auto extent = batch.geometries.at(i).extent();
+
+            if(!extent.isEmpty())
+                theComponentDb.setBounds(firstRow + i, {extent.xMin(), extent.yMin(), extent.xMax(), extent.yMax()});
+        }
     }
 
-    auto firstRow = data.first();
+    componentTableModel->updateRowCount();
 
-    if(firstRow.empty())
+    if(this->addComponentBatchToVisualization(batch) != 0)
     {
-        this->errorMessage("First row is empty");
+        this->errorMessage("Error visualizing the " + componentType.toLower() + ", stopping the loading");
+        this->stopLoading();
+        this->discardLoadedComponents();
+
         return;
     }
 
-    auto initialID = firstRow.first().toInt();
+    // Let the loader send another batch
+    if(componentLoader)
+    {
+        loadProgressBar->setValue(theComponentDb.getNumberOfComponents());
+        componentLoader->releaseBatch();
+    }
+}
 
-    componentTableWidget->clear();
-    componentTableWidget->setRowCount(numRows);
-    componentTableWidget->setColumnCount(numCols);
-    componentTableWidget->setHorizontalHeaderLabels(tableHeadings);
 
-    // Fill in the cells
-    for(int i = 0; i<numRows; ++i)
-    {
+void ComponentInputWidget::handleLoadingFinished(bool cancelled, QString err)
+{
+    componentLoader = nullptr;
+    loaderThread = nullptr;
 
-        // Display a status message every n assets
-        if((i+1)%1000 == 0)
-        {
-            this->statusMessage("Loading asset number: " + QString::number(i+1));
-            QApplication::processEvents();
-        }
+    loadProgressBar->hide();
+    cancelLoadButton->hide();
 
-        auto rowStringList = data[i];
+    if(!err.isEmpty())
+    {
+        this->errorMessage(err);
 
-        if(rowStringList.size() != numCols)
+        // Only a cancelled load keeps the components that were loaded, otherwise the inventory would be silently cut short
+        if(!cancelled)
         {
-            this->statusMessage("Error, the number of items in row " + QString::number(i+1) + " does not equal number of headings in the file");
+            this->discardLoadedComponents();
             return;
         }
+    }
 
-        auto currID = rowStringList.first().toInt();
+    auto numLoaded = theComponentDb.getNumberOfComponents();
 
-        if(initialID+i != currID)
-        {
-            this->statusMessage("Error, the asset IDs must be sequential");
-            return;
-        }
+    if(numLoaded == 0)
+        return;
 
-        for(int j = 0; j<numCols; ++j)
-        {
-            auto cellData = rowStringList[j];
+    this->finishComponentVisualization();
 
-            auto item = new QTableWidgetItem(cellData);
+    emit componentDataLoaded();
 
-            // Make the first three columns (ID, lat, lon) uneditable
-            if(j < 3)
-                item->setFlags(item->flags() ^ (Qt::ItemIsEditable | Qt::ItemIsEnabled));
+    if(cancelled)
+        this->statusMessage("Loading cancelled, " + QString::number(numLoaded) + " assets were loaded");
+    else
+        this->statusMessage("Done loading assets");
 
-            componentTableWidget->setItem(i,j, item);
-        }
+    if(!pendingFilter.isEmpty())
+    {
+        auto filter = pendingFilter;
+        pendingFilter.clear();
+
+        this->setFilterString(filter);
     }
+}
 
-    componentInfoText->show();
-    componentTableWidget->show();
 
-    emit componentDataLoaded();
+void ComponentInputWidget::cancelLoading(void)
+{
+    if(componentLoader)
+        componentLoader->cancel();
+}
 
-    this->loadComponentVisualization();
 
-    this->statusMessage("Done loading assets");
-    QApplication::processEvents();
+void ComponentInputWidget::stopLoading(void)
+{
+    pendingFilter.clear();
 
-    return;
+    if(!componentLoader)
+        return;
+
+    // Drop the batches that are already queued, the loader stops once it sees that it is cancelled
+    disconnect(componentLoader, nullptr, this, nullptr);
+    componentLoader->cancel();
+
+    // The loader calls back into this widget to build the geometries, so wait for it to stop. It checks if it is cancelled between batches
+    if(loaderThread)
+        loaderThread->wait();
+
+    componentLoader = nullptr;
+    loaderThread = nullptr;
+
+    loadProgressBar->hide();
+    cancelLoadButton->hide();
+}
+
+
+void ComponentInputWidget::discardLoadedComponents(void)
+{
+    pendingFilter.clear();
+
+    auto componentLayer = this->getComponentLayer();
+
+    if(componentLayer != nullptr)
+        theVisualizationWidget->removeLayerFromMapAndTree(componentLayer->layerId());
+
+    componentSelectionFilter->clearSelection();
+    componentTableModel->clear();
+    componentTableView->hide();
+    componentInfoText->hide();
+    theComponentDb.clear();
+
+    this->statusMessage("The " + componentType.toLower() + " were not loaded");
 }
 
 
@@ -248,9 +360,36 @@ int ComponentInputWidget::loadComponentVisualization()
 }
 
 
-QTableWidget *ComponentInputWidget::getTableWidget() const
+// Implement in subclass
+int ComponentInputWidget::addComponentBatchToVisualization(const ComponentBatch& /*batch*/)
 {
-    return componentTableWidget;
+    return 0;
+}
+
+
+// Implement in subclass
+void ComponentInputWidget::finishComponentVisualization(void)
+{
+
+}
+
+
+// Implement in subclass
+int ComponentInputWidget::createComponentGeometries(const QStringList& /*headings*/, ComponentBatch& /*batch*/, QString& /*err*/) const
+{
+    return 0;
+}
+
+
+QString ComponentInputWidget::getGeometryCacheKey(void) const
+{
+    return QString();
+}
+
+
+QTableView *ComponentInputWidget::getTableView() const
+{
+    return componentTableView;
 }
 
 
@@ -311,22 +450,57 @@ void ComponentInputWidget::createComponentsBox(void)
 
     connect(clearSelectionButton,SIGNAL(clicked()),this,SLOT(clearComponentSelection()));
 
+    // Selection of the components by a query on their attributes
+    queryLineEdit = new QLineEdit();
+    queryLineEdit->setMaximumWidth(1000);
+    queryLineEdit->setMinimumWidth(400);
+    queryLineEdit->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Minimum);
+    queryLineEdit->setPlaceholderText("e.g., YearBuilt < 1970 and NumberOfStories >= 4 and OccupancyClass = 'RES1'");
+    queryLineEdit->setToolTip("Select the components by a query on their attributes. Comparisons (<, <=, >, >=, =, !=) and lists, e.g., OccupancyClass in ('RES1', 'RES3'), are joined with and, or and not");
+
+    connect(queryLineEdit,&QLineEdit::returnPressed,this,&ComponentInputWidget::selectComponentsByQuery);
+
+    QPushButton *runQueryButton = new QPushButton();
+    runQueryButton->setText(tr("Run Query"));
+    runQueryButton->setMaximumWidth(150);
+
+    connect(runQueryButton,&QPushButton::clicked,this,&ComponentInputWidget::selectComponentsByQuery);
+
+    // Progress of the loading, only shown while the components are loading
+    loadProgressBar = new QProgressBar();
+    loadProgressBar->hide();
+
+    cancelLoadButton = new QPushButton();
+    cancelLoadButton->setText(tr("Cancel"));
+    cancelLoadButton->setMaximumWidth(150);
+    cancelLoadButton->hide();
+
+    connect(cancelLoadButton,&QPushButton::clicked,this,&ComponentInputWidget::cancelLoading);
+
     // Text label for Component information
     componentInfoText = new QLabel(label3);
     componentInfoText->setStyleSheet("font-weight: bold; color: black");
     componentInfoText->hide();
 
     // Create the table that will show the Component information
-    componentTableWidget = new QTableWidget();
-    componentTableWidget->hide();
-    componentTableWidget->setToolTip("Component details");
-    componentTableWidget->verticalHeader()->setVisible(false);
-    componentTableWidget->horizontalHeader()->setSectionResizeMode(QHeaderView::ResizeToContents);
+    componentTableModel = new ComponentTableModel(&theComponentDb, this);
+
+    // The view shows the table through a filter that hides the components that are not selected
+    componentSelectionFilter = new ComponentSelectionFilter(&theComponentDb, this);
+    componentSelectionFilter->setSourceModel(componentTableModel);
 
-    componentTableWidget->setSizeAdjustPolicy(QAbstractScrollArea::SizeAdjustPolicy::AdjustToContents);
-    componentTableWidget->setSizePolicy(QSizePolicy::Maximum,QSizePolicy::Expanding);
+    componentTableView = new QTableView();
+    componentTableView->setModel(componentSelectionFilter);
+    componentTableView->hide();
+    componentTableView->setToolTip("Component details");
+    componentTableView->verticalHeader()->setVisible(false);
+    componentTableView->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+    componentTableView->horizontalHeader()->setSectionResizeMode(QHeaderView::ResizeToContents);
 
-    connect(componentTableWidget, &QTableWidget::cellChanged, this, &ComponentInputWidget::handleCellChanged);
+    componentTableView->setSizeAdjustPolicy(QAbstractScrollArea::SizeAdjustPolicy::AdjustToContents);
+    componentTableView->setSizePolicy(QSizePolicy::Maximum,QSizePolicy::Expanding);
+
+    connect(componentTableModel, &ComponentTableModel::attributeEdited, this, &ComponentInputWidget::handleAttributeEdited);
 
     // Add a vertical spacer at the bottom to push everything up
     gridLayout->addItem(smallVSpacer,0,0,1,5);
@@ -339,10 +513,14 @@ void ComponentInputWidget::createComponentsBox(void)
     gridLayout->addWidget(selectComponentsLineEdit, 4, 0, 1, 2);
     gridLayout->addWidget(selectComponentsButton, 4, 2);
     gridLayout->addWidget(clearSelectionButton, 4, 3);
-    gridLayout->addItem(smallVSpacer,5,0,1,5);
-    gridLayout->addWidget(componentInfoText,6,0,1,5,Qt::AlignCenter);
-    gridLayout->addWidget(componentTableWidget, 7, 0, 1, 5,Qt::AlignCenter);
-    gridLayout->setRowStretch(8, 1);
+    gridLayout->addWidget(queryLineEdit, 5, 0, 1, 2);
+    gridLayout->addWidget(runQueryButton, 5, 2);
+    gridLayout->addItem(smallVSpacer,6,0,1,5);
+    gridLayout->addWidget(loadProgressBar, 6, 0, 1, 3);
+    gridLayout->addWidget(cancelLoadButton, 6, 3);
+    gridLayout->addWidget(componentInfoText,7,0,1,5,Qt::AlignCenter);
+    gridLayout->addWidget(componentTableView, 8, 0, 1, 5,Qt::AlignCenter);
+    gridLayout->setRowStretch(9, 1);
     this->setLayout(gridLayout);
 }
 
@@ -366,102 +544,131 @@ void ComponentInputWidget::selectComponents(void)
 }
 
 
-void ComponentInputWidget::handleComponentSelection(void)
+void ComponentInputWidget::selectComponentsByQuery(void)
 {
+    auto queryText = queryLineEdit->text().trimmed();
 
-    auto nRows = componentTableWidget->rowCount();
+    // Quick return if the query is empty
+    if(queryText.isEmpty())
+        return;
 
-    if(nRows == 0)
+    if(componentLoader != nullptr)
+    {
+        this->errorMessage("Please wait until the " + componentType.toLower() + " have finished loading before running a query");
         return;
+    }
 
-    // Get the ID of the first and last component
-    bool OK;
-    auto firstID = componentTableWidget->item(0,0)->data(0).toInt(&OK);
+    ComponentQuery query;
 
-    if(!OK)
+    QString err;
+    if(query.parse(queryText, err) != 0)
     {
-        QString msg = "Error in getting the component ID in " + QString(__FUNCTION__);
-        this->errorMessage(msg);
+        this->errorMessage(err);
         return;
     }
 
-    auto lastID = componentTableWidget->item(nRows-1,0)->data(0).toInt(&OK);
+    IntervalSet selectedIDs;
+    if(query.select(theComponentDb, selectedIDs, err) != 0)
+    {
+        this->errorMessage(err);
+        return;
+    }
 
-    if(!OK)
+    if(selectedIDs.isEmpty())
     {
-        QString msg = "Error in getting the component ID in " + QString(__FUNCTION__);
-        this->errorMessage(msg);
+        this->statusMessage("No " + componentType.toLower() + " match the query " + queryText);
         return;
     }
 
-    auto selectedComponentIDs = selectComponentsLineEdit->getSelectedComponentIDs();
+    // The query replaces the current selection
+    this->clearLayerSelectedForAnalysis();
+
+    selectComponentsLineEdit->setSelectedComponentIDs(selectedIDs);
+}
+
+
+void ComponentInputWidget::handleComponentSelection(void)
+{
+
+    auto nRows = componentTableModel->rowCount();
+
+    if(nRows == 0)
+        return;
+
+    // Get the ID of the first and last component, the IDs are sequential
+    auto firstID = theComponentDb.getID(0);
+    auto lastID = theComponentDb.getID(nRows-1);
 
-    // First check that all of the selected IDs are within range
-    for(auto&& it : selectedComponentIDs)
+    const auto& selectedComponentIDs = selectComponentsLineEdit->getSelectedComponentIDs();
+
+    // First check that all of the selected IDs are within range, the IDs are sorted so only the ends need to be checked
+    if(!selectedComponentIDs.isEmpty() && (selectedComponentIDs.first()<firstID || selectedComponentIDs.last()>lastID))
     {
-        if(it<firstID || it>lastID)
-        {
-            QString msg = "The component ID " + QString::number(it) + " is out of range of the components provided";
-            this->errorMessage(msg);
-            selectComponentsLineEdit->clear();
-            return;
-        }
-    }
+        auto outOfRangeID = selectedComponentIDs.first()<firstID ? selectedComponentIDs.first() : selectedComponentIDs.last();
 
-    // Hide all rows in the table
-    for(int i = 0; i<nRows; ++i)
-        componentTableWidget->setRowHidden(i,true);
+        QString msg = "The component ID " + QString::number(outOfRangeID) + " is out of range of the components provided";
+        this->errorMessage(msg);
+        selectComponentsLineEdit->clear();
+        return;
+    }
 
-    // Unhide the selected rows
-    for(auto&& it : selectedComponentIDs)
-        componentTableWidget->setRowHidden(it - firstID,false);
+    // Show only the selected rows
+    componentSelectionFilter->setSelection(selectedComponentIDs);
 
     auto numAssets = selectedComponentIDs.size();
     QString msg = "A total of "+ QString::number(numAssets) + " " + componentType.toLower() + " are selected for analysis";
     this->statusMessage(msg);
 
-    for(auto&& it : selectedComponentIDs)
+    // Gather the features that are not yet in the selected layer, and add them to the layer in batches
+    QStringList newIDs;
+    QList<QMap<QString, QVariant>> newAttributes;
+    QList<Geometry> newGeometries;
+
+    auto addSelectedFeatures = [&]()
     {
-        auto component = theComponentDb.getComponent(it);
+        if(newIDs.isEmpty())
+            return;
 
-        auto feature = component.ComponentFeature;
+        auto feats = this->addFeaturesToSelectedLayer(newAttributes,newGeometries);
 
-        if(feature == nullptr)
-            continue;
+        for(int i = 0; i<feats.size(); ++i)
+        {
+            if(feats.at(i))
+                selectedFeaturesForAnalysis.insert(newIDs.at(i),feats.at(i));
+        }
 
-        auto atrb = feature->attributes()->attributesMap();
-        auto id = atrb.value("UID").toString();
+        newIDs.clear();
+        newAttributes.clear();
+        newGeometries.clear();
+    };
 
-        if(selectedFeaturesForAnalysis.contains(id))
-            continue;
-
-        auto atrVals = atrb.values();
-        auto atrKeys = atrb.keys();
+    theComponentDb.forEachSelected(selectedComponentIDs, [&](Component& component)
+    {
+        auto feature = component.getFeature();
 
-        // qDebug()<<"Num atributes: "<<atrb.size();
+        if(feature == nullptr)
+            return true;
 
-        QMap<QString, QVariant> featureAttributes;
-        for(int i = 0; i<atrb.size();++i)
-        {
-            auto key = atrKeys.at(i);
-            auto val = atrVals.at(i);
+        auto featureAttributes = feature->attributes()->attributesMap();
+        auto id = featureAttributes.value("UID").toString();
 
-            // Including the ObjectID causes a crash!!! Do not include it when creating an object
-            if(key == "ObjectID")
-                continue;
+        if(selectedFeaturesForAnalysis.contains(id))
+            return true;
 
-            // qDebug()<< nid<<"-key:"<<key<<"-value:"<<atrVals.at(i).toString();
+        // Including the ObjectID causes a crash!!! Do not include it when creating an object
+        featureAttributes.remove("ObjectID");
 
-            featureAttributes[key] = val;
-        }
+        newIDs.append(id);
+        newAttributes.append(featureAttributes);
+        newGeometries.append(feature->geometry());
 
-        auto geom = feature->geometry();
+        if(newIDs.size() == selectedFeatureBatchSize)
+            addSelectedFeatures();
 
-        auto feat = this->addFeatureToSelectedLayer(featureAttributes,geom);
+        return true;
+    });
 
-        if(feat)
-            selectedFeaturesForAnalysis.insert(id,feat);
-    }
+    addSelectedFeatures();
 
     auto selecFeatLayer = this->getSelectedFeatureLayer();
 
@@ -485,10 +692,7 @@ void ComponentInputWidget::clearLayerSelectedForAnalysis(void)
     if(selectedFeaturesForAnalysis.empty())
         return;
 
-    for(auto&& it : selectedFeaturesForAnalysis)
-    {
-        this->removeFeatureFromSelectedLayer(it);
-    }
+    this->removeFeaturesFromSelectedLayer(selectedFeaturesForAnalysis.values());
 
     selectedFeaturesForAnalysis.clear();
 }
@@ -501,28 +705,11 @@ QStringList ComponentInputWidget::getTableHorizontalHeadings() const
 
 void ComponentInputWidget::clearComponentSelection(void)
 {
-    auto selectedComponentIDs = selectComponentsLineEdit->getSelectedComponentIDs();
-
-    QList<Esri::ArcGISRuntime::Feature*> selectedFeatures;
-    for(auto&& it : selectedComponentIDs)
-    {
-        auto component = theComponentDb.getComponent(it);
-
-        auto feature = component.ComponentFeature;
-
-        selectedFeatures<<feature;
-    }
-
     this->clearLayerSelectedForAnalysis();
 
 
-    auto nRows = componentTableWidget->rowCount();
-
-    // Hide all rows in the table
-    for(int i = 0; i<nRows; ++i)
-    {
-        componentTableWidget->setRowHidden(i,false);
-    }
+    // Show all rows in the table
+    componentSelectionFilter->clearSelection();
 
     selectComponentsLineEdit->clear();
 
@@ -565,6 +752,12 @@ void ComponentInputWidget::insertSelectedComponent(const int ComponentID)
 }
 
 
+void ComponentInputWidget::insertSelectedComponents(const IntervalSet& IDs)
+{
+    selectComponentsLineEdit->insertSelectedComponents(IDs);
+}
+
+
 int ComponentInputWidget::numberComponentsSelected(void)
 {
     return selectComponentsLineEdit->size();
@@ -699,6 +892,14 @@ bool ComponentInputWidget::inputAppDataFromJSON(QJsonObject &jsonObject)
 void ComponentInputWidget::setFilterString(const QString& filter)
 {
     selectComponentsLineEdit->setText(filter);
+
+    // Select the components once they are loaded
+    if(componentLoader)
+    {
+        pendingFilter = filter;
+        return;
+    }
+
     selectComponentsLineEdit->selectComponents();
 }
 
@@ -741,43 +942,36 @@ bool ComponentInputWidget::copyFiles(QString &destName)
 
     auto pathToSaveFile = destName + QDir::separator() + componentFile.fileName();
 
-    auto nRows = componentTableWidget->rowCount();
-    auto nCols = componentTableWidget->columnCount();
-
-    if(nRows == 0)
+    if(componentLoader)
+    {
+        this->errorMessage("The " + componentType.toLower() + " are still loading, wait for them to finish loading and try again");
         return false;
+    }
 
+    auto nRows = componentTableModel->rowCount();
+    auto nCols = componentTableModel->columnCount();
 
-    QVector<QStringList> data(nRows+1);
-
-    QStringList headerInfo;
-
-    for(int i = 0; i<nCols; ++i)
-    {
-        auto headerText = componentTableWidget->horizontalHeaderItem(i)->data(0).toString();
-        headerInfo << headerText;
-    }
+    if(nRows == 0)
+        return false;
 
-    data[0] = headerInfo;
+    QStringList headerInfo = componentTableModel->getHeadings();
 
-    for(int i = 0; i<nRows; ++i)
+    // Write the cells straight from the database rather than copying them into string lists first
+    // The database is only read here, and it is not modified while the file is written since this thread waits for the writer to finish
+    auto cellData = [this](const int row, const int col)
     {
-        QStringList rowData;
-        rowData.reserve(nCols);
+        return componentTableModel->getCellText(row,col);
+    };
 
-        for(int j = 0; j<nCols; ++j)
-        {
-            auto item = componentTableWidget->item(i,j)->data(0).toString();
-
-            rowData<<item;
-        }
-        data[i+1] = rowData;
-    }
+    // The first three columns (ID, lat, lon) are not editable and are always numbers
+    QVector<bool> numericColumns(nCols, false);
+    for(int i = 0; i<qMin(3, nCols); ++i)
+        numericColumns[i] = true;
 
     CSVReaderWriter csvTool;
 
     QString err;
-    csvTool.saveCSVFile(data,pathToSaveFile,err);
+    csvTool.saveCSVFile(headerInfo,nRows,cellData,numericColumns,pathToSaveFile,err);
 
     if(!err.isEmpty())
         return false;
@@ -799,7 +993,7 @@ bool ComponentInputWidget::copyFiles(QString &destName)
 
     //        for(int j = 0; j<nCols; ++j)
     //        {
-    //            auto item = componentTableWidget->item(rowID-1,j)->data(0).toString();
+    //            auto item = componentTableModel->getCellText(rowID-1,j);
 
     //            rowData<<item;
     //        }
@@ -816,12 +1010,14 @@ bool ComponentInputWidget::copyFiles(QString &destName)
 
 void ComponentInputWidget::clear(void)
 {
+    this->stopLoading();
     theComponentDb.clear();
     pathToComponentInfoFile.clear();
     componentFileLineEdit->clear();
     selectComponentsLineEdit->clear();
-    componentTableWidget->clear();
-    componentTableWidget->hide();
+    componentSelectionFilter->clearSelection();
+    componentTableModel->clear();
+    componentTableView->hide();
     tableHorizontalHeadings.clear();
 }
 
@@ -832,50 +1028,63 @@ ComponentDatabase* ComponentInputWidget::getComponentDatabase()
 }
 
 
-void ComponentInputWidget::handleCellChanged(int row, int column)
+void ComponentInputWidget::handleAttributeEdited(int row, const QString& attribute, const QVariant& value)
 {
-    // Cannot change the ID, lat, or long
-    if(column < 3)
+    // The model has already updated the database and the component feature, the feature in the selected layer is updated here
+    auto uid = theComponentDb.getUID(row);
+
+    if(uid.isEmpty())
         return;
 
-    auto item = componentTableWidget->item(row,column);
+    this->updateSelectedComponentAttribute(uid,attribute,value);
+}
 
-    // Only update when the user selects the cell and changes it, inefficient to update programatically
-    if(!item->isSelected())
-        return;
 
-    auto ID = componentTableWidget->item(row,0)->data(0).toInt();
+Feature* ComponentInputWidget::addFeatureToSelectedLayer(QMap<QString, QVariant>& /*featureAttributes*/, Geometry& /*geom*/)
+{
+    return nullptr;
+}
 
-    auto attrib = componentTableWidget->horizontalHeaderItem(column)->data(0).toString();
 
-    auto attribVal = item->data(0);
+int ComponentInputWidget::removeFeatureFromSelectedLayer(Esri::ArcGISRuntime::Feature* /*feat*/)
+{
+    return -1;
+}
 
-    theComponentDb.updateComponentAttribute(ID,attrib,attribVal);
 
-    auto component = theComponentDb.getComponent(ID);
+QList<Feature*> ComponentInputWidget::addFeaturesToSelectedLayer(const QList<QMap<QString, QVariant>>& featuresAttributes, const QList<Geometry>& geoms)
+{
+    QList<Feature*> features;
+    features.reserve(featuresAttributes.size());
 
-    if(!component.isValid())
-        return;
+    for(int i = 0; i<featuresAttributes.size(); ++i)
+    {
+        auto featureAttributes = featuresAttributes.at(i);
+        auto geom = geoms.at(i);
 
-    auto uid = component.UID;
-    this->updateSelectedComponentAttribute(uid,attrib,attribVal);
+        features.append(this->addFeatureToSelectedLayer(featureAttributes,geom));
+    }
 
+    return features;
 }
 
 
-Feature* ComponentInputWidget::addFeatureToSelectedLayer(QMap<QString, QVariant>& /*featureAttributes*/, Geometry& /*geom*/)
+int ComponentInputWidget::removeFeaturesFromSelectedLayer(const QList<Feature*>& feats)
 {
-    return nullptr;
+    for(auto&& it : feats)
+        this->removeFeatureFromSelectedLayer(it);
+
+    return 0;
 }
 
 
-int ComponentInputWidget::removeFeatureFromSelectedLayer(Esri::ArcGISRuntime::Feature* /*feat*/)
+Esri::ArcGISRuntime::FeatureCollectionLayer* ComponentInputWidget::getSelectedFeatureLayer(void)
 {
-    return -1;
+    return nullptr;
 }
 
 
-Esri::ArcGISRuntime::FeatureCollectionLayer* ComponentInputWidget::getSelectedFeatureLayer(void)
+Esri::ArcGISRuntime::Layer* ComponentInputWidget::getComponentLayer(void)
 {
     return nullptr;
 }
@@ -895,14 +1104,16 @@ void ComponentInputWidget::updateSelectedComponentAttribute(const QString&  uid,
         return;
     }
 
-    if(!selectedFeaturesForAnalysis.contains(uid))
+    // Get the feature with a single lookup
+    auto featIt = selectedFeaturesForAnalysis.constFind(uid);
+
+    if(featIt == selectedFeaturesForAnalysis.constEnd())
     {
         qDebug()<<"Feature not found in selected components map";
         return;
     }
 
-    // Get the feature
-    Feature* feat = selectedFeaturesForAnalysis[uid];
+    Feature* feat = featIt.value();
 
     if(feat == nullptr)
     {
@@ -40,14 +40,19 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 
 #include "SimCenterAppWidget.h"
 #include "ComponentDatabase.h"
+#include "ComponentLoader.h"
 #include "VisualizationWidget.h"
 
 #include <set>
 
 #include <QString>
 #include <QObject>
+#include <QPointer>
+#include <QThread>
 
 class AssetInputDelegate;
+class ComponentSelectionFilter;
+class ComponentTableModel;
 
 namespace Esri
 {
@@ -57,13 +62,16 @@ class ClassBreaksRenderer;
 class SimpleRenderer;
 class Feature;
 class Geometry;
+class Layer;
 }
 }
 
 class QGroupBox;
 class QLineEdit;
-class QTableWidget;
+class QTableView;
 class QLabel;
+class QProgressBar;
+class QPushButton;
 
 class ComponentInputWidget : public  SimCenterAppWidget
 {
@@ -73,22 +81,37 @@ public:
     explicit ComponentInputWidget(QWidget *parent, QString componentType, QString appType = QString());
     virtual ~ComponentInputWidget();
 
+    // The components are shown as they load. loadComponentVisualization() is called once the headings of the file are known, then
+    // addComponentBatchToVisualization() is called for each batch of components in order, after they are added to the database,
+    // and finishComponentVisualization() is called once all of the batches are in
     virtual int loadComponentVisualization();
+    virtual int addComponentBatchToVisualization(const ComponentBatch& batch);
+    virtual void finishComponentVisualization(void);
 
     virtual Esri::ArcGISRuntime::Feature*  addFeatureToSelectedLayer(QMap<QString, QVariant>& featureAttributes, Esri::ArcGISRuntime::Geometry& geom);
     virtual int removeFeatureFromSelectedLayer(Esri::ArcGISRuntime::Feature* feat);
 
+    // Batched versions of the above that add or remove many features with one call to the feature table. Returns the features in the same
+    // order as the attributes. The default implementations fall back to adding or removing the features one at a time
+    virtual QList<Esri::ArcGISRuntime::Feature*> addFeaturesToSelectedLayer(const QList<QMap<QString, QVariant>>& featuresAttributes, const QList<Esri::ArcGISRuntime::Geometry>& geoms);
+    virtual int removeFeaturesFromSelectedLayer(const QList<Esri::ArcGISRuntime::Feature*>& feats);
+
     virtual Esri::ArcGISRuntime::FeatureCollectionLayer* getSelectedFeatureLayer(void);
 
+    // The layer that shows all of the components. The components in this layer are selected from the spatial index of the database rather
+    // than by querying the layer, returns nullptr if there is no such layer
+    virtual Esri::ArcGISRuntime::Layer* getComponentLayer(void);
+
     QGroupBox* getComponentsWidget(void);
 
-    QTableWidget *getTableWidget() const;
+    QTableView *getTableView() const;
 
     // Set the filter string and select the components
     void setFilterString(const QString& filter);
     QString getFilterString(void);
 
     void insertSelectedComponent(const int ComponentID);
+    void insertSelectedComponents(const IntervalSet& IDs);
 
     int numberComponentsSelected(void);
 
@@ -125,20 +148,34 @@ signals:
 
 public slots:
     void handleComponentSelection(void);
-    void handleCellChanged(int row, int column);
+    void handleAttributeEdited(int row, const QString& attribute, const QVariant& value);
 
 private slots:
     void selectComponents(void);
+    void selectComponentsByQuery(void);
     void loadComponentData(void);
+    void cancelLoading(void);
+    void handleHeadingsLoaded(QStringList headings, int numRows);
+    void handleBatchLoaded(ComponentBatch batch);
+    void handleLoadingFinished(bool cancelled, QString err);
     void chooseComponentInfoFileDialog(void);
     void clearComponentSelection(void);
     void clearLayerSelectedForAnalysis(void);
 
 protected:
     VisualizationWidget* theVisualizationWidget;
-    QTableWidget* componentTableWidget;
+    QTableView* componentTableView;
+    ComponentTableModel* componentTableModel;
+    ComponentSelectionFilter* componentSelectionFilter;
     ComponentDatabase theComponentDb;
 
+    // Builds the geometries of a batch of components, see ComponentLoader::GeometryBuilder
+    // It is called on the loader's worker threads, so it must only read the batch and the headings
+    virtual int createComponentGeometries(const QStringList& headings, ComponentBatch& batch, QString& err) const;
+
+    // The key under which the geometries are cached, see ComponentLoader::setGeometryBuilder. The geometries are not cached if it is empty
+    virtual QString getGeometryCacheKey(void) const;
+
     // Returns a vector of sorted items that are unique
     template <typename T>
     void uniqueVec(std::vector<T>& vec)
@@ -155,6 +192,7 @@ protected:
 private:
     QString pathToComponentInfoFile;
     QLineEdit* componentFileLineEdit;
+    QLineEdit* queryLineEdit;
     AssetInputDelegate* selectComponentsLineEdit;
     QLabel* componentInfoText;
     QGroupBox* componentGroupBox;
@@ -169,8 +207,25 @@ private:
 
     void createComponentsBox(void);
 
+    // Stops the loader, any batches that it has not sent yet are dropped
+    void stopLoading(void);
+
+    // Removes the components of a load that failed part way through, along with their layer
+    void discardLoadedComponents(void);
+
+    QPointer<ComponentLoader> componentLoader;
+    QPointer<QThread> loaderThread;
+    QProgressBar* loadProgressBar;
+    QPushButton* cancelLoadButton;
+
+    // A filter that was set while the components were loading, it is applied once they are loaded
+    QString pendingFilter;
+
     // Map to store the selected features according to their UID
-    QMap<QString, Esri::ArcGISRuntime::Feature*> selectedFeaturesForAnalysis;
+    QHash<QString, Esri::ArcGISRuntime::Feature*> selectedFeaturesForAnalysis;
+
+    // The number of features that are added to the selected layer in each call to the feature table
+    static const int selectedFeatureBatchSize = 10000;
 };
 
 #endif // ComponentInputWidget_H
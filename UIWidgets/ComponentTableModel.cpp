@@ -0,0 +1,173 @@
+/* *****************************************************************************
+Copyright (c) 2016-2021, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+// Written by: Stevan Gavrilovic
+
+#include "ComponentTableModel.h"
+#include "ComponentDatabase.h"
+
+ComponentTableModel::ComponentTableModel(ComponentDatabase* database, QObject* parent) : QAbstractTableModel(parent), theDatabase(database)
+{
+
+}
+
+
+void ComponentTableModel::setHeadings(const QStringList& headings)
+{
+    beginResetModel();
+
+    tableHeadings = headings;
+
+    databaseColumns.assign(headings.size(), -1);
+
+    for(int i = 1; i<headings.size(); ++i)
+        databaseColumns[i] = theDatabase->getAttributeIndex(headings.at(i));
+
+    numRows = theDatabase->getNumberOfComponents();
+
+    endResetModel();
+}
+
+
+QStringList ComponentTableModel::getHeadings(void) const
+{
+    return tableHeadings;
+}
+
+
+void ComponentTableModel::updateRowCount(void)
+{
+    auto newNumRows = theDatabase->getNumberOfComponents();
+
+    if(newNumRows <= numRows)
+        return;
+
+    beginInsertRows(QModelIndex(), numRows, newNumRows-1);
+    numRows = newNumRows;
+    endInsertRows();
+}
+
+
+void ComponentTableModel::clear(void)
+{
+    beginResetModel();
+
+    tableHeadings.clear();
+    databaseColumns.clear();
+    numRows = 0;
+
+    endResetModel();
+}
+
+
+QString ComponentTableModel::getCellText(const int row, const int col) const
+{
+    if(col == 0)
+        return QString::number(theDatabase->getID(row));
+
+    return theDatabase->getAttributeText(row, databaseColumns[col]);
+}
+
+
+int ComponentTableModel::rowCount(const QModelIndex &parent) const
+{
+    if(parent.isValid())
+        return 0;
+
+    return numRows;
+}
+
+
+int ComponentTableModel::columnCount(const QModelIndex &parent) const
+{
+    if(parent.isValid())
+        return 0;
+
+    return tableHeadings.size();
+}
+
+
+QVariant ComponentTableModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || (role != Qt::DisplayRole && role != Qt::EditRole))
+        return QVariant();
+
+    // Return the text rather than the number so that the view does not round it
+    return this->getCellText(index.row(), index.column());
+}
+
+
+bool ComponentTableModel::setData(const QModelIndex &index, const QVariant &value, int role)
+{
+    if (!index.isValid() || role != Qt::EditRole || index.column() < 3)
+        return false;
+
+    auto row = index.row();
+    auto attribute = tableHeadings.at(index.column());
+
+    theDatabase->updateComponentAttribute(theDatabase->getID(row), attribute, value);
+
+    // The attribute is in the schema now if it was not before
+    databaseColumns[index.column()] = theDatabase->getAttributeIndex(attribute);
+
+    emit dataChanged(index, index, {Qt::DisplayRole, Qt::EditRole});
+
+    emit attributeEdited(row, attribute, value);
+
+    return true;
+}
+
+
+QVariant ComponentTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole || section < 0 || section >= tableHeadings.size())
+        return {};
+
+    return tableHeadings.at(section);
+}
+
+
+Qt::ItemFlags ComponentTableModel::flags(const QModelIndex &index) const
+{
+    if (!index.isValid())
+        return QAbstractTableModel::flags(index);
+
+    // The first three columns (ID, lat, lon) are not editable
+    if(index.column() < 3)
+        return Qt::ItemIsSelectable;
+
+    return Qt::ItemIsSelectable | Qt::ItemIsEnabled | Qt::ItemIsEditable;
+}
@@ -0,0 +1,98 @@
+#ifndef COMPONENTTABLEMODEL_H
+#define COMPONENTTABLEMODEL_H
+/* *****************************************************************************
+Copyright (c) 2016-2021, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+// Written by: Stevan Gavrilovic
+
+// Table model over the columns of a ComponentDatabase. No data is copied into the model, the cells are read from the database when the view
+// asks for them, so only the visible rows are ever converted to text. Edits go straight into the database and the component features
+
+#include <QAbstractTableModel>
+#include <QStringList>
+
+#include <vector>
+
+class ComponentDatabase;
+
+class ComponentTableModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    ComponentTableModel(ComponentDatabase* database, QObject* parent);
+
+    // Sets the columns of the table. The first column is the component ID and the others are attributes in the database
+    void setHeadings(const QStringList& headings);
+
+    QStringList getHeadings(void) const;
+
+    // Adds the rows for any components that were added to the database since the headings were set
+    void updateRowCount(void);
+
+    void clear(void);
+
+    // Returns the cell as text, it is safe to call from multiple threads as long as the database is not being modified
+    QString getCellText(const int row, const int col) const;
+
+    // QAbstractItemModel interface
+public:
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+
+    QVariant data(const QModelIndex &index, int role) const override;
+    bool setData(const QModelIndex &index, const QVariant &value, int role) override;
+    Qt::ItemFlags flags(const QModelIndex &index) const override;
+
+    QVariant headerData(int section, Qt::Orientation orientation, int role) const override;
+
+signals:
+    // Emitted when the user edits an attribute in the table
+    void attributeEdited(int row, const QString& attribute, const QVariant& value);
+
+private:
+    ComponentDatabase* theDatabase = nullptr;
+
+    QStringList tableHeadings;
+
+    // The database column of each table column, with -1 for the ID column
+    std::vector<int> databaseColumns;
+
+    int numRows = 0;
+};
+
+#endif // COMPONENTTABLEMODEL_H
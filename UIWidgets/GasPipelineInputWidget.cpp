@@ -11,7 +11,7 @@
 #include "SimpleLineSymbol.h"
 #include "PolylineBuilder.h"
 
-#include <QTableWidget>
+#include "ComponentLoader.h"
 
 using namespace Esri::ArcGISRuntime;
 
@@ -35,16 +35,17 @@ int GasPipelineInputWidget::loadComponentVisualization()
     fields.append(Field::createText("TabName", "NULL",4));
     fields.append(Field::createText("UID", "NULL",4));
 
+    auto headers = this->getTableHorizontalHeadings();
+
     // Set the table headers as fields in the table
-    for(int i =0; i<componentTableWidget->columnCount(); ++i)
+    for(int i =0; i<headers.size(); ++i)
     {
-        auto headerItem = componentTableWidget->horizontalHeaderItem(i);
-        auto fieldText = headerItem->text();
+        auto fieldText = headers.at(i);
         fields.append(Field::createText(fieldText, fieldText,fieldText.size()));
     }
 
     // Create the pipelines group layer that will hold the sublayers
-    auto pipelineLayer = new GroupLayer(QList<Layer*>{},this);
+    pipelineLayer = new GroupLayer(QList<Layer*>{},this);
     pipelineLayer->setName("Gas Pipelines");
 
     // Add the pipeline layer to the map and get the root tree item
@@ -56,8 +57,6 @@ int GasPipelineInputWidget::loadComponentVisualization()
         return -1;
     }
 
-    auto nRows = componentTableWidget->rowCount();
-
     // Select a column that will define the layers
     //    int columnToMapLayers = 0;
 
@@ -83,7 +82,7 @@ int GasPipelineInputWidget::loadComponentVisualization()
     selectedFeaturesTable->setRenderer(this->createSelectedPipelineRenderer(1.5));
 
     // Map to hold the feature tables
-    std::map<std::string, FeatureCollectionTable*> tablesMap;
+    pipelineTables.clear();
     for(auto&& it : vecLayerItems)
     {
         auto featureCollection = new FeatureCollection(this);
@@ -100,14 +99,19 @@ int GasPipelineInputWidget::loadComponentVisualization()
 
         featureCollectionTable->setRenderer(this->createPipelineRenderer());
 
-        tablesMap.insert(std::make_pair(it,featureCollectionTable));
+        pipelineTables.insert(std::make_pair(it,featureCollectionTable));
 
         theVisualizationWidget->addLayerToMap(newpipelineLayer,pipelinesItem, pipelineLayer);
     }
 
+    pipelineLayer->load();
+
+    return 0;
+}
 
-    auto headers = this->getTableHorizontalHeadings();
 
+int GasPipelineInputWidget::createComponentGeometries(const QStringList& headers, ComponentBatch& batch, QString& err) const
+{
     auto indexLatStart = headers.indexOf("LAT_BEGIN");
     auto indexLonStart = headers.indexOf("LONG_BEGIN");
     auto indexLatEnd = headers.indexOf("LAT_END");
@@ -115,101 +119,112 @@ int GasPipelineInputWidget::loadComponentVisualization()
 
     if(indexLatStart == -1 || indexLonStart == -1 || indexLatEnd == -1 || indexLonEnd == -1)
     {
-        errorMessage("Could not find the required lat./lon. header labels in the input file");
+        err = "Could not find the required lat./lon. header labels in the input file";
         return -1;
     }
 
-    for(int i = 0; i<nRows; ++i)
+    batch.geometries.reserve(batch.numRows);
+
+    for(int i = 0; i<batch.numRows; ++i)
     {
+        auto latitudeStart = batch.cell(i,indexLatStart).toDouble();
+        auto longitudeStart = batch.cell(i,indexLonStart).toDouble();
 
-        // create the feature attributes
-        QMap<QString, QVariant> featureAttributes;
+        auto latitudeEnd = batch.cell(i,indexLatEnd).toDouble();
+        auto longitudeEnd = batch.cell(i,indexLonEnd).toDouble();
 
-        // Create a new pipeline
-        Component pipeline;
+        // Create the points and add it to the feature table
+        PolylineBuilder polylineBuilder(SpatialReference::wgs84());
 
-        QString pipelineIDStr = componentTableWidget->item(i,0)->data(0).toString();
+        // Get the two start and end points of the pipeline segment
 
-        int pipelineID =  pipelineIDStr.toInt();
+        Point point1(longitudeStart,latitudeStart);
 
-        pipeline.ID = pipelineID;
+        Point point2(longitudeEnd,latitudeEnd);
 
-        QMap<QString, QVariant> pipelineAttributeMap;
+        polylineBuilder.addPoint(point1);
+        polylineBuilder.addPoint(point2);
 
-        // The feature attributes are the columns from the table
-        for(int j = 0; j<componentTableWidget->columnCount(); ++j)
+        if(!polylineBuilder.isSketchValid())
         {
-            auto attrbText = componentTableWidget->horizontalHeaderItem(j)->text();
-            auto attrbVal = componentTableWidget->item(i,j)->data(0);
-
-            pipelineAttributeMap.insert(attrbText,attrbVal.toString());
-
-            featureAttributes.insert(attrbText,attrbVal);
+            err = "Error, cannot create a pipeline feature with the latitude and longitude provided";
+            return -1;
         }
 
-        // Create a unique ID for the pipeline
-        auto uid = theVisualizationWidget->createUniqueID();
+        // Create the polyline geometry
+        batch.geometries.push_back(polylineBuilder.toPolyline());
+    }
 
-        pipeline.ComponentAttributes = pipelineAttributeMap;
+    return 0;
+}
 
-        featureAttributes.insert("ID", pipelineIDStr);
-        featureAttributes.insert("RepairRate", 0.0);
-        featureAttributes.insert("AssetType", "GASPIPELINES");
-        featureAttributes.insert("TabName", componentTableWidget->item(i,0)->data(0).toString());
-        featureAttributes.insert("UID", uid);
 
-        // Get the feature collection table from the map
-        //        auto layerTag = pipelineTableWidget->item(i,columnToMapLayers)->data(0).toString().toStdString();
-        auto layerTag = "Pipeline Network";
+QString GasPipelineInputWidget::getGeometryCacheKey(void) const
+{
+    return "GasPipelines-1";
+}
 
-        auto featureCollectionTable = tablesMap.at(layerTag);
 
-        auto latitudeStart = componentTableWidget->item(i,indexLatStart)->data(0).toDouble();
-        auto longitudeStart = componentTableWidget->item(i,indexLonStart)->data(0).toDouble();
+int GasPipelineInputWidget::addComponentBatchToVisualization(const ComponentBatch& batch)
+{
+    auto headers = this->getTableHorizontalHeadings();
 
-        auto latitudeEnd = componentTableWidget->item(i,indexLatEnd)->data(0).toDouble();
-        auto longitudeEnd = componentTableWidget->item(i,indexLonEnd)->data(0).toDouble();
+    auto nCols = headers.size();
 
-        // Create the points and add it to the feature table
-        PolylineBuilder polylineBuilder(SpatialReference::wgs84());
+    // Get the feature collection table from the map
+    //        auto layerTag = pipelineTableWidget->item(i,columnToMapLayers)->data(0).toString().toStdString();
+    auto layerTag = "Pipeline Network";
 
-        // Get the two start and end points of the pipeline segment
+    auto featureCollectionTable = pipelineTables.at(layerTag);
 
-        Point point1(longitudeStart,latitudeStart);
+    QList<Feature*> newFeatures;
 
-        Point point2(longitudeEnd,latitudeEnd);
+    for(int i = 0; i<batch.numRows; ++i)
+    {
+        // create the feature attributes
+        QMap<QString, QVariant> featureAttributes;
 
-        polylineBuilder.addPoint(point1);
-        polylineBuilder.addPoint(point2);
+        QString pipelineIDStr = batch.cell(i,0).toString();
 
-        if(!polylineBuilder.isSketchValid())
-        {
-            this->errorMessage("Error, cannot create a pipeline feature with the latitude and longitude provided");
-            return -1;
-        }
+        // The feature attributes are the columns from the file, the pipeline attributes are already in the database
+        for(int j = 0; j<nCols; ++j)
+            featureAttributes.insert(headers.at(j),batch.cell(i,j).toString());
 
-        // Create the polyline feature
-        auto polyline =  polylineBuilder.toPolyline();
+        // Create a unique ID for the pipeline
+        auto uid = theVisualizationWidget->createUniqueID();
 
-        // Add the feature to the table
-        Feature* feature = featureCollectionTable->createFeature(featureAttributes, polyline, this);
+        featureAttributes.insert("ID", pipelineIDStr);
+        featureAttributes.insert("RepairRate", 0.0);
+        featureAttributes.insert("AssetType", "GASPIPELINES");
+        featureAttributes.insert("TabName", pipelineIDStr);
+        featureAttributes.insert("UID", uid);
 
-        pipeline.UID = uid;
-        pipeline.ComponentFeature = feature;
+        // Add the feature to the table
+        Feature* feature = featureCollectionTable->createFeature(featureAttributes, batch.geometries.at(i), this);
 
-        theComponentDb.addComponent(pipelineID, pipeline);
+        // Attach the feature to the pipeline in the database
+        auto row = batch.firstRow + i;
+        theComponentDb.setUID(row, uid);
+        theComponentDb.setFeature(row, feature);
 
-        featureCollectionTable->addFeature(feature);
+        newFeatures.append(feature);
     }
 
-    pipelineLayer->load();
-
-    theVisualizationWidget->zoomToLayer(pipelineLayer->layerId());
+    featureCollectionTable->addFeatures(newFeatures);
 
     return 0;
 }
 
 
+void GasPipelineInputWidget::finishComponentVisualization(void)
+{
+    if(pipelineLayer == nullptr)
+        return;
+
+    theVisualizationWidget->zoomToLayer(pipelineLayer->layerId());
+}
+
+
 Feature* GasPipelineInputWidget::addFeatureToSelectedLayer(QMap<QString, QVariant>& featureAttributes, Geometry& geom)
 {
     Feature* feat = selectedFeaturesTable->createFeature(featureAttributes,geom,this);
@@ -227,12 +242,41 @@ int GasPipelineInputWidget::removeFeatureFromSelectedLayer(Esri::ArcGISRuntime::
 }
 
 
+QList<Feature*> GasPipelineInputWidget::addFeaturesToSelectedLayer(const QList<QMap<QString, QVariant>>& featuresAttributes, const QList<Geometry>& geoms)
+{
+    QList<Feature*> features;
+    features.reserve(featuresAttributes.size());
+
+    for(int i = 0; i<featuresAttributes.size(); ++i)
+        features.append(selectedFeaturesTable->createFeature(featuresAttributes.at(i),geoms.at(i),this));
+
+    // Add all of the features to the table at once
+    selectedFeaturesTable->addFeatures(features);
+
+    return features;
+}
+
+
+int GasPipelineInputWidget::removeFeaturesFromSelectedLayer(const QList<Esri::ArcGISRuntime::Feature*>& feats)
+{
+    selectedFeaturesTable->deleteFeatures(feats);
+
+    return 0;
+}
+
+
 Esri::ArcGISRuntime::FeatureCollectionLayer* GasPipelineInputWidget::getSelectedFeatureLayer(void)
 {
     return selectedFeaturesLayer;
 }
 
 
+Esri::ArcGISRuntime::Layer* GasPipelineInputWidget::getComponentLayer(void)
+{
+    return pipelineLayer;
+}
+
+
 void GasPipelineInputWidget::clear()
 {
     delete selectedFeaturesLayer;
@@ -241,6 +285,9 @@ void GasPipelineInputWidget::clear()
     selectedFeaturesLayer = nullptr;
     selectedFeaturesTable = nullptr;
 
+    pipelineLayer = nullptr;
+    pipelineTables.clear();
+
     ComponentInputWidget::clear();
 }
 
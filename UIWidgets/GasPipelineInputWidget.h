@@ -3,6 +3,9 @@
 
 #include "ComponentInputWidget.h"
 
+#include <map>
+#include <string>
+
 namespace Esri
 {
 namespace ArcGISRuntime
@@ -11,7 +14,9 @@ class ClassBreaksRenderer;
 class Renderer;
 class SimpleRenderer;
 class Feature;
+class FeatureCollectionTable;
 class Geometry;
+class GroupLayer;
 }
 }
 
@@ -21,13 +26,23 @@ public:
     GasPipelineInputWidget(QWidget *parent, QString componentType, QString appType = QString());
 
     int loadComponentVisualization();
+    int addComponentBatchToVisualization(const ComponentBatch& batch);
+    void finishComponentVisualization(void);
 
     Esri::ArcGISRuntime::Feature* addFeatureToSelectedLayer(QMap<QString, QVariant>& featureAttributes, Esri::ArcGISRuntime::Geometry& geom);
     int removeFeatureFromSelectedLayer(Esri::ArcGISRuntime::Feature* feat);
+    QList<Esri::ArcGISRuntime::Feature*> addFeaturesToSelectedLayer(const QList<QMap<QString, QVariant>>& featuresAttributes, const QList<Esri::ArcGISRuntime::Geometry>& geoms);
+    int removeFeaturesFromSelectedLayer(const QList<Esri::ArcGISRuntime::Feature*>& feats);
     Esri::ArcGISRuntime::FeatureCollectionLayer* getSelectedFeatureLayer(void);
+    Esri::ArcGISRuntime::Layer* getComponentLayer(void);
 
     void clear();
 
+protected:
+
+    int createComponentGeometries(const QStringList& headers, ComponentBatch& batch, QString& err) const;
+    QString getGeometryCacheKey(void) const;
+
 private:
 
     Esri::ArcGISRuntime::Renderer* createPipelineRenderer(void);
@@ -35,6 +50,11 @@ private:
 
     Esri::ArcGISRuntime::FeatureCollectionLayer* selectedFeaturesLayer = nullptr;
     Esri::ArcGISRuntime::FeatureCollectionTable* selectedFeaturesTable = nullptr;
+
+    Esri::ArcGISRuntime::GroupLayer* pipelineLayer = nullptr;
+
+    // Map to hold the feature tables
+    std::map<std::string, Esri::ArcGISRuntime::FeatureCollectionTable*> pipelineTables;
 };
 
 #endif // GasPipelineInputWidget_H
@@ -37,6 +37,8 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 // Written by: Stevan Gavrilovic
 
 #include "CSVReaderWriter.h"
+#include "CSVRowReader.h"
+#include "DecompressionDevice.h"
 #include "GroundMotionStation.h"
 
 #include <QFileInfo>
@@ -67,77 +69,70 @@ double GroundMotionStation::getLongitude() const
 
 void GroundMotionStation::importGroundMotions(void)
 {
-    CSVReaderWriter csvTool;
+    QFileInfo stationInfo(stationFilePath);
 
-    QString err;
-    QVector<QStringList> data = csvTool.parseCSVFile(stationFilePath,err);
+    auto baseDir = stationInfo.dir().absolutePath();
 
-    // Return if there is an error or the data is empty
-    if(!err.isEmpty())
-        throw err;
-
-    if(data.size() < 2)
-        throw "The file " + stationFilePath + " is empty";
+    int numCols = -1;
 
-    // Get the header file
-    QStringList tableHeadings = data.first();
+    // Stream the station file a row at a time, the header is checked before the first row
+    auto visitor = [&](const CSVRowReader& row)
+    {
+        if(numCols == -1)
+        {
+            QStringList tableHeadings = row.getHeader();
 
-    // Pop off the row that contains the header information
-    data.pop_front();
+            numCols = tableHeadings.size();
 
-    auto numRows = data.size();
-    auto numCols = tableHeadings.size();
+            // Only a list of ground motion files is imported
+            if(tableHeadings.at(0).compare("GM_file") != 0)
+                return false;
 
-    if(tableHeadings.at(0).compare("GM_file") == 0)
-    {
-        if(numCols != 2)
-            throw "The number of columns in the header should be 2";
+            if(numCols != 2)
+                throw QString("The number of columns in the header should be 2");
+        }
 
-        QFileInfo stationInfo(stationFilePath);
+        if(row.columnCount() != numCols)
+            throw "The number of columns in the row " + QString::number(row.getRowNumber()-1) + " should be " + QString::number(numCols);
 
-        auto baseDir = stationInfo.dir().absolutePath();
+        auto GMFile = row.at(0).toString();
 
-        // Get the data
-        for(int i = 0; i<numRows; ++i)
-        {
-            auto rowStringList = data[i];
+        bool ok;
+        auto factor = row.at(1).toDouble(&ok);
 
-            if(rowStringList.size() != numCols)
-                throw "The number of columns in the row " + QString::number(i) + " should be " + QString::number(numCols);
+        if(!ok)
+            throw "Error converting the string " + row.at(1).toString() + " to a double";
 
-            auto GMFile = rowStringList[0];
+        auto GMFilePath = baseDir + QDir::separator() + GMFile + ".json";
 
-            bool ok;
-            auto factor = rowStringList[1].toDouble(&ok);
+        this->importGroundMotionTimeHistory(GMFilePath, factor);
 
-            if(!ok)
-                throw "Error converting the string " + rowStringList[1] + " to a double";
+        return true;
+    };
 
-            auto GMFilePath = baseDir + QDir::separator() + GMFile + ".json";
+    CSVReaderWriter csvTool;
 
-            this->importGroundMotionTimeHistory(GMFilePath, factor);
-        }
-    }
+    QString err;
+    if(csvTool.forEachRow(stationFilePath, visitor, err) != 0)
+        throw err;
 
+    if(numCols == -1)
+        throw "The file " + stationFilePath + " is empty";
 }
 
 
 void GroundMotionStation::importGroundMotionTimeHistory(const QString& filePath,const double scalingFactor)
 {
-    QFile file(filePath);
-    if (!file.open(QFile::ReadOnly | QFile::Text))
-        throw "Could not open the file at: "+ filePath;
-
+    // Read the file, decompressing it if it is compressed
+    QByteArray val;
+    QString err;
+    if (DecompressionDevice::readFile(filePath, val, err) != 0)
+        throw "Could not open the file at: "+ filePath + "\n" + err;
 
     // place contents of file into json object
-    QString val;
-    val=file.readAll();
-    QJsonDocument doc = QJsonDocument::fromJson(val.toUtf8());
+    QJsonDocument doc = QJsonDocument::fromJson(val);
     QJsonObject jsonObj = doc.object();
 
-    // close file
-    file.close();
-
     // Get the name
     auto gmNameObj = jsonObj.value("name");
 
@@ -46,14 +46,17 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 #include "GridNode.h"
 #include "NodeHandle.h"
 #include "LayerTreeItem.h"
+#include "PointPyramid.h"
 #include "PolygonBoundary.h"
 #include "CSVReaderWriter.h"
+#include "GeoJsonReader.h"
 #include "Utils/PythonProgressDialog.h"
 
 #include "GroupLayer.h"
 #include "Feature.h"
 #include "FeatureCollection.h"
 #include "FeatureCollectionLayer.h"
+#include "FeatureCollectionTable.h"
 #include "SimpleRenderer.h"
 #include "SimpleFillSymbol.h"
 #include "SimpleMarkerSymbol.h"
@@ -814,25 +817,9 @@ void HurricaneSelectionWidget::handleGridSelected(void)
     tableFields.append(Field::createText("Longitude", "NULL",9));
     tableFields.append(Field::createText("Peak Wind Speeds", "NULL",9));
 
-    auto gridFeatureCollection = new FeatureCollection(this);
-
-    // Create the feature collection table/layers
-    auto gridFeatureCollectionTable = new FeatureCollectionTable(tableFields, GeometryType::Point, SpatialReference::wgs84(), this);
-    gridFeatureCollection->tables()->append(gridFeatureCollectionTable);
-
-    gridLayer = new FeatureCollectionLayer(gridFeatureCollection,this);
-    gridLayer->setAutoFetchLegendInfos(true);
-    gridLayer->setName("Wind Field Grid");
-
-    // Create red cross SimpleMarkerSymbol
-    SimpleMarkerSymbol* crossSymbol = new SimpleMarkerSymbol(SimpleMarkerSymbolStyle::Cross, QColor("black"), 6, this);
-
-    // Create renderer and set symbol to crossSymbol
-    SimpleRenderer* renderer = new SimpleRenderer(crossSymbol, this);
-    renderer->setLabel("Windfield Grid Point");
-
-    // Set the renderer for the feature layer
-    gridFeatureCollectionTable->setRenderer(renderer);
+    // The attributes and the coordinates of the grid points, the layer is created from them once they are all in
+    QList<QMap<QString, QVariant>> gridPointsAttributes;
+    std::vector<double> gridPointsCoordinates;
 
     QStringList headerRow = {"GP_file", "Latitude", "Longitude"};
     gridData.push_back(headerRow);
@@ -861,13 +848,9 @@ void HurricaneSelectionWidget::handleGridSelected(void)
         featureAttributes.insert("Longitude", longitude);
         featureAttributes.insert("Peak Wind Speeds", "N/A");
 
-        // Create the point and add it to the feature table
-        Point point(longitude,latitude);
-        Feature* feature = gridFeatureCollectionTable->createFeature(featureAttributes, point, this);
-
-        station.setStationFeature(feature);
-
-        gridFeatureCollectionTable->addFeature(feature);
+        gridPointsAttributes.append(featureAttributes);
+        gridPointsCoordinates.push_back(longitude);
+        gridPointsCoordinates.push_back(latitude);
 
         QStringList stationRow;
         stationRow.push_back(stationName);
@@ -879,6 +862,64 @@ void HurricaneSelectionWidget::handleGridSelected(void)
         gridData.push_back(stationRow);
     }
 
+    // Dense grids are shown with fewer points when zoomed out
+    PointPyramid gridPyramid;
+    gridPyramid.build(gridPointsCoordinates);
+
+    // The feature of each station in the finest level that has it, for searching by station name
+    QList<Feature*> stationFeatures;
+    QStringList stationNames;
+
+    for(auto&& it : gridPointsAttributes)
+    {
+        stationFeatures.append(nullptr);
+        stationNames.append(it.value("Station Name").toString());
+    }
+
+    gridLayer = gridPyramid.createLayer("Wind Field Grid", [&](const PointPyramid::Level& level)
+    {
+        auto gridFeatureCollectionTable = new FeatureCollectionTable(tableFields, GeometryType::Point, SpatialReference::wgs84(), this);
+
+        // Create red cross SimpleMarkerSymbol
+        SimpleMarkerSymbol* crossSymbol = new SimpleMarkerSymbol(SimpleMarkerSymbolStyle::Cross, QColor("black"), 6, this);
+
+        // Create renderer and set symbol to crossSymbol
+        SimpleRenderer* renderer = new SimpleRenderer(crossSymbol, this);
+        renderer->setLabel("Windfield Grid Point");
+
+        // Set the renderer for the feature layer
+        gridFeatureCollectionTable->setRenderer(renderer);
+
+        QList<Feature*> features;
+        features.reserve(int(level.points.size()));
+
+        for(auto&& index : level.points)
+        {
+            // Create the point and add it to the feature table
+            Point point(gridPointsCoordinates[2*index],gridPointsCoordinates[2*index+1]);
+            auto feature = gridFeatureCollectionTable->createFeature(gridPointsAttributes.at(index), point, this);
+
+            // The station keeps its feature in every level so that the results are shown at any zoom
+            auto station = stationMap.find(QString::number(index+1));
+
+            if(station != stationMap.end())
+                station->addStationFeature(feature);
+
+            // The levels are built from the coarsest to the finest, so the search finds the feature in the finest level
+            stationFeatures[index] = feature;
+
+            features.append(feature);
+        }
+
+        gridFeatureCollectionTable->addFeatures(features);
+
+        return gridFeatureCollectionTable;
+    }, this);
+
+    gridLayer->setAutoFetchLegendInfos(true);
+
+    theVisualizationWidget->addSearchIndex(gridLayer, "Station Name", stationNames, stationFeatures);
+
 
     // Create a new layer
     LayerTreeView *layersTreeView = theVisualizationWidget->getLayersTree();
@@ -1511,61 +1552,43 @@ void HurricaneSelectionWidget::handleTerrainImport(void)
         return;
     }
 
-    // open file
-    QFile file(terrainPath);
-    if (!file.open(QFile::ReadOnly | QFile::Text))
-    {
-        QString msg = QString("Cannot open the file:") + terrainPath;
-        this->errorMessage(msg);
-        return;
-    }
-
-    terrainLineEdit->setText(terrainPath);
-
-    // Place contents of file into json object
-    QString val;
-    val=file.readAll();
-    QJsonDocument doc = QJsonDocument::fromJson(val.toUtf8());
-    QJsonObject jsonObj = doc.object();
-
-    // Extract the features
-    auto featureArray = jsonObj["features"].toArray();
-
-    auto numFeat = featureArray.size();
-
-    if(numFeat == 0)
-    {
-        QString msg = "Could find any features in: " + terrainPath;
-        this->errorMessage(msg);
-        return;
-    }
-
     std::vector<Esri::ArcGISRuntime::Geometry> geomVec;
     std::vector<QVariantMap> propertiesMapVec;
 
-    for(auto&& it : featureArray)
+    // Stream the features out of the file rather than reading the whole file into a json document
+    QString err;
+    auto res = GeoJsonReader::readFile(terrainPath, [&](GeoJsonFeature& feature, QString& featureErr)
     {
-        auto featObj = it.toObject();
-
-        auto geom = featObj["geometry"].toObject();
-
-        auto coordArray = geom["coordinates"].toArray();
-
-        auto featGeom = theVisualizationWidget->getPolygonGeometryFromJson(coordArray);
+        auto featGeom = theVisualizationWidget->getPolygonGeometryFromGeoJson(feature);
 
         if(featGeom.isEmpty())
         {
-            QString msg ="Error getting the hurricane geometry in: " + terrainPath;
-            this->errorMessage(msg);
-            return;
+            featureErr ="Error getting the hurricane geometry in: " + terrainPath;
+            return -1;
         }
 
         geomVec.push_back(featGeom);
 
-        auto properties = featObj["properties"].toObject();
-        propertiesMapVec.push_back(properties.toVariantMap());
+        propertiesMapVec.push_back(std::move(feature.properties));
+
+        return 0;
+    }, err);
+
+    if(res != 0)
+    {
+        this->errorMessage(err);
+        return;
+    }
+
+    if(geomVec.empty())
+    {
+        QString msg = "Could find any features in: " + terrainPath;
+        this->errorMessage(msg);
+        return;
     }
 
+    terrainLineEdit->setText(terrainPath);
+
     QList<Field> tableFields;
     tableFields.append(Field::createText("AssetType", "NULL",4));
     tableFields.append(Field::createText("TabName", "NULL",4));
@@ -66,8 +66,8 @@ namespace Esri
 namespace ArcGISRuntime
 {
 class Feature;
-class FeatureCollectionLayer;
 class FeatureCollectionTable;
+class GroupLayer;
 class SimpleRenderer;
 }
 }
@@ -164,7 +164,7 @@ private:
     QLineEdit* terrainLineEdit;
 
     QVector<QStringList> gridData;
-    Esri::ArcGISRuntime::FeatureCollectionLayer* gridLayer;
+    Esri::ArcGISRuntime::GroupLayer* gridLayer;
 
     QMap<QString,WindFieldStation> stationMap;
 
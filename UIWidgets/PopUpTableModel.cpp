@@ -0,0 +1,159 @@
+/* *****************************************************************************
+Copyright (c) 2016-2021, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+// Written by: Stevan Gavrilovic
+
+#include "PopUpTableModel.h"
+
+#include "AttributeListModel.h"
+#include "GeoElement.h"
+
+using namespace Esri::ArcGISRuntime;
+
+PopUpTableModel::PopUpTableModel(QObject* parent) : QAbstractTableModel(parent)
+{
+
+}
+
+
+void PopUpTableModel::addElement(Esri::ArcGISRuntime::GeoElement* element, const QString& layerName)
+{
+    elements.append(element);
+    layerNames.append(layerName);
+}
+
+
+int PopUpTableModel::getNumberOfElements(void) const
+{
+    return elements.size();
+}
+
+
+QString PopUpTableModel::getElementLabel(const int i) const
+{
+    if(i < 0 || i >= elements.size())
+        return QString();
+
+    QString label = elements.at(i)->attributes()->attributeValue("TabName").toString();
+
+    // If the label is empty, use the layer name
+    if(label.isEmpty())
+        label = layerNames.at(i);
+
+    return label;
+}
+
+
+void PopUpTableModel::setCurrentElement(const int i)
+{
+    if(i == currentElement)
+        return;
+
+    beginResetModel();
+
+    currentElement = i;
+    attributeNames.clear();
+    attributeValues.clear();
+
+    if(i >= 0 && i < elements.size())
+    {
+        auto elemAttrib = elements.at(i)->attributes();
+
+        auto listOfAttributes = elemAttrib->attributeNames();
+
+        for(auto&& atrb : listOfAttributes)
+        {
+            if(QString::compare(atrb,"ObjectID") == 0 || QString::compare(atrb,"AssetType") == 0 || QString::compare(atrb,"TabName") == 0)
+                continue;
+
+            auto atrbVal = elemAttrib->attributeValue(atrb).toString();
+
+            // Do not list empty attributes in the popup
+            if(atrbVal.isEmpty())
+                continue;
+
+            attributeNames.append(atrb);
+            attributeValues.append(atrbVal);
+        }
+    }
+
+    endResetModel();
+}
+
+
+int PopUpTableModel::getCurrentElement(void) const
+{
+    return currentElement;
+}
+
+
+int PopUpTableModel::rowCount(const QModelIndex &parent) const
+{
+    if(parent.isValid())
+        return 0;
+
+    return attributeValues.size();
+}
+
+
+int PopUpTableModel::columnCount(const QModelIndex &parent) const
+{
+    if(parent.isValid())
+        return 0;
+
+    return 1;
+}
+
+
+QVariant PopUpTableModel::data(const QModelIndex &index, int role) const
+{
+    if(!index.isValid() || index.row() >= attributeValues.size())
+        return QVariant();
+
+    if(role == Qt::DisplayRole || role == Qt::ToolTipRole)
+        return attributeValues.at(index.row());
+
+    return QVariant();
+}
+
+
+QVariant PopUpTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if(role != Qt::DisplayRole || orientation != Qt::Vertical || section >= attributeNames.size())
+        return QVariant();
+
+    return attributeNames.at(section);
+}
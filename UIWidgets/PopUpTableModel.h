@@ -0,0 +1,93 @@
+#ifndef PopUpTableModel_H
+#define PopUpTableModel_H
+/* *****************************************************************************
+Copyright (c) 2016-2021, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+// Written by: Stevan Gavrilovic
+
+// The attributes of the elements that were identified on the map. The model shows the attributes of one element at a time, and they are
+// only read from the element when it becomes the current element, so the cost of showing a popup does not grow with the number of elements
+
+#include <QAbstractTableModel>
+#include <QStringList>
+#include <QVector>
+
+namespace Esri
+{
+namespace ArcGISRuntime
+{
+class GeoElement;
+}
+}
+
+class PopUpTableModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    PopUpTableModel(QObject* parent);
+
+    // The elements are not owned by the model, they must outlive it. The layer name is the label of an element that has no tab name
+    void addElement(Esri::ArcGISRuntime::GeoElement* element, const QString& layerName);
+
+    int getNumberOfElements(void) const;
+
+    // Returns the label of the element for its tab
+    QString getElementLabel(const int i) const;
+
+    // Reads the attributes of the element into the model
+    void setCurrentElement(const int i);
+    int getCurrentElement(void) const;
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+
+    QVariant data(const QModelIndex &index, int role) const override;
+
+    QVariant headerData(int section, Qt::Orientation orientation, int role) const override;
+
+private:
+    QVector<Esri::ArcGISRuntime::GeoElement*> elements;
+    QStringList layerNames;
+
+    // The attributes of the current element
+    int currentElement = -1;
+    QStringList attributeNames;
+    QStringList attributeValues;
+};
+
+#endif // PopUpTableModel_H
@@ -37,9 +37,15 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 // Written by: Stevan Gavrilovic
 
 #include "PopUpWidget.h"
+#include "PopUpTableModel.h"
 
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QLabel>
 #include <QPushButton>
-#include <QTabWidget>
+#include <QSignalBlocker>
+#include <QTabBar>
+#include <QTableView>
 #include <QVBoxLayout>
 
 PopUpWidget::PopUpWidget(QWidget *parent) : QDialog(parent)
@@ -49,16 +55,45 @@ PopUpWidget::PopUpWidget(QWidget *parent) : QDialog(parent)
     this->setMinimumWidth(350);
     this->setMinimumHeight(350);
 
-    theTabWidget = new QTabWidget(this);
-    theTabWidget->setDocumentMode(true);
+    theTabBar = new QTabBar(this);
+    theTabBar->setDocumentMode(true);
+    theTabBar->setExpanding(false);
+    theTabBar->setUsesScrollButtons(true);
+
+    theTableView = new QTableView(this);
+    theTableView->verticalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    theTableView->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    theTableView->horizontalHeader()->hide();
+    theTableView->setEditTriggers(QAbstractItemView::NoEditTriggers);
+
+    // The buttons to page through the tabs, hidden if there is only one page
+    pageWidget = new QWidget(this);
+    QHBoxLayout *pageLayout = new QHBoxLayout(pageWidget);
+    pageLayout->setContentsMargins(0,0,0,0);
+
+    previousButton = new QPushButton(tr("Previous"), pageWidget);
+    nextButton = new QPushButton(tr("Next"), pageWidget);
+    pageLabel = new QLabel(pageWidget);
+    pageLabel->setAlignment(Qt::AlignCenter);
+
+    pageLayout->addWidget(previousButton);
+    pageLayout->addWidget(pageLabel,1);
+    pageLayout->addWidget(nextButton);
+
+    pageWidget->hide();
 
     QPushButton *closeButton = new QPushButton(this);
     closeButton->setText(tr("Close"));
     closeButton->setMaximumWidth(150);
 
-    mainLayout->addWidget(theTabWidget);
+    mainLayout->addWidget(theTabBar);
+    mainLayout->addWidget(theTableView);
+    mainLayout->addWidget(pageWidget);
     mainLayout->addWidget(closeButton,Qt::AlignHCenter);
 
+    connect(theTabBar,&QTabBar::currentChanged,this,&PopUpWidget::handleTabChanged);
+    connect(previousButton,&QPushButton::clicked,this,&PopUpWidget::showPreviousPage);
+    connect(nextButton,&QPushButton::clicked,this,&PopUpWidget::showNextPage);
     connect(closeButton,SIGNAL(clicked()),this,SLOT(close()));
 }
 
@@ -69,7 +104,71 @@ PopUpWidget::~PopUpWidget()
 }
 
 
-void PopUpWidget::addTab(QWidget *tab, const QString& label)
+void PopUpWidget::setModel(PopUpTableModel* model)
+{
+    theModel = model;
+    theTableView->setModel(model);
+
+    auto numElements = model ? model->getNumberOfElements() : 0;
+
+    pageWidget->setVisible(numElements > pageSize);
+
+    this->showPage(0);
+}
+
+
+void PopUpWidget::showPage(const int page)
+{
+    if(theModel.isNull())
+        return;
+
+    auto numElements = theModel->getNumberOfElements();
+    auto numPages = (numElements + pageSize - 1)/pageSize;
+
+    currentPage = qBound(0, page, qMax(numPages - 1, 0));
+
+    auto firstElement = currentPage*pageSize;
+    auto numOnPage = qMin(pageSize, numElements - firstElement);
+
+    {
+        // Do not load the elements as the tabs are replaced
+        const QSignalBlocker blocker(theTabBar);
+
+        while(theTabBar->count() > 0)
+            theTabBar->removeTab(0);
+
+        for(int i = 0; i<numOnPage; ++i)
+            theTabBar->addTab(theModel->getElementLabel(firstElement + i));
+
+        theTabBar->setCurrentIndex(0);
+    }
+
+    pageLabel->setText(tr("%1 to %2 of %3").arg(firstElement + 1).arg(firstElement + numOnPage).arg(numElements));
+    previousButton->setEnabled(currentPage > 0);
+    nextButton->setEnabled(currentPage < numPages - 1);
+
+    this->handleTabChanged(theTabBar->currentIndex());
+
+    emit pageChanged(firstElement, numOnPage);
+}
+
+
+void PopUpWidget::handleTabChanged(int index)
+{
+    if(theModel.isNull() || index < 0)
+        return;
+
+    theModel->setCurrentElement(currentPage*pageSize + index);
+}
+
+
+void PopUpWidget::showPreviousPage(void)
+{
+    this->showPage(currentPage - 1);
+}
+
+
+void PopUpWidget::showNextPage(void)
 {
-    theTabWidget->addTab(tab,label);
+    this->showPage(currentPage + 1);
 }
@@ -41,8 +41,15 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 #include <QDialog>
 #include <QPointer>
 
-class QTabWidget;
+class PopUpTableModel;
 
+class QLabel;
+class QPushButton;
+class QTabBar;
+class QTableView;
+
+// Shows the attributes of the identified elements, with a tab for each element. The tabs are shown a page at a time and only the attributes of
+// the element in the current tab are read, so that clicking on an area with many elements does not build a view for each of them
 class PopUpWidget : public QDialog
 {
     Q_OBJECT
@@ -51,10 +58,35 @@ public:
 
     ~PopUpWidget();
 
-    void addTab(QWidget *tab, const QString& label);
+    // The model is not owned by the popup
+    void setModel(PopUpTableModel* model);
+
+    // The number of tabs on a page
+    static const int pageSize = 25;
+
+signals:
+    // Emitted when a page is shown, with the first element on the page and the number of elements on it
+    void pageChanged(int firstElement, int numElements);
+
+private slots:
+    void handleTabChanged(int index);
+    void showPreviousPage(void);
+    void showNextPage(void);
+
+private:
+    void showPage(const int page);
+
+    QPointer<PopUpTableModel> theModel;
+
+    QTabBar* theTabBar = nullptr;
+    QTableView* theTableView = nullptr;
 
-    QPointer<QTabWidget> theTabWidget;
+    QWidget* pageWidget = nullptr;
+    QLabel* pageLabel = nullptr;
+    QPushButton* previousButton = nullptr;
+    QPushButton* nextButton = nullptr;
 
+    int currentPage = 0;
 };
 
 #endif // POPUPWIDGET_H
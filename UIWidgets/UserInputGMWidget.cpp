@@ -38,12 +38,14 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 
 #include "CSVReaderWriter.h"
 #include "LayerTreeView.h"
+#include "PointPyramid.h"
 #include "UserInputGMWidget.h"
 #include "VisualizationWidget.h"
 #include "WorkflowAppR2D.h"
 
 // GIS Layers
 #include "FeatureCollectionLayer.h"
+#include "FeatureCollectionTable.h"
 #include "GroupLayer.h"
 #include "Layer.h"
 #include "LayerListModel.h"
@@ -332,29 +334,9 @@ void UserInputGMWidget::loadUserGMData(void)
     tableFields.append(Field::createText("Number of Ground Motions","NULL",4));
     tableFields.append(Field::createText("Ground Motions","",1));
 
-    auto gridFeatureCollection = new FeatureCollection(this);
-
-    // Create the feature collection table/layers
-    auto gridFeatureCollectionTable = new FeatureCollectionTable(tableFields, GeometryType::Point, SpatialReference::wgs84(), this);
-    gridFeatureCollection->tables()->append(gridFeatureCollectionTable);
-
-    auto gridLayer = new FeatureCollectionLayer(gridFeatureCollection,this);
-
-    gridLayer->setName("Ground Motion Grid Points");
-    gridLayer->setAutoFetchLegendInfos(true);
-
-    // Create red cross SimpleMarkerSymbol
-    SimpleMarkerSymbol* crossSymbol = new SimpleMarkerSymbol(SimpleMarkerSymbolStyle::Cross, QColor("black"), 6, this);
-
-    // Create renderer and set symbol to crossSymbol
-    SimpleRenderer* renderer = new SimpleRenderer(crossSymbol, this);
-    renderer->setLabel("Ground motion grid points");
-
-    // Set the renderer for the feature layer
-    gridFeatureCollectionTable->setRenderer(renderer);
-
-    // Set the scale at which the layer will become visible - if scale is too high, then the entire view will be filled with symbols
-    // gridLayer->setMinScale(80000);
+    // The attributes and the coordinates of the grid points, the layer is created from them once they are all read
+    QList<QMap<QString, QVariant>> gridPointsAttributes;
+    std::vector<double> gridPointsCoordinates;
 
     // Pop off the row that contains the header information
     data.pop_front();
@@ -455,12 +437,9 @@ void UserInputGMWidget::loadUserGMData(void)
         featureAttributes.insert("Latitude", latitude);
         featureAttributes.insert("Longitude", longitude);
 
-        // Create the point and add it to the feature table
-        Point point(longitude,latitude);
-        Feature* feature = gridFeatureCollectionTable->createFeature(featureAttributes, point, this);
-
-        gridFeatureCollectionTable->addFeature(feature);
-
+        gridPointsAttributes.append(featureAttributes);
+        gridPointsCoordinates.push_back(longitude);
+        gridPointsCoordinates.push_back(latitude);
 
         ++count;
         progressLabel->clear();
@@ -469,6 +448,58 @@ void UserInputGMWidget::loadUserGMData(void)
         QApplication::processEvents();
     }
 
+    // Dense grids are shown with fewer points when zoomed out
+    PointPyramid gridPyramid;
+    gridPyramid.build(gridPointsCoordinates);
+
+    // The feature of each station in the finest level that has it, for searching by station name
+    QList<Feature*> stationFeatures;
+    QStringList stationNames;
+
+    for(auto&& it : gridPointsAttributes)
+    {
+        stationFeatures.append(nullptr);
+        stationNames.append(it.value("Station Name").toString());
+    }
+
+    auto gridLayer = gridPyramid.createLayer("Ground Motion Grid Points", [&](const PointPyramid::Level& level)
+    {
+        auto gridFeatureCollectionTable = new FeatureCollectionTable(tableFields, GeometryType::Point, SpatialReference::wgs84(), this);
+
+        // Create red cross SimpleMarkerSymbol
+        SimpleMarkerSymbol* crossSymbol = new SimpleMarkerSymbol(SimpleMarkerSymbolStyle::Cross, QColor("black"), 6, this);
+
+        // Create renderer and set symbol to crossSymbol
+        SimpleRenderer* renderer = new SimpleRenderer(crossSymbol, this);
+        renderer->setLabel("Ground motion grid points");
+
+        // Set the renderer for the feature layer
+        gridFeatureCollectionTable->setRenderer(renderer);
+
+        QList<Feature*> features;
+        features.reserve(int(level.points.size()));
+
+        for(auto&& index : level.points)
+        {
+            // Create the point and add it to the feature table
+            Point point(gridPointsCoordinates[2*index],gridPointsCoordinates[2*index+1]);
+            auto feature = gridFeatureCollectionTable->createFeature(gridPointsAttributes.at(index), point, this);
+
+            // The levels are built from the coarsest to the finest
+            stationFeatures[index] = feature;
+
+            features.append(feature);
+        }
+
+        gridFeatureCollectionTable->addFeatures(features);
+
+        return gridFeatureCollectionTable;
+    }, this);
+
+    gridLayer->setAutoFetchLegendInfos(true);
+
+    theVisualizationWidget->addSearchIndex(gridLayer, "Station Name", stationNames, stationFeatures);
+
     // Create a new layer
     auto layersTreeView = theVisualizationWidget->getLayersTree();
 
@@ -38,6 +38,7 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 
 #include "HurricanePreprocessor.h"
 #include "CSVReaderWriter.h"
+#include "CSVRowReader.h"
 #include "LayerTreeView.h"
 #include "UserInputHurricaneWidget.h"
 #include "VisualizationWidget.h"
@@ -327,10 +328,12 @@ void UserInputHurricaneWidget::loadUserWFData(void)
 {
 
     this->statusMessage("Loading wind field data");
-    CSVReaderWriter csvTool;
+
+    // Stream the event grid a row at a time rather than loading the whole file
+    CSVRowReader reader;
 
     QString err;
-    QVector<QStringList> data = csvTool.parseCSVFile(eventFile, err);
+    reader.open(eventFile, err);
 
     if(!err.isEmpty())
     {
@@ -338,16 +341,13 @@ void UserInputHurricaneWidget::loadUserWFData(void)
         return;
     }
 
-    if(data.empty())
-        return;
-
     theStackedWidget->setCurrentWidget(progressBarWidget);
     progressBarWidget->setVisible(true);
 
     QApplication::processEvents();
 
-    //progressBar->setRange(0,inputFiles.size());
-    progressBar->setRange(0, data.count());
+    // The number of rows is not known up front, report the progress as the percentage of the file that has been read
+    progressBar->setRange(0, 100);
 
     progressBar->setValue(0);
 
@@ -385,10 +385,9 @@ void UserInputHurricaneWidget::loadUserWFData(void)
     // Set the scale at which the layer will become visible - if scale is too high, then the entire view will be filled with symbols
     // gridLayer->setMinScale(80000);
 
-    auto headerInfo = data.front();
-
-    auto latIndex = headerInfo.indexOf("Latitude");
-    auto lonIndex = headerInfo.indexOf("Longitude");
+    // Resolve the column indexes once from the header
+    auto latIndex = reader.indexOfColumn("Latitude");
+    auto lonIndex = reader.indexOfColumn("Longitude");
 
     if(latIndex == -1 || lonIndex == -1)
     {
@@ -396,25 +395,18 @@ void UserInputHurricaneWidget::loadUserWFData(void)
         return;
     }
 
-    // Pop off the row that contains the header information
-    data.pop_front();
-
-    auto numRows = data.size();
-
-    int count = 0;
+    auto fileSize = qMax(reader.getFileSize(), qint64(1));
 
     // Get the data
-    for(int i = 0; i<numRows; ++i)
+    while(reader.readRow(err))
     {
-        auto rowStr = data.at(i);
-
-        auto stationName = rowStr[0];
+        auto stationName = reader.at(0).toString();
 
         // Path to station files, e.g., site0.csv
         auto stationPath = eventDir + QDir::separator() + stationName;
 
         bool ok;
-        auto longitude = rowStr[lonIndex].toDouble(&ok);
+        auto longitude = reader.at(lonIndex).toDouble(&ok);
 
         if(!ok)
         {
@@ -427,7 +419,7 @@ void UserInputHurricaneWidget::loadUserWFData(void)
             return;
         }
 
-        auto latitude = rowStr[latIndex].toDouble(&ok);
+        auto latitude = reader.at(latIndex).toDouble(&ok);
 
         if(!ok)
         {
@@ -501,13 +493,22 @@ void UserInputHurricaneWidget::loadUserWFData(void)
         gridFeatureCollectionTable->addFeature(feature);
         WFStation.setStationFeature(feature);
 
-        ++count;
         progressLabel->clear();
-        progressBar->setValue(count);
+        progressBar->setValue(static_cast<int>(100*reader.getBytesRead()/fileSize));
 
         QApplication::processEvents();
     }
 
+    if(!err.isEmpty())
+    {
+        this->errorMessage(err);
+
+        theStackedWidget->setCurrentWidget(fileInputWidget);
+        progressBarWidget->setVisible(false);
+
+        return;
+    }
+
     // Create a new layer
     auto layersTreeView = theVisualizationWidget->getLayersTree();
 
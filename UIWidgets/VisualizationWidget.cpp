@@ -37,6 +37,7 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 // Written by: Stevan Gavrilovic, Frank McKenna
 
 #include "ComponentInputWidget.h"
+#include "PopUpTableModel.h"
 #include "PopUpWidget.h"
 #include "SimCenterMapGraphicsView.h"
 #include "LayerTreeItem.h"
@@ -44,6 +45,7 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 #include "LayerTreeModel.h"
 #include "VisualizationWidget.h"
 #include "ConvexHull.h"
+#include "GeoJsonReader.h"
 #include "PolygonBoundary.h"
 #include "LayerManagerDialog.h"
 
@@ -75,12 +77,14 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 #include "PictureMarkerSymbolLayer.h"
 #include "PolylineBuilder.h"
 #include "PopupManager.h"
+#include "QueryParameters.h"
 #include "RasterLayer.h"
 #include "PolygonBuilder.h"
 #include "ShapefileFeatureTable.h"
 #include "SimpleMarkerSymbol.h"
 #include "SimpleRenderer.h"
 #include "TransformationCatalog.h"
+#include "UniqueValueRenderer.h"
 #include "sectiontitle.h"
 // Convex Hull
 #include "GeometryEngine.h"
@@ -95,22 +99,70 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 #include <QJsonArray>
 #include <QGridLayout>
 #include <QGroupBox>
+#include <QHash>
 #include <QToolButton>
-#include <QHeaderView>
 #include <QSplitter>
 #include <QLabel>
+#include <QLineEdit>
 #include <QPushButton>
+#include <QSet>
 #include <QString>
-#include <QTableWidget>
 #include <QThread>
 #include <QTreeView>
 #include <QListView>
 #include <QUrl>
 
+#include <algorithm>
 #include <utility>
 
 using namespace Esri::ArcGISRuntime;
 
+namespace
+{
+
+// Builds a polyline or polygon from the flat coordinates of a geojson feature, each line or ring becomes a part of the geometry
+// Returns an empty geometry if any part has fewer than minPoints points
+template <typename Builder>
+Geometry getMultipartGeometryFromGeoJson(const GeoJsonFeature& feature, const int minPoints)
+{
+    const int numParts = feature.numberOfParts();
+
+    if(numParts == 0)
+        return Geometry();
+
+    // Owns the parts until the geometry is built
+    QObject partsOwner;
+
+    Builder theMultiPartBuilder(SpatialReference::wgs84());
+
+    PartCollection* pCollection = new PartCollection(theMultiPartBuilder.spatialReference(), &partsOwner);
+
+    for(int i = 0; i<numParts; ++i)
+    {
+        const int first = feature.partStarts[i];
+        const int last = feature.partStarts[i+1];
+
+        if(last - first < minPoints)
+            return Geometry();
+
+        Part* newPart = new Part(theMultiPartBuilder.spatialReference(), &partsOwner);
+
+        for(int j = first; j<last; ++j)
+            newPart->addPoint(feature.coordinates[2*j], feature.coordinates[2*j+1]);
+
+        pCollection->addPart(newPart);
+    }
+
+    theMultiPartBuilder.setParts(pCollection);
+
+    if(!theMultiPartBuilder.isSketchValid())
+        return Geometry();
+
+    return theMultiPartBuilder.toGeometry();
+}
+
+}
+
 
 VisualizationWidget::VisualizationWidget(QWidget* parent) : SimCenterAppWidget(parent)
 {    
@@ -284,6 +336,29 @@ void VisualizationWidget::createVisualizationWidget(void)
     // The tree view class used to visualize the tree data model
     layersTree = new LayerTreeView(visWidget, this);
 
+    QLabel* searchText = new QLabel(visWidget);
+    searchText->setText("Search by attribute:");
+
+    searchFieldCombo = new QComboBox();
+    searchFieldCombo->setEditable(true);
+    searchFieldCombo->addItem("ID");
+    searchFieldCombo->addItem("UID");
+
+    for(auto&& it : layerSearchIndexes)
+    {
+        if(searchFieldCombo->findText(it.fieldName) == -1)
+            searchFieldCombo->addItem(it.fieldName);
+    }
+
+    searchLineEdit = new QLineEdit();
+    searchLineEdit->setPlaceholderText("Start typing to search");
+    searchLineEdit->setClearButtonEnabled(true);
+
+    searchResultsLabel = new QLabel(visWidget);
+
+    connect(searchFieldCombo, &QComboBox::currentTextChanged, this, &VisualizationWidget::handleSearchTextChanged);
+    connect(searchLineEdit, &QLineEdit::textChanged, this, &VisualizationWidget::handleSearchTextChanged);
+
     QLabel* topText = new QLabel(visWidget);
     topText->setText("Enclose an area with points\nto select a subset of\nassets to analyze");
     topText->setStyleSheet("font-weight: bold; color: black; text-align: center");
@@ -317,12 +392,16 @@ void VisualizationWidget::createVisualizationWidget(void)
     leftHandLayout->addWidget(baseMapCombo,2,0);
     leftHandLayout->addItem(smallVSpacer,3,0);
     leftHandLayout->addWidget(layersTree,4,0);
-    leftHandLayout->addWidget(topText,5,0);
-    leftHandLayout->addWidget(selectPointsButton,6,0);
-    leftHandLayout->addWidget(clearButton,7,0);
-    leftHandLayout->addWidget(bottomText,8,0);
-    leftHandLayout->addWidget(applyButton,9,0);
-    leftHandLayout->addItem(vspacer,10,0);
+    leftHandLayout->addWidget(searchText,5,0);
+    leftHandLayout->addWidget(searchFieldCombo,6,0);
+    leftHandLayout->addWidget(searchLineEdit,7,0);
+    leftHandLayout->addWidget(searchResultsLabel,8,0);
+    leftHandLayout->addWidget(topText,9,0);
+    leftHandLayout->addWidget(selectPointsButton,10,0);
+    leftHandLayout->addWidget(clearButton,11,0);
+    leftHandLayout->addWidget(bottomText,12,0);
+    leftHandLayout->addWidget(applyButton,13,0);
+    leftHandLayout->addItem(vspacer,14,0);
 
     QWidget* subWidget = new QWidget(this);
     subWidget->setContentsMargins(0,0,0,0);
@@ -410,6 +489,151 @@ void VisualizationWidget::selectFeaturesForAnalysisQueryCompleted(QUuid taskID,
 }
 
 
+void VisualizationWidget::selectFeaturesInGeometry(const Esri::ArcGISRuntime::Geometry& geometry)
+{
+    selectionGeometry = geometry;
+
+    QueryParameters queryParams;
+    queryParams.setGeometry(geometry);
+    queryParams.setSpatialRelationship(SpatialRelationship::Contains);
+
+    // The layers of the components are not queried
+    QSet<Layer*> componentLayers;
+    for(auto&& it : componentWidgetsMap)
+    {
+        auto componentLayer = it->getComponentLayer();
+
+        if(componentLayer != nullptr)
+            componentLayers.insert(componentLayer);
+    }
+
+    // Function to do a nested search through the layers - this is needed because some layers may have sub-layers
+    std::function<void(const LayerListModel*)> layerIterator = [&](const LayerListModel* layers)
+    {
+        for(int i = 0; i<layers->size(); ++i)
+        {
+            auto layer = layers->at(i);
+
+            // Continue if the layer is turned off
+            if(!layer->isVisible() || componentLayers.contains(layer))
+                continue;
+
+            if(auto featureCollectLayer = dynamic_cast<FeatureCollectionLayer*>(layer))
+            {
+                auto tables = featureCollectLayer->featureCollection()->tables();
+
+                for(int j = 0; j<tables->size(); ++j)
+                {
+                    auto table = tables->at(j);
+
+                    // Make this a unique, i.e., one-off connection so that it does not call the slot multiple times
+                    connect(table, &FeatureTable::queryFeaturesCompleted, this, &VisualizationWidget::selectFeaturesForAnalysisQueryCompleted, Qt::UniqueConnection);
+
+                    // Query the table for features - note that this is done asynchronously
+                    auto taskWatcher = table->queryFeatures(queryParams);
+
+                    if (!taskWatcher.isValid())
+                        qDebug() <<"Error, task not valid in "<<__FUNCTION__;
+                    else
+                        taskIDMap[taskWatcher.taskId()] = taskWatcher.description();
+                }
+            }
+            else if(auto isGroupLayer = dynamic_cast<GroupLayer*>(layer))
+            {
+                auto subLayers = isGroupLayer->layers();
+                layerIterator(subLayers);
+            }
+        }
+    };
+
+    layerIterator(mapGIS->operationalLayers());
+
+    // If there is nothing to wait for the selection is complete
+    if(taskIDMap.isEmpty())
+        emit taskSelectionComplete();
+}
+
+
+void VisualizationWidget::selectComponentsInGeometry(const Esri::ArcGISRuntime::Geometry& geometry)
+{
+    if(geometry.isEmpty())
+        return;
+
+    // The component geometries are in WGS84. The selection is densified before it is projected so that its edges stay close to where they
+    // were drawn, and the components on the edges are checked against the selection itself
+    auto extent = geometry.extent();
+    auto maxSegmentLength = qMax(extent.width(), extent.height())/32.0;
+
+    auto densifiedGeometry = maxSegmentLength > 0.0 ? GeometryEngine::densify(geometry, maxSegmentLength) : geometry;
+
+    Polygon selectionPolygon(GeometryEngine::project(densifiedGeometry, SpatialReference::wgs84()));
+
+    std::vector<double> coordinates;
+    std::vector<int> partStarts;
+
+    auto parts = selectionPolygon.parts();
+
+    for(int i = 0; i<parts.size(); ++i)
+    {
+        auto part = parts.part(i);
+
+        partStarts.push_back(int(coordinates.size()/2));
+
+        for(int j = 0; j<part.pointCount(); ++j)
+        {
+            auto point = part.point(j);
+
+            coordinates.push_back(point.x());
+            coordinates.push_back(point.y());
+        }
+    }
+
+    if(coordinates.empty())
+        return;
+
+    partStarts.push_back(int(coordinates.size()/2));
+
+    // A widget can be registered under more than one asset type
+    QSet<ComponentInputWidget*> searchedWidgets;
+
+    for(auto&& componentWidget : componentWidgetsMap)
+    {
+        if(searchedWidgets.contains(componentWidget))
+            continue;
+
+        searchedWidgets.insert(componentWidget);
+
+        auto componentLayer = componentWidget->getComponentLayer();
+
+        if(componentLayer == nullptr || !componentLayer->isVisible())
+            continue;
+
+        auto componentDb = componentWidget->getComponentDatabase();
+
+        IntervalSet selectedIDs;
+        std::vector<int> boundaryRows;
+
+        componentDb->getComponentsInPolygon(coordinates, partStarts, selectedIDs, boundaryRows);
+
+        for(auto&& row : boundaryRows)
+        {
+            auto feature = componentDb->getFeature(row);
+
+            if(feature == nullptr)
+                continue;
+
+            auto featureGeometry = GeometryEngine::project(feature->geometry(), geometry.spatialReference());
+
+            if(GeometryEngine::contains(geometry, featureGeometry))
+                selectedIDs.insert(componentDb->getID(row));
+        }
+
+        if(!selectedIDs.isEmpty())
+            componentWidget->insertSelectedComponents(selectedIDs);
+    }
+}
+
+
 void VisualizationWidget::setLayerVisibility(const QString& layerID, const bool val)
 {
     auto layerItem = layersTree->getTreeItem(layerID);
@@ -609,6 +833,35 @@ void VisualizationWidget::handleFieldQuerySelection(void)
 }
 
 
+void VisualizationWidget::handleSearchTextChanged(void)
+{
+    this->clearSelection();
+
+    const auto searchText = searchLineEdit->text().trimmed();
+
+    if(searchText.isEmpty())
+    {
+        searchResultsLabel->clear();
+        return;
+    }
+
+    // Only the in-memory indexes are searched as the text is typed, so the results come back right away
+    const int maxResults = 1000;
+
+    auto foundFeatures = this->runFieldQuery(searchFieldCombo->currentText(), searchText, maxResults, false);
+
+    for(auto&& feature : foundFeatures)
+        selectedFeaturesList.append(new Feature(feature->getImpl(), this));
+
+    this->handleSelectFeatures();
+
+    if(foundFeatures.size() >= maxResults)
+        searchResultsLabel->setText("Showing the first " + QString::number(maxResults) + " matches");
+    else
+        searchResultsLabel->setText(QString::number(foundFeatures.size()) + " matches");
+}
+
+
 void VisualizationWidget::handleArcGISError(Esri::ArcGISRuntime::Error error)
 {
     if(error.isEmpty())
@@ -634,6 +887,10 @@ void VisualizationWidget::handleClearSelectAreaMap(void)
 
 void VisualizationWidget::handleSelectFeaturesForAnalysis(void)
 {
+    // The components come from the spatial indexes, the query results are from the other layers
+    this->selectComponentsInGeometry(selectionGeometry);
+
+    selectionGeometry = Geometry();
 
     for(auto&& it : featuresFromQueryList)
     {
@@ -712,55 +969,34 @@ QWidget *VisualizationWidget::getVisWidget()
 // Pop-up stuff
 void VisualizationWidget::identifyLayersCompleted(QUuid taskID, const QList<IdentifyLayerResult*>& results)
 {
-    int count = 0;
-
     this->clearSelection();
 
-    QVector<std::pair<GeoElement*,QString>> elemList;
-
-    // lambda for calculating result count
-    auto geoElementsCountFromResult = [&] (IdentifyLayerResult* result) -> int
-    {
-        auto layerName = result->layerContent()->name();
+    // The model only reads the attributes of the element that is being viewed
+    PopUpTableModel popUpModel(nullptr);
 
-        // create temp list
-        QList<IdentifyLayerResult*> tempResults{result};
+    QVector<GeoElement*> elemList;
 
-        // use Depth First Search approach to handle recursion
-        int count = 0;
-        int index = 0;
+    // Adds the elements of the result and of its sublayer results, in depth first order
+    std::function<void(IdentifyLayerResult*, const QString&)> addElementsFromResult = [&](IdentifyLayerResult* result, const QString& layerName)
+    {
+        auto elems = result->geoElements();
 
-        while (index < tempResults.length())
+        for(auto&& it : elems)
         {
-            //get the result object from the array
-            IdentifyLayerResult* identifyResult = tempResults[index];
-
-            // update count with geoElements from the result
-            auto elems = identifyResult->geoElements();
-
-            for(auto&& it : elems)
-                elemList.append(std::make_pair(it,layerName));
+            elemList.append(it);
+            popUpModel.addElement(it,layerName);
+        }
 
-            count += elems.length();
+        auto sublayerResults = result->sublayerResults();
 
-            // check if the result has any sublayer results
-            // if yes then add those result objects in the tempResults
-            // array after the current result
-            if (identifyResult->sublayerResults().length() > 0)
-            {
-                tempResults.append(identifyResult->sublayerResults().at(index));
-            }
-
-            // update the count and repeat
-            index += 1;
-        }
-        return count;
+        for(auto&& it : sublayerResults)
+            addElementsFromResult(it,layerName);
     };
 
     for (IdentifyLayerResult* result : results)
-        count += geoElementsCountFromResult(result);
+        addElementsFromResult(result, result->layerContent()->name());
 
-    if(count == 0)
+    if(elemList.isEmpty())
     {
         qDeleteAll(results);
         taskIDMap.remove(taskID);
@@ -769,80 +1005,32 @@ void VisualizationWidget::identifyLayersCompleted(QUuid taskID, const QList<Iden
 
     std::unique_ptr<PopUpWidget> popUp = std::make_unique<PopUpWidget>(this);
 
-    for(auto&& it : elemList)
+    // Only the features on the page that is shown are highlighted
+    connect(popUp.get(), &PopUpWidget::pageChanged, this, [&](int firstElement, int numElements)
     {
-        auto geomElem = it.first;
-
-        // cast the GeoElement to a Feature
-        Feature* feature = static_cast<Feature*>(geomElem);
+        this->clearSelection();
 
-        if(feature)
+        for(int i = firstElement; i<firstElement + numElements; ++i)
         {
-            auto feature2 = new Feature(feature->getImpl(),this);
-            selectedFeaturesList.append(feature2);
-        }
-
-        auto elemAttrib = geomElem->attributes();
-
-        auto listOfAttributes = elemAttrib->attributeNames();
-
-        QStringList attrbKeyList;
-        QStringList attrbValList;
-
-        for(auto&& atrb : listOfAttributes)
-        {
-            if(QString::compare(atrb,"ObjectID") == 0 || QString::compare(atrb,"AssetType") == 0 || QString::compare(atrb,"TabName") == 0)
-                continue;
-
-            auto atrbVal = elemAttrib->attributeValue(atrb).toString();
-
-            // Do not list empty attributes in the popup
-            if(atrbVal.isEmpty())
-                continue;
-
-            attrbKeyList.append(atrb);
-
+            // cast the GeoElement to a Feature
+            Feature* feature = static_cast<Feature*>(elemList.at(i));
 
-            attrbValList.append(atrbVal);
-        }
-
-        // Create a table to display the attributes of this element
-        auto attributeTableWidget = new QTableWidget();
-        attributeTableWidget->verticalHeader()->setSectionResizeMode(QHeaderView::Stretch);
-        attributeTableWidget->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
-        attributeTableWidget->horizontalHeader()->hide();
-        attributeTableWidget->setEditTriggers(QAbstractItemView::NoEditTriggers);
-
-        auto numRows = attrbValList.size();
-
-        attributeTableWidget->setColumnCount(1);
-        attributeTableWidget->setRowCount(numRows);
-
-        attributeTableWidget->setVerticalHeaderLabels(attrbKeyList);
-
-        for(int i = 0; i<numRows; ++i)
-        {
-            auto item = new QTableWidgetItem(attrbValList[i]);
-
-            attributeTableWidget->setItem(i,0, item);
-        }
-
-        QString label = elemAttrib->attributeValue("TabName").toString();
-
-        // If the label is empty, append the layer name
-        if(label.isEmpty())
-        {
-            label = it.second;
+            if(feature)
+            {
+                auto feature2 = new Feature(feature->getImpl(),this);
+                selectedFeaturesList.append(feature2);
+            }
         }
 
-        popUp->addTab(attributeTableWidget,label);
-    }
+        this->handleSelectFeatures();
+    });
 
-    // If got this far then some features were selected
-    this->handleSelectFeatures();
+    popUp->setModel(&popUpModel);
 
     popUp->exec();
 
+    popUp.reset();
+
     // Delete the results
     qDeleteAll(results);
     taskIDMap.remove(taskID);
@@ -930,8 +1118,104 @@ void VisualizationWidget::handleAsyncLayerLoad(Esri::ArcGISRuntime::Error layerL
 }
 
 
-void VisualizationWidget::runFieldQuery(const QString& fieldName, const QString& searchText)
+void VisualizationWidget::addSearchIndex(Esri::ArcGISRuntime::Layer* layer, const QString& fieldName, const QStringList& values, const QList<Esri::ArcGISRuntime::Feature*>& features)
+{
+    if(layer == nullptr || values.size() != features.size())
+        return;
+
+    // Drop the indexes of the layers that were deleted
+    layerSearchIndexes.erase(std::remove_if(layerSearchIndexes.begin(), layerSearchIndexes.end(), [](const LayerSearchIndex& searchIndex)
+    {
+        return searchIndex.layer.isNull();
+    }), layerSearchIndexes.end());
+
+    LayerSearchIndex searchIndex;
+    searchIndex.layer = layer;
+    searchIndex.fieldName = fieldName;
+    searchIndex.features = features;
+
+    for(int i = 0; i<values.size(); ++i)
+    {
+        if(features.at(i) != nullptr)
+            searchIndex.index.addValue(values.at(i), i);
+    }
+
+    searchIndex.index.build();
+
+    layerSearchIndexes.push_back(std::move(searchIndex));
+
+    if(searchFieldCombo != nullptr && searchFieldCombo->findText(fieldName) == -1)
+        searchFieldCombo->addItem(fieldName);
+}
+
+
+QList<Esri::ArcGISRuntime::Feature*> VisualizationWidget::runFieldQuery(const QString& fieldName, const QString& searchText, const int maxResults, const bool queryOtherLayers)
 {
+    QList<Feature*> foundFeatures;
+
+    // The layers that are searched in memory are not queried
+    QSet<Layer*> searchedLayers;
+
+    // Search the components in their databases
+    QSet<ComponentInputWidget*> searchedWidgets;
+
+    for(auto&& componentWidget : componentWidgetsMap)
+    {
+        if(searchedWidgets.contains(componentWidget))
+            continue;
+
+        searchedWidgets.insert(componentWidget);
+
+        auto componentLayer = componentWidget->getComponentLayer();
+
+        if(componentLayer == nullptr)
+            continue;
+
+        searchedLayers.insert(componentLayer);
+
+        if(!componentLayer->isVisible() || foundFeatures.size() >= maxResults)
+            continue;
+
+        std::vector<int> rows;
+
+        auto componentDb = componentWidget->getComponentDatabase();
+
+        componentDb->findComponents(fieldName, searchText, rows, maxResults - foundFeatures.size());
+
+        for(auto&& row : rows)
+        {
+            auto feature = componentDb->getFeature(row);
+
+            if(feature != nullptr)
+                foundFeatures.append(feature);
+        }
+    }
+
+    // Then the layers that have a search index of the field
+    for(auto&& it : layerSearchIndexes)
+    {
+        if(it.layer.isNull() || it.fieldName != fieldName)
+            continue;
+
+        searchedLayers.insert(it.layer);
+
+        if(!it.layer->isVisible())
+            continue;
+
+        it.index.search(searchText, [&](int item)
+        {
+            if(foundFeatures.size() >= maxResults)
+                return false;
+
+            foundFeatures.append(it.features.at(item));
+
+            return true;
+        });
+    }
+
+    if(!queryOtherLayers)
+        return foundFeatures;
+
     // create a query parameter object and set the where clause
     QueryParameters queryParams;
 
@@ -948,8 +1232,8 @@ void VisualizationWidget::runFieldQuery(const QString& fieldName, const QString&
         {
             auto layer = layers->at(i);
 
-            // Continue if the layer is turned off
-            if(!layer->isVisible())
+            // Continue if the layer is turned off or if it was already searched
+            if(!layer->isVisible() || searchedLayers.contains(layer))
                 continue;
 
             if(auto featureCollectLayer = dynamic_cast<FeatureCollectionLayer*>(layer))
@@ -969,7 +1253,7 @@ void VisualizationWidget::runFieldQuery(const QString& fieldName, const QString&
                     if (!taskWatcher.isValid())
                         qDebug() <<"Error, task not valid in "<<__FUNCTION__;
                     else
-                        taskIDMap[taskWatcher.taskId()] = taskIDMap[taskWatcher.taskId()] = taskWatcher.description();
+                        taskIDMap[taskWatcher.taskId()] = taskWatcher.description();
                 }
             }
             else if(auto isGroupLayer = dynamic_cast<GroupLayer*>(layer))
@@ -985,6 +1269,7 @@ void VisualizationWidget::runFieldQuery(const QString& fieldName, const QString&
 
     layerIterator(layersList);
 
+    return foundFeatures;
 }
 
 
@@ -1220,11 +1505,9 @@ RasterLayer* VisualizationWidget::createAndAddRasterLayer(const QString& filePat
     });
 
     layer->setName(layerName);
-    auto layerID = this->createUniqueID();
-    layer->setLayerId(layerID);
 
-    // Add the layers to the layer tree
-    layersTree->addItemToTree(layerName,layerID,parentItem);
+    // Add the layer to the map and to the layer tree
+    this->addLayerToMap(layer, parentItem);
 
     return layer;
 }
@@ -1265,62 +1548,105 @@ FeatureLayer* VisualizationWidget::createAndAddShapefileLayer(const QString& fil
 
 Esri::ArcGISRuntime::FeatureCollectionLayer* VisualizationWidget::createAndAddJsonLayer(const QString& filePath, const QString& layerName, LayerTreeItem* parentItem, QColor color)
 {
-    QFile file(filePath);
+    // The features that have the same type of geometry and the same property names go into one table
+    struct FeatureGroup
+    {
+        QString geometryType;
+        QStringList propertyNames;
+        QList<QMap<QString, QVariant>> featuresAttributes;
+        QList<Geometry> geometries;
+    };
 
-    // Check if something at that path exists and cheack that it really is a file and not a directory
-    if (!file.open(QFile::ReadOnly | QFile::Text))
+    QList<FeatureGroup> featureGroups;
+    QHash<QString, int> groupIndexes;
+
+    // Stream the features out of the file, a compressed file is decompressed on a background thread as it is read
+    QString err;
+    auto res = GeoJsonReader::readFile(filePath, [&](GeoJsonFeature& feature, QString& featureErr)
     {
-        QString msg = QString("Cannot open the file:") + filePath;
-        this->errorMessage(msg);
-        return nullptr;
-    }
+        const auto& jsonType = feature.geometryType;
 
-    // Place contents of file into json object
-    QString val;
-    val=file.readAll();
-    QJsonDocument doc = QJsonDocument::fromJson(val.toUtf8());
-    QJsonObject jsonObj = doc.object();
+        // Single line strings and polygons are read as multi-part geometries with one part
+        QString type;
+        Geometry featGeom;
+        if(jsonType.compare("MultiLineString") == 0 || jsonType.compare("LineString") == 0)
+        {
+            type = "MultiLineString";
+            featGeom = this->getPolylineGeometryFromGeoJson(feature);
+        }
+        else if (jsonType.compare("MultiPolygon") == 0 || jsonType.compare("Polygon") == 0)
+        {
+            type = "MultiPolygon";
+            featGeom = this->getPolygonGeometryFromGeoJson(feature);
+        }
+        else
+        {
+            featureErr ="Error, the import of the type of geometry "+jsonType+" is not yet suppported for " + filePath;
+            return -1;
+        }
 
-    // Extract the features
-    auto featureArray = jsonObj["features"].toArray();
+        if(featGeom.isEmpty())
+        {
+            featureErr ="Error getting the feature geometry for " + layerName;
+            return -1;
+        }
 
-    auto numFeat = featureArray.size();
+        // The fields of the table are text, so the properties are stored as text
+        QMap<QString, QVariant> featureAttributes;
+        featureAttributes.insert("AssetType", "USER_GEOJSON");
+        featureAttributes.insert("TabName", layerName);
 
-    if(numFeat == 0)
-    {
-        QString msg = "Could find any features in: " + filePath;
-        this->errorMessage(msg);
-        return nullptr;
-    }
+        for(auto prop = feature.properties.constBegin(); prop != feature.properties.constEnd(); ++prop)
+            featureAttributes.insert(prop.key(), prop.value().toString());
 
-    auto featureCollection = new FeatureCollection(this);
+        // The keys of the properties map are sorted, so features with the same properties have the same list of keys
+        auto propertyNames = feature.properties.keys();
+        auto groupKey = type + ":" + propertyNames.join(',');
 
-    for(auto&& it : featureArray)
-    {
-        auto featObj = it.toObject();
+        auto groupIt = groupIndexes.constFind(groupKey);
 
-        auto geom = featObj["geometry"].toObject();
+        int groupIndex = 0;
+        if(groupIt == groupIndexes.constEnd())
+        {
+            groupIndex = featureGroups.size();
+            groupIndexes.insert(groupKey, groupIndex);
 
-        auto type = geom["type"].toString();
+            FeatureGroup newGroup;
+            newGroup.geometryType = type;
+            newGroup.propertyNames = propertyNames;
 
-        FeatureCollectionTable* featureCollectionTable = nullptr;
-        if(type.compare("MultiLineString") == 0)
-            featureCollectionTable = this->getMultilineFeatureTable(geom,featObj,layerName, color);
-        else if (type.compare("MultiPolygon") == 0)
-            featureCollectionTable = this->getMultipolygonFeatureTable(geom,featObj,layerName, color);
+            featureGroups.append(newGroup);
+        }
         else
         {
-            QString msg ="Error, the import of the type of geometry "+type+" is not yet suppported for " + filePath;
-            this->errorMessage(msg);
-            delete featureCollection;
-            return nullptr;
+            groupIndex = groupIt.value();
         }
 
-        if(featureCollectionTable == nullptr)
-        {
-            delete featureCollection;
-            return nullptr;
-        }
+        featureGroups[groupIndex].featuresAttributes.append(featureAttributes);
+        featureGroups[groupIndex].geometries.append(featGeom);
+
+        return 0;
+    }, err);
+
+    if(res != 0)
+    {
+        QString msg = "Error importing the file: " + filePath + "\n" + err;
+        this->errorMessage(msg);
+        return nullptr;
+    }
+
+    if(featureGroups.isEmpty())
+    {
+        QString msg = "Could find any features in: " + filePath;
+        this->errorMessage(msg);
+        return nullptr;
+    }
+
+    auto featureCollection = new FeatureCollection(this);
+
+    for(auto&& group : featureGroups)
+    {
+        auto featureCollectionTable = this->createJsonFeatureTable(group.geometryType, group.propertyNames, group.featuresAttributes, group.geometries, layerName, color);
 
         featureCollection->tables()->append(featureCollectionTable);
     }
@@ -1527,6 +1853,12 @@ bool VisualizationWidget::removeLayerFromMap(Esri::ArcGISRuntime::Layer* layer)
     if(layer == nullptr)
         return false;
 
+    // Drop the search indexes of the layer
+    layerSearchIndexes.erase(std::remove_if(layerSearchIndexes.begin(), layerSearchIndexes.end(), [&](const LayerSearchIndex& searchIndex)
+    {
+        return searchIndex.layer.isNull() || searchIndex.layer == layer;
+    }), layerSearchIndexes.end());
+
     auto mapLayers = mapGIS->operationalLayers();
 
     auto hasLayer = mapLayers->contains(layer);
@@ -1627,6 +1959,11 @@ void VisualizationWidget::clear(void)
 
     featuresFromQueryList.clear();
 
+    layerSearchIndexes.clear();
+
+    if(searchLineEdit != nullptr)
+        searchLineEdit->clear();
+
     mapGIS->operationalLayers()->clear();
 
     delete selectedObjectsLayer;
@@ -1971,6 +2308,18 @@ Esri::ArcGISRuntime::Geometry VisualizationWidget::getMultiPolygonGeometryFromJs
 }
 
 
+Esri::ArcGISRuntime::Geometry VisualizationWidget::getPolylineGeometryFromGeoJson(const GeoJsonFeature& feature)
+{
+    return getMultipartGeometryFromGeoJson<PolylineBuilder>(feature, 2);
+}
+
+
+Esri::ArcGISRuntime::Geometry VisualizationWidget::getPolygonGeometryFromGeoJson(const GeoJsonFeature& feature)
+{
+    return getMultipartGeometryFromGeoJson<PolygonBuilder>(feature, 1);
+}
+
+
 Esri::ArcGISRuntime::Geometry VisualizationWidget::getRectGeometryFromPoint(const Esri::ArcGISRuntime::Point& pnt, const double sizeX, double sizeY)
 {
 
@@ -2064,145 +2413,99 @@ void VisualizationWidget::setViewElevation(double val)
 }
 
 
-Esri::ArcGISRuntime::FeatureCollectionTable* VisualizationWidget::getMultilineFeatureTable(const QJsonObject& geomObject, const QJsonObject& featObj, const QString& layerName, const QColor color)
+Esri::ArcGISRuntime::FeatureCollectionTable* VisualizationWidget::createJsonFeatureTable(const QString& geometryType, const QStringList& propertyNames, const QList<QMap<QString, QVariant>>& featuresAttributes, const QList<Esri::ArcGISRuntime::Geometry>& geometries, const QString& layerName, const QColor color)
 {
-    auto coordArray = geomObject["coordinates"].toArray();
-
-    Esri::ArcGISRuntime::Geometry featGeom = this->getMultilineStringGeometryFromJson(coordArray);
-
-    if(featGeom.isEmpty())
-    {
-        QString msg ="Error getting the feature geometry for " + layerName;
-        this->errorMessage(msg);
-        return nullptr;
-    }
-
-    auto properties = featObj["properties"].toObject();
-
-    QMap<QString, QVariant> featureAttributes;
-    featureAttributes.insert("AssetType", "USER_GEOJSON");
-    featureAttributes.insert("TabName", layerName);
-
-    auto propertiesMap = properties.toVariantMap();
-
-    featureAttributes.insert(propertiesMap);
+    const bool isLine = geometryType.compare("MultiLineString") == 0;
 
     QList<Field> tableFields;
     tableFields.append(Field::createText("AssetType", "NULL",4));
     tableFields.append(Field::createText("TabName", "NULL",4));
 
-    // Use the property map from the first object to populate the fields.
-    auto keys = propertiesMap.keys();
-    for(auto&& it : keys)
+    for(auto&& it : propertyNames)
         tableFields.append(Field::createText(it, "NULL",4));
 
-    auto featureCollectionTable = new FeatureCollectionTable(tableFields, GeometryType::Polyline, SpatialReference::wgs84(),this);
-
-    // Try to get the color if there is one
-    auto colorStr =  properties["color"].toString();
-
-    QColor featureColor;
-
-    if(color.alpha() == 0)
-        featureColor = QColor(rand() % 255,rand() % 255,rand() % 255);
-    else
-        featureColor = color;
-
-    if(!colorStr.isEmpty())
-        featureColor = QColor(colorStr);
-
-    auto weight = properties["weight"].toDouble(3.0);
-
-    auto legendLabel = layerName;
-
-    QVariant valueVar = properties["value"].toVariant();
-
-    if(!valueVar.toString().isEmpty())
-        legendLabel = valueVar.toString();
-    else if(properties["value"].toDouble(-1.0) == -1.0)
-        legendLabel = QString::number(valueVar.toDouble());
-
-    if(legendLabel.isEmpty())
-        legendLabel = layerName;
-
-    SimpleLineSymbol* lineSymbol = new SimpleLineSymbol(SimpleLineSymbolStyle::Solid, featureColor, weight, this);
-    SimpleRenderer* lineRenderer = new SimpleRenderer(lineSymbol, this);
-    lineRenderer->setLabel(legendLabel);
-
-    featureCollectionTable->setRenderer(lineRenderer);
+    auto featureCollectionTable = new FeatureCollectionTable(tableFields, isLine ? GeometryType::Polyline : GeometryType::Polygon, SpatialReference::wgs84(),this);
 
-    auto feature = featureCollectionTable->createFeature(featureAttributes, featGeom, this);
+    // Lines get a random color if none is given, polygons are black by default
+    auto getSymbol = [&](const QString& colorStr, const double weight) -> Symbol*
+    {
+        QColor featureColor = color;
 
-    featureCollectionTable->addFeature(feature);
+        if(isLine && color.alpha() == 0)
+            featureColor = QColor(rand() % 255,rand() % 255,rand() % 255);
 
-    return featureCollectionTable;
-}
+        if(!colorStr.isEmpty())
+            featureColor = QColor(colorStr);
 
+        if(isLine)
+            return new SimpleLineSymbol(SimpleLineSymbolStyle::Solid, featureColor, weight, this);
 
-Esri::ArcGISRuntime::FeatureCollectionTable* VisualizationWidget::getMultipolygonFeatureTable(const QJsonObject& geomObject, const QJsonObject& featObj, const QString& layerName, const QColor color)
-{
-    auto coordArray = geomObject["coordinates"].toArray();
+        return new SimpleFillSymbol(SimpleFillSymbolStyle::Solid, featureColor, this);
+    };
 
-    Esri::ArcGISRuntime::Geometry featGeom = this->getMultiPolygonGeometryFromJson(coordArray);
+    // The features are styled by their color and value properties, with one symbol for each distinct pair rather than one renderer per feature
+    QStringList styleFields;
+    if(propertyNames.contains("color"))
+        styleFields.append("color");
+    if(propertyNames.contains("value"))
+        styleFields.append("value");
 
-    if(featGeom.isEmpty())
+    if(styleFields.isEmpty())
     {
-        QString msg ="Error getting the feature geometry for " + layerName;
-        this->errorMessage(msg);
-        return nullptr;
-    }
+        auto weight = featuresAttributes.first().value("weight").toDouble();
 
-    auto properties = featObj["properties"].toObject();
+        auto renderer = new SimpleRenderer(getSymbol(QString(), weight > 0.0 ? weight : 3.0), this);
+        renderer->setLabel(layerName);
 
-    QMap<QString, QVariant> featureAttributes;
-    featureAttributes.insert("AssetType", "USER_GEOJSON");
-    featureAttributes.insert("TabName", layerName);
-
-    auto propertiesMap = properties.toVariantMap();
+        featureCollectionTable->setRenderer(renderer);
+    }
+    else
+    {
+        QList<UniqueValue*> uniqueValues;
+        QSet<QString> styleKeys;
 
-    featureAttributes.insert(propertiesMap);
+        for(auto&& attributes : featuresAttributes)
+        {
+            QStringList styleKey;
+            for(auto&& field : styleFields)
+                styleKey.append(attributes.value(field).toString());
 
-    QList<Field> tableFields;
-    tableFields.append(Field::createText("AssetType", "NULL",4));
-    tableFields.append(Field::createText("TabName", "NULL",4));
+            auto joinedKey = styleKey.join('\n');
 
-    // Use the property map from the first object to populate the fields.
-    auto keys = propertiesMap.keys();
-    for(auto&& it : keys)
-        tableFields.append(Field::createText(it, "NULL",4));
+            if(styleKeys.contains(joinedKey))
+                continue;
 
-    auto featureCollectionTable = new FeatureCollectionTable(tableFields, GeometryType::Polygon, SpatialReference::wgs84(),this);
+            styleKeys.insert(joinedKey);
 
-    // Try to get the color if there is one
-    auto colorStr =  properties["color"].toString();
+            auto legendLabel = attributes.value("value").toString();
 
-    // Black color by default
-    QColor featureColor = color;
+            if(legendLabel.isEmpty())
+                legendLabel = layerName;
 
-    if(!colorStr.isEmpty())
-        featureColor = QColor(colorStr);
+            auto weight = attributes.value("weight").toDouble();
 
-    auto legendLabel = layerName;
+            QVariantList values;
+            for(auto&& it : styleKey)
+                values.append(it);
 
-    QVariant valueVar = properties["value"].toVariant();
+            auto symbol = getSymbol(attributes.value("color").toString(), weight > 0.0 ? weight : 3.0);
 
-    if(!valueVar.toString().isEmpty())
-        legendLabel = valueVar.toString();
-    else if(properties["value"].toDouble(-1.0) == -1.0)
-        legendLabel = QString::number(valueVar.toDouble());
+            uniqueValues.append(new UniqueValue(legendLabel, QString(), values, symbol, this));
+        }
 
-    if(legendLabel.isEmpty())
-        legendLabel = layerName;
+        auto renderer = new UniqueValueRenderer(layerName, nullptr, styleFields, uniqueValues, this);
 
-    SimpleFillSymbol* lineSymbol = new SimpleFillSymbol(SimpleFillSymbolStyle::Solid, featureColor, this);
-    SimpleRenderer* lineRenderer = new SimpleRenderer(lineSymbol, this);
-    lineRenderer->setLabel(legendLabel);
+        featureCollectionTable->setRenderer(renderer);
+    }
 
-    featureCollectionTable->setRenderer(lineRenderer);
+    QList<Feature*> features;
+    features.reserve(featuresAttributes.size());
 
-    auto feature = featureCollectionTable->createFeature(featureAttributes, featGeom, this);
+    for(int i = 0; i<featuresAttributes.size(); ++i)
+        features.append(featureCollectionTable->createFeature(featuresAttributes.at(i), geometries.at(i), this));
 
-    featureCollectionTable->addFeature(feature);
+    // Add all of the features to the table at once
+    featureCollectionTable->addFeatures(features);
 
     return featureCollectionTable;
 }
@@ -38,13 +38,16 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 
 // Written by: Stevan Gavrilovic, Frank McKenna
 
+#include "AttributeIndex.h"
 #include "SimCenterAppWidget.h"
 #include "GISLegendView.h"
 
 #include "Error.h"
+#include "Geometry.h"
 
 #include <QMap>
 #include <QObject>
+#include <QPointer>
 #include <QUuid>
 
 namespace Esri
@@ -78,6 +81,7 @@ class RasterLayer;
 class ConvexHull;
 class PolygonBoundary;
 class ComponentInputWidget;
+struct GeoJsonFeature;
 class LayerTreeView;
 class LayerTreeItem;
 class SimCenterMapGraphicsView;
@@ -85,6 +89,8 @@ class TreeModel;
 
 class QGroupBox;
 class QComboBox;
+class QLabel;
+class QLineEdit;
 class QTreeView;
 class QSplitter;
 class QVBoxLayout;
@@ -178,8 +184,13 @@ public:
     Esri::ArcGISRuntime::Geometry getMultilineStringGeometryFromJson(const QJsonArray& geoJson);
     Esri::ArcGISRuntime::Geometry getMultiPolygonGeometryFromJson(const QJsonArray& geoJson);
 
-    Esri::ArcGISRuntime::FeatureCollectionTable* getMultilineFeatureTable(const QJsonObject& geomObject, const QJsonObject& featObj, const QString& layerName, const QColor color);
-    Esri::ArcGISRuntime::FeatureCollectionTable* getMultipolygonFeatureTable(const QJsonObject& geomObject, const QJsonObject& featObj, const QString& layerName, const QColor color);
+    // Returns a geometry from a feature read by the GeoJsonReader, with each line or ring as a part
+    Esri::ArcGISRuntime::Geometry getPolylineGeometryFromGeoJson(const GeoJsonFeature& feature);
+    Esri::ArcGISRuntime::Geometry getPolygonGeometryFromGeoJson(const GeoJsonFeature& feature);
+
+    // Creates one table for the geojson features that share a geometry type, i.e., MultiLineString or MultiPolygon, and a set of property names
+    // The features are styled by a unique value renderer on their color and value properties
+    Esri::ArcGISRuntime::FeatureCollectionTable* createJsonFeatureTable(const QString& geometryType, const QStringList& propertyNames, const QList<QMap<QString, QVariant>>& featuresAttributes, const QList<Esri::ArcGISRuntime::Geometry>& geometries, const QString& layerName, const QColor color);
 
     // Programatically set the visibility of a layer
     void setLayerVisibility(const QString& layerID, const bool val);
@@ -190,6 +201,20 @@ public:
     // Returns the tool to select a polygon boundary
     PolygonBoundary* getThePolygonBoundaryTool(void) const;
 
+    // Selects the features inside the geometry, for the selection tools. The layers of the components are searched with the spatial indexes
+    // of their databases when the selection is handled, and the other visible layers are queried asynchronously. taskSelectionComplete is
+    // emitted once all of the queries are done
+    void selectFeaturesInGeometry(const Esri::ArcGISRuntime::Geometry& geometry);
+
+    // Adds a search index of a field of the features in a layer for runFieldQuery, where values holds the value of the field of each feature
+    // The features that are nullptr are skipped, and the index is dropped when the layer is removed from the map
+    void addSearchIndex(Esri::ArcGISRuntime::Layer* layer, const QString& fieldName, const QStringList& values, const QList<Esri::ArcGISRuntime::Feature*>& features);
+
+    // Returns the features in the visible layers where the text in the field "fieldName" starts with the search text, ignoring case, up to maxResults
+    // The components and the layers with a search index of the field are searched in memory. The other layers are queried asynchronously,
+    // and their results go to fieldQueryCompleted, unless queryOtherLayers is false
+    QList<Esri::ArcGISRuntime::Feature*> runFieldQuery(const QString& fieldName, const QString& searchText, const int maxResults = 1000, const bool queryOtherLayers = true);
+
     // Get the list of features saved from the latest query
     QList<Esri::ArcGISRuntime::FeatureQueryResult *> getFeaturesFromQueryList() const;
 
@@ -225,6 +250,9 @@ private slots:
     void handleAsyncLayerLoad(Esri::ArcGISRuntime::Error layerLoadStatus);
     void handleBasemapSelection(const QString selection);
     void handleFieldQuerySelection(void);
+
+    // Highlights the features that match the text in the search box as it is typed
+    void handleSearchTextChanged(void);
     void handleArcGISError(Esri::ArcGISRuntime::Error error);
     void setLegendInfo();
 
@@ -245,9 +273,16 @@ private:
 
     QComboBox* baseMapCombo;
 
-    // This function runs a query on all features in a table
-    // It returns the all of the features in the table where the text in the field "FieldName" matches the search text
-    void runFieldQuery(const QString& fieldName, const QString& searchText);
+    // The search box, where the field to search is picked from the fields with a search index or typed in
+    QComboBox* searchFieldCombo = nullptr;
+    QLineEdit* searchLineEdit = nullptr;
+    QLabel* searchResultsLabel = nullptr;
+
+    // Adds the components inside the geometry to the selection of each component widget whose layer is visible
+    void selectComponentsInGeometry(const Esri::ArcGISRuntime::Geometry& geometry);
+
+    // The geometry of the latest selection with the selection tools
+    Esri::ArcGISRuntime::Geometry selectionGeometry;
 
     Esri::ArcGISRuntime::Map* mapGIS = nullptr;
     SimCenterMapGraphicsView *mapViewWidget = nullptr;
@@ -256,6 +291,17 @@ private:
     QList<Esri::ArcGISRuntime::FeatureQueryResult*>  featuresFromQueryList;
     QList<Esri::ArcGISRuntime::FeatureQueryResult*>  fieldQueryFeaturesList;
 
+    // A search index of a field of the features in a layer
+    struct LayerSearchIndex
+    {
+        QPointer<Esri::ArcGISRuntime::Layer> layer;
+        QString fieldName;
+        AttributeIndex index;
+        QList<Esri::ArcGISRuntime::Feature*> features;
+    };
+
+    std::vector<LayerSearchIndex> layerSearchIndexes;
+
     QMap<QUuid,QString> taskIDMap;
     QMap<QUuid,QString> layerLoadMap;
 
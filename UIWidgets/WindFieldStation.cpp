@@ -37,6 +37,7 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 // Written by: Stevan Gavrilovic
 
 #include "CSVReaderWriter.h"
+#include "CSVRowReader.h"
 #include "WindFieldStation.h"
 
 #include "Feature.h"
@@ -53,7 +54,7 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 
 WindFieldStation::WindFieldStation(QString name, double lat, double lon) : stationName(name), latitude(lat), longitude(lon)
 {
-    stationFeature = nullptr;
+
 }
 
 
@@ -71,50 +72,51 @@ double WindFieldStation::getLongitude() const
 
 void WindFieldStation::importWindFieldStation(void)
 {
-    CSVReaderWriter csvTool;
-
-    QString err;
-    QVector<QStringList> data = csvTool.parseCSVFile(stationFilePath,err);
+    peakWindSpeeds.clear();
+    peakInundationHeights.clear();
 
-    // Return if there is an error or the data is empty
-    if(!err.isEmpty())
-        throw err;
+    int numCols = 0;
+    int indexPWS = -1;
+    int indexPIH = -1;
 
-    if(data.size() < 2)
-        throw "The file " + stationFilePath + " is empty";
+    // Stream the station file a row at a time, the columns are resolved from the header before the first row
+    auto visitor = [&](const CSVRowReader& row)
+    {
+        if(indexPWS == -1)
+        {
+            QStringList tableHeadings = row.getHeader();
 
-    // Get the header file
-    QStringList tableHeadings = data.first();
+            numCols = tableHeadings.size();
 
-    // Pop off the row that contains the header information
-    data.pop_front();
+            indexPWS = tableHeadings.indexOf("PWS");
 
-    auto numRows = data.size();
-    auto numCols = tableHeadings.size();
+            if(indexPWS == -1)
+                throw QString("Could not find the peak wind speed (PWS) header");
 
-    auto indexPWS = tableHeadings.indexOf("PWS");
+            indexPIH = tableHeadings.indexOf("PIH");
+        }
 
-    if(indexPWS == -1)
-        throw "Could not find the peak wind speed (PWS) header";
+        if(row.columnCount() != numCols)
+            throw "The number of columns in the row " + QString::number(row.getRowNumber()-1) + " should be " + QString::number(numCols);
 
-    auto indexPIH = tableHeadings.indexOf("PIH");
+        peakWindSpeeds.push_back(this->objectToDouble(row.at(indexPWS)));
 
-    peakWindSpeeds.resize(numRows);
-    peakInundationHeights.resize(numRows);
+        if(indexPIH != -1)
+            peakInundationHeights.push_back(this->objectToDouble(row.at(indexPIH)));
+        else
+            peakInundationHeights.push_back(0.0);
 
-    // Get the data
-    for(int i = 0; i<numRows; ++i)
-    {
-        auto rowStringList = data[i];
+        return true;
+    };
 
-        if(rowStringList.size() != numCols)
-            throw "The number of columns in the row " + QString::number(i) + " should be " + QString::number(numCols);
+    CSVReaderWriter csvTool;
 
-        peakWindSpeeds[i] = this->objectToDouble(rowStringList[indexPWS]);
+    QString err;
+    if(csvTool.forEachRow(stationFilePath, visitor, err) != 0)
+        throw err;
 
-        if(indexPIH != -1)
-            peakInundationHeights[i] = this->objectToDouble(rowStringList[indexPIH]);
-    }
+    if(peakWindSpeeds.empty())
+        throw "The file " + stationFilePath + " is empty";
 }
 
 QVector<double> WindFieldStation::getPeakWindSpeeds() const
@@ -124,12 +126,24 @@ QVector<double> WindFieldStation::getPeakWindSpeeds() const
 
 Esri::ArcGISRuntime::Feature *WindFieldStation::getStationFeature() const
 {
-    return stationFeature;
+    if(stationFeatures.isEmpty())
+        return nullptr;
+
+    return stationFeatures.back();
 }
 
 void WindFieldStation::setStationFeature(Esri::ArcGISRuntime::Feature *value)
 {
-    stationFeature = value;
+    stationFeatures.clear();
+
+    if(value != nullptr)
+        stationFeatures.append(value);
+}
+
+void WindFieldStation::addStationFeature(Esri::ArcGISRuntime::Feature *value)
+{
+    if(value != nullptr)
+        stationFeatures.append(value);
 }
 
 void WindFieldStation::setStationFilePath(const QString &value)
@@ -145,8 +159,15 @@ QString WindFieldStation::getStationFilePath() const
 
 int WindFieldStation::updateFeatureAttribute(const QString& attribute, const QVariant& value)
 {
-    stationFeature->attributes()->replaceAttribute(attribute,value);
-    stationFeature->featureTable()->updateFeature(stationFeature);
+    // A station that is not drawn has no feature to update
+    if(stationFeatures.isEmpty())
+        return -1;
+
+    for(auto&& feature : stationFeatures)
+    {
+        feature->attributes()->replaceAttribute(attribute,value);
+        feature->featureTable()->updateFeature(feature);
+    }
 
     return 0;
 }
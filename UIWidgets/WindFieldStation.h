@@ -38,6 +38,7 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 
 // Written by: Stevan Gavrilovic
 
+#include <QList>
 #include <QVector>
 #include <QVariant>
 
@@ -85,9 +86,13 @@ public:
 
     QVector<double> getPeakWindSpeeds() const;
 
+    // The feature of the station in the finest level of detail that it is drawn in, or a null pointer if it is not drawn
     Esri::ArcGISRuntime::Feature *getStationFeature() const;
     void setStationFeature(Esri::ArcGISRuntime::Feature *value);
 
+    // Adds a feature for a coarser or finer level of detail that the station is also drawn in, from the coarsest to the finest
+    void addStationFeature(Esri::ArcGISRuntime::Feature *value);
+
     int updateFeatureAttribute(const QString& attribute, const QVariant& value);
 
     QVector<double> getPeakInundationHeights() const;
@@ -105,7 +110,8 @@ private:
     QVector<double> peakWindSpeeds;
     QVector<double> peakInundationHeights;
 
-    Esri::ArcGISRuntime::Feature* stationFeature;
+    // A station can be drawn in more than one level of detail, e.g., of a PointPyramid, and has a feature in each
+    QList<Esri::ArcGISRuntime::Feature*> stationFeatures;
 
 };
 
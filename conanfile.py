@@ -11,6 +11,7 @@ class quoFEM(ConanFile):
     generators = "qmake"
     requires = "jansson/2.13.1", \
                "zlib/1.2.11", \
+               "zstd/1.4.9", \
                "libcurl/7.64.1"
     build_policy = "missing"
 